@@ -6,7 +6,7 @@
 
 QT       += core gui
 
-CONFIG += debug
+CONFIG += debug c++17
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 TARGET = TicTacToe
@@ -18,6 +18,17 @@ TEMPLATE = app
 # deprecated API in order to know how to port your code away from it.
 DEFINES += QT_DEPRECATED_WARNINGS
 
+# Hot-path latency histograms and counters, dumped to metrics.prom in the
+# Prometheus text format every 10 seconds.
+#DEFINES += ENABLE_METRICS
+
+# Begin/end events of startup and training written to trace.json in the
+# Chrome Trace Event format.
+#DEFINES += ENABLE_TRACING
+
+# shm_open() for the shared policy segment.
+unix: LIBS += -lrt
+
 # You can also make your code fail to compile if you use deprecated APIs.
 # In order to do so, uncomment the following line.
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
@@ -29,26 +40,78 @@ RCC_DIR = .moc
 UI_DIR = .ui
 
 SOURCES += \
+        src/anytime_search.cpp \
+        src/board_widget.cpp \
+        src/frozen_bot.cpp \
         src/game.cpp \
+        src/game_archive.cpp \
         src/game_bot.cpp \
-        src/game_cell.cpp \
         src/game_widget.cpp \
         src/grid.cpp \
+        src/grid_symmetry.cpp \
+        src/lazy_policy_store.cpp \
+        src/lazy_smp_search.cpp \
         src/main.cpp \
         src/mainwindow.cpp \
         src/match_box.cpp \
-        src/statistics.cpp
+        src/match_box_history.cpp \
+        src/metrics.cpp \
+        src/mcts_bot.cpp \
+        src/move_ordering.cpp \
+        src/ntuple_network.cpp \
+        src/policy_snapshot.cpp \
+        src/ponderer.cpp \
+        src/qubic_board.cpp \
+        src/qubic_symmetry.cpp \
+        src/seed_delta_buffer.cpp \
+        src/shared_policy_segment.cpp \
+        src/sparse_board.cpp \
+        src/statistics.cpp \
+        src/tablebase.cpp \
+        src/task_scheduler.cpp \
+        src/tournament.cpp \
+        src/trace.cpp \
+        src/transposition_table.cpp \
+        src/ultimate_board.cpp
 
 HEADERS += \
+        include/anytime_search.h \
+        include/board_widget.h \
         include/constants.h \
+        include/frozen_bot.h \
+        include/frozen_policy.h \
         include/game.h \
+        include/game_archive.h \
         include/game_bot.h \
-        include/game_cell.h \
         include/game_widget.h \
         include/grid.h \
+        include/grid_symmetry.h \
+        include/lazy_policy_store.h \
+        include/lazy_smp_search.h \
         include/mainwindow.h \
         include/match_box.h \
-        include/statistics.h
+        include/match_box_history.h \
+        include/metrics.h \
+        include/mcts_bot.h \
+        include/move_ordering.h \
+        include/ntuple_network.h \
+        include/policy_snapshot.h \
+        include/ponderer.h \
+        include/qubic_board.h \
+        include/qubic_symmetry.h \
+        include/search_adapters.h \
+        include/seed_delta_buffer.h \
+        include/shared_policy_segment.h \
+        include/sparse_board.h \
+        include/sparse_cell_table.h \
+        include/statistics.h \
+        include/tablebase.h \
+        include/task_scheduler.h \
+        include/tournament.h \
+        include/trace.h \
+        include/transposition_table.h \
+        include/ultimate_board.h \
+        include/work_stealing_deque.h
 
 INCLUDEPATH = include \
     MOC_DIR \
@@ -0,0 +1,67 @@
+#ifndef ANYTIME_SEARCH_H
+#define ANYTIME_SEARCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+#include "constants.h"
+#include "grid.h"
+#include "ultimate_board.h"
+
+#define SEARCH_WIN_SCORE (1000)
+#define SEARCH_INFINITY (1000000)
+// Heuristic scores are clamped to +/- this, well below SEARCH_WIN_SCORE, so
+// that an evaluation never looks like a win.
+#define SEARCH_MAX_HEURISTIC_SCORE (SEARCH_WIN_SCORE / 2)
+#define SEARCH_DEADLINE_CHECK_INTERVAL (1024)
+
+struct SearchStatistics {
+    uint64_t nodes_searched;
+    size_t depth_reached;
+    bool solved;
+};
+
+// Iterative deepening negamax with alpha-beta pruning. search() always
+// returns the best move of the deepest fully searched iteration, so it can
+// be stopped at any time once depth 1 is done. The same search runs on a
+// Grid and on an UltimateBoard. Grid leaves are scored by evaluate() unless
+// a leaf evaluator is set, which then sees the grid and the player to move.
+// A stop flag, when set, is polled with the deadline and ends the search
+// early the same way the deadline does.
+class AnytimeSearch
+{
+public:
+    static int32_t evaluate(const Grid & grid, Move player);
+    static int32_t evaluate(const UltimateBoard & board, Move player);
+    static int32_t clamp_heuristic_score(int32_t score);
+
+    typedef std::function<int32_t(const Grid & grid, Move player)> LeafEvaluator;
+
+    AnytimeSearch();
+    void set_leaf_evaluator(LeafEvaluator leaf_evaluator);
+    void set_stop_flag(const std::atomic<bool> * stop_flag);
+    bool search(const Grid & grid, std::chrono::microseconds search_budget, MovePosition & best_position);
+    bool search(const UltimateBoard & board, std::chrono::microseconds search_budget, UltimateMove & best_move);
+    SearchStatistics get_statistics() const;
+private:
+    template <typename Board, typename Position>
+    bool _search(const Board & board, std::chrono::microseconds search_budget, size_t max_rank, Position no_position, Position & best_position);
+    template <typename Board, typename Position>
+    int32_t _search_root(Board & board, Move player, size_t depth, Position no_position, Position previous_best_position, Position & best_position);
+    template <typename Board, typename Position>
+    int32_t _negamax(Board & board, Move player, size_t depth, size_t ply, int32_t alpha, int32_t beta, Position no_position);
+    int32_t _evaluate(const Grid & grid, Move player) const;
+    int32_t _evaluate(const UltimateBoard & board, Move player) const;
+    bool _deadline_reached();
+    bool _should_stop();
+
+    std::chrono::steady_clock::time_point _deadline;
+    bool _aborted;
+    SearchStatistics _statistics;
+    LeafEvaluator _leaf_evaluator;
+    const std::atomic<bool> * _stop_flag;
+};
+
+#endif // ANYTIME_SEARCH_H
@@ -0,0 +1,63 @@
+#ifndef BOARD_WIDGET_H
+#define BOARD_WIDGET_H
+
+#include <cstdint>
+#include <vector>
+
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QPoint>
+#include <QRect>
+#include <QResizeEvent>
+#include <QSize>
+#include <QWidget>
+
+#include "constants.h"
+
+// Preferred edge of the whole board; cells shrink as the board grows.
+#define BOARD_SIZE_HINT (600)
+#define BOARD_MIN_CELL_SIZE (16)
+
+// Board of any size drawn by a single paintEvent() instead of one widget
+// per cell. Cells are square and the board is centred in the widget.
+// set_cell() and set_winning_cells() only schedule repaints of the cells
+// they change, and paintEvent() only draws the cells that overlap the
+// rectangle Qt asks for. Clicks are mapped back to cells by arithmetic.
+class BoardWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit BoardWidget(int8_t num_rows = NUM_ROWS, int8_t num_cols = NUM_COLS, QWidget * parent = nullptr);
+    void set_board_size(int8_t num_rows, int8_t num_cols);
+    int8_t num_rows() const;
+    int8_t num_cols() const;
+    void clear();
+    Move cell(int8_t row_index, int8_t col_index) const;
+    void set_cell(int8_t row_index, int8_t col_index, Move move);
+    void set_winning_cells(const std::vector<MovePosition> & winning_cells);
+    virtual QSize sizeHint() const override;
+    virtual QSize minimumSizeHint() const override;
+signals:
+    void cell_clicked(int8_t row_index, int8_t col_index);
+protected:
+    virtual void paintEvent(QPaintEvent * event) override;
+    virtual void mouseReleaseEvent(QMouseEvent * event) override;
+    virtual void resizeEvent(QResizeEvent * event) override;
+private:
+    void _update_geometry();
+    void _paint_cell(QPainter & painter, int8_t row_index, int8_t col_index) const;
+    QRect _cell_rect(int8_t row_index, int8_t col_index) const;
+    bool _cell_at(const QPoint & point, int8_t & row_index, int8_t & col_index) const;
+    size_t _cell_index(int8_t row_index, int8_t col_index) const;
+
+    int8_t _num_rows;
+    int8_t _num_cols;
+    std::vector<Move> _cells;
+    std::vector<bool> _winning_cells;
+    std::vector<MovePosition> _winning_positions;
+    int _cell_size;
+    QPoint _origin;
+};
+
+#endif // BOARD_WIDGET_H
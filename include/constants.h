@@ -78,9 +78,34 @@ enum class GameOutcome {
 
 typedef std::pair<size_t, size_t> MovePosition;
 
-#define FIRST_PLAYER_MOVE (Move::CROSS)
-#define PLAYER_MOVE (Move::NOUGHT)
-#define BOT_MOVE (Move::CROSS)
-#define PLAY_BOT (true)
+#define OPPONENT_MOVE(m) (\
+    m == Move::CROSS ? Move::NOUGHT :\
+    m == Move::NOUGHT ? Move::CROSS :\
+    Move::EMPTY)
+
+// Side that moves first on a new Grid. Match boxes and tablebases are
+// built for games started by this side; games started by the other side
+// are looked up with the symbols swapped.
+#define DEFAULT_FIRST_PLAYER_MOVE (Move::CROSS)
+
+// Sides of one game, chosen at runtime per Game.
+struct PlayerRoles {
+    Move first_player_move;
+    Move player_move;
+    Move bot_move;
+    bool play_bot;
+};
+
+#define DEFAULT_PLAYER_ROLES (PlayerRoles{DEFAULT_FIRST_PLAYER_MOVE, Move::NOUGHT, Move::CROSS, true})
+
+// Compile-time facts about one side, for code specialised on the side to
+// move.
+template <Move Side>
+struct MoveSide {
+    static_assert(Side == Move::NOUGHT || Side == Move::CROSS, "MoveSide needs NOUGHT or CROSS");
+    static constexpr Move OPPONENT = Side == Move::CROSS ? Move::NOUGHT : Move::CROSS;
+    static constexpr GameState WINS = Side == Move::CROSS ? GameState::CROSS_WINS : GameState::NOUGHT_WINS;
+    static constexpr GameState LOSES = Side == Move::CROSS ? GameState::NOUGHT_WINS : GameState::CROSS_WINS;
+};
 
 #endif // CONSTANTS_H
@@ -0,0 +1,27 @@
+#ifndef FROZEN_BOT_H
+#define FROZEN_BOT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "constants.h"
+#include "grid.h"
+#include "grid_symmetry.h"
+
+// Trained policy compiled in from frozen_policy.h, which
+// GameBot::export_policy_header() generates (see tools/policy_exporter).
+// Positions are looked up by canonical_grid_index(), so there is no file
+// I/O, no state enumeration and no heap allocation.
+class FrozenBot
+{
+public:
+    FrozenBot() = default;
+    bool get_next_move(const Grid & grid, MovePosition & position) const;
+    bool get_next_move(const Grid & grid, uint32_t random_number, MovePosition & position) const;
+    size_t num_positions() const;
+    uint64_t version() const;
+private:
+    static bool _find_position(const Grid & grid, size_t & position_index, GridTransformation & grid_transformation);
+};
+
+#endif // FROZEN_BOT_H
@@ -0,0 +1,743 @@
+// Generated by GameBot::export_policy_header(). Do not edit.
+#ifndef FROZEN_POLICY_H
+#define FROZEN_POLICY_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define FROZEN_POLICY_NUM_ROWS (3)
+#define FROZEN_POLICY_NUM_COLS (3)
+#define FROZEN_POLICY_NUM_POSITIONS (627)
+#define FROZEN_POLICY_VERSION (0)
+#define FROZEN_POLICY_HAS_SEEDS (1)
+
+constexpr uint32_t FROZEN_POLICY_KEYS[FROZEN_POLICY_NUM_POSITIONS] = {
+    0, 2, 5, 6, 7, 11, 17, 23, 33, 35, 44, 45,
+    47, 50, 51, 52, 61, 63, 65, 68, 69, 70, 73, 75,
+    76, 83, 87, 89, 98, 101, 104, 116, 128, 132, 141, 142,
+    146, 150, 152, 153, 154, 156, 158, 160, 162, 163, 165, 167,
+    169, 173, 176, 178, 194, 195, 196, 200, 204, 206, 207, 208,
+    210, 212, 214, 225, 226, 228, 230, 232, 238, 278, 290, 297,
+    299, 302, 303, 304, 308, 312, 314, 315, 316, 318, 320, 322,
+    380, 384, 386, 395, 396, 398, 401, 402, 403, 434, 438, 440,
+    449, 452, 455, 459, 460, 462, 464, 466, 468, 470, 473, 474,
+    475, 478, 480, 481, 541, 543, 544, 550, 554, 556, 621, 622,
+    624, 626, 628, 632, 635, 637, 746, 747, 749, 752, 753, 754,
+    776, 780, 798, 800, 801, 802, 804, 806, 808, 830, 834, 882,
+    884, 887, 888, 889, 902, 906, 908, 909, 910, 912, 914, 916,
+    935, 936, 938, 941, 942, 960, 961, 964, 966, 967, 980, 992,
+    996, 1028, 1032, 1034, 1043, 1044, 1046, 1049, 1050, 1051, 1115, 1127,
+    1131, 1136, 1140, 1142, 1151, 1154, 1157, 1158, 1159, 1169, 1181, 1185,
+    1190, 1193, 1194, 1195, 1199, 1203, 1205, 1206, 1207, 1209, 1211, 1213,
+    1217, 1220, 1221, 1222, 1226, 1230, 1232, 1234, 1238, 1240, 1244, 1248,
+    1250, 1259, 1260, 1262, 1265, 1266, 1270, 1272, 1274, 1276, 1278, 1280,
+    1283, 1284, 1285, 1288, 1290, 1291, 1298, 1302, 1304, 1316, 1319, 1320,
+    1321, 1331, 1343, 1347, 1352, 1355, 1356, 1357, 1368, 1369, 1371, 1373,
+    1375, 1378, 1382, 1384, 1388, 1391, 1392, 1393, 1396, 1399, 1406, 1409,
+    1410, 1415, 1419, 1421, 1422, 1425, 1427, 1477, 1479, 1480, 1506, 1508,
+    1510, 1557, 1558, 1560, 1562, 1564, 1589, 1590, 1591, 1703, 1706, 1707,
+    1708, 1712, 1716, 1718, 1720, 1722, 1724, 1726, 1730, 1734, 1736, 1745,
+    1746, 1748, 1751, 1752, 1753, 1758, 1762, 1770, 1771, 1774, 1776, 1777,
+    1784, 1788, 1790, 1799, 1802, 1805, 1806, 1807, 1842, 1843, 1851, 1854,
+    1855, 1857, 1861, 1866, 1868, 1870, 1874, 1877, 1878, 1879, 1892, 1895,
+    1896, 1897, 1901, 1905, 1907, 1920, 1921, 1927, 1929, 1933, 1948, 1954,
+    1958, 1960, 1966, 1974, 1976, 1978, 1982, 1985, 1986, 1987, 1990, 1992,
+    1993, 2002, 2008, 2010, 2030, 2032, 2036, 2039, 2040, 2041, 2044, 2047,
+    2054, 2057, 2058, 2059, 2063, 2067, 2069, 2071, 2073, 2075, 2077, 2082,
+    2083, 2089, 2091, 2095, 2101, 2110, 2116, 2136, 2137, 2143, 2145, 2147,
+    2149, 2490, 2492, 2501, 2504, 2507, 2508, 2509, 2573, 2585, 2589, 2627,
+    2639, 2652, 2653, 2657, 2661, 2663, 2665, 2667, 2669, 2671, 2730, 2732,
+    2734, 2738, 2741, 2743, 2814, 2815, 2819, 2825, 3233, 3237, 3341, 3392,
+    3395, 3398, 3399, 3400, 3410, 3419, 3422, 3425, 3427, 3437, 3449, 3453,
+    3461, 3462, 3463, 3467, 3471, 3473, 3475, 3477, 3479, 3481, 3491, 3503,
+    3543, 3545, 3557, 3561, 3562, 3569, 3571, 3575, 3581, 3583, 3587, 3589,
+    3597, 3599, 3608, 3611, 3614, 3615, 3908, 3911, 3913, 3939, 3967, 3989,
+    4047, 4048, 4136, 4138, 4142, 4145, 4147, 4150, 4153, 4163, 4164, 4165,
+    4169, 4173, 4175, 4177, 4181, 4183, 4195, 4201, 4207, 4219, 4223, 4229,
+    4231, 4237, 4245, 4247, 4256, 4259, 4263, 4264, 4273, 4281, 4282, 4285,
+    4303, 4307, 4309, 4325, 4327, 4331, 4334, 4335, 4336, 4924, 5005, 5009,
+    5011, 5600, 5603, 5605, 5608, 5611, 5633, 5639, 5659, 5665, 5689, 5693,
+    5695, 5717, 5720, 5743, 5746, 5761, 5765, 5773, 5792, 6367, 6421, 6448,
+    7310, 7361, 7364, 7367, 7369, 7445, 7469, 7472, 7475, 7499, 7523, 7525,
+    7529, 7531, 7607, 7769, 7772, 7774, 7841, 7847, 7853, 7931, 7934, 8038,
+    8042, 8044, 8069, 8071, 8120, 8123, 8282, 8285, 8287, 8309, 8335, 8341,
+    8363, 8516, 8519, 8521, 8543, 8549, 8555, 8557, 8575, 8581, 8597, 8603,
+    8609, 8630, 8633, 8636, 8681, 8683, 8705, 8708, 8710, 10469, 10528, 10709,
+    10715, 10736, 10739, 10742, 10744, 10762, 10768, 10790, 10793, 10820, 10868, 12220,
+    14711, 14873, 17060,
+};
+
+constexpr uint8_t FROZEN_POLICY_MOVES[FROZEN_POLICY_NUM_POSITIONS] = {
+    0, 1, 2, 0, 2, 3, 4, 4, 0, 2, 4, 0, 1, 4, 0, 6,
+    2, 0, 1, 4, 0, 4, 4, 4, 4, 1, 0, 2, 5, 1, 7, 2,
+    1, 0, 0, 8, 6, 6, 6, 0, 8, 7, 7, 5, 0, 1, 0, 3,
+    7, 8, 3, 5, 2, 7, 6, 1, 7, 7, 6, 6, 0, 6, 6, 5,
+    5, 0, 5, 7, 6, 2, 1, 0, 6, 4, 0, 2, 6, 8, 6, 0,
+    1, 6, 6, 4, 1, 0, 2, 6, 0, 6, 6, 0, 8, 2, 7, 2,
+    7, 1, 8, 0, 1, 0, 6, 7, 8, 8, 6, 8, 7, 6, 6, 6,
+    4, 4, 2, 4, 4, 4, 6, 8, 7, 6, 2, 6, 6, 8, 4, 0,
+    1, 4, 0, 3, 1, 0, 4, 4, 0, 4, 4, 4, 4, 1, 5, 0,
+    1, 7, 0, 8, 7, 0, 3, 0, 3, 3, 8, 3, 5, 0, 1, 5,
+    0, 0, 5, 5, 5, 5, 2, 1, 0, 2, 2, 2, 4, 0, 1, 4,
+    0, 4, 2, 1, 0, 1, 0, 2, 7, 8, 8, 0, 7, 2, 1, 0,
+    8, 2, 7, 2, 8, 7, 8, 0, 1, 0, 8, 7, 8, 4, 0, 2,
+    4, 4, 4, 3, 8, 3, 8, 0, 2, 4, 0, 1, 8, 0, 8, 4,
+    4, 4, 4, 4, 4, 4, 4, 1, 4, 4, 2, 2, 2, 1, 8, 0,
+    8, 2, 1, 8, 7, 2, 0, 8, 8, 8, 7, 7, 8, 3, 2, 3,
+    1, 7, 0, 3, 3, 3, 8, 8, 0, 7, 0, 7, 0, 8, 8, 4,
+    4, 4, 5, 4, 4, 1, 8, 7, 3, 3, 5, 0, 5, 1, 2, 4,
+    4, 3, 8, 3, 4, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 8, 8, 8, 4, 0, 7, 3, 3, 3, 3, 3, 3, 3, 3,
+    0, 8, 0, 0, 8, 0, 8, 0, 2, 2, 8, 3, 8, 7, 1, 2,
+    0, 2, 8, 7, 8, 0, 2, 1, 0, 8, 2, 1, 3, 4, 3, 2,
+    4, 2, 4, 7, 4, 4, 1, 8, 4, 2, 1, 0, 7, 8, 3, 3,
+    0, 8, 8, 8, 1, 7, 2, 8, 1, 0, 7, 8, 8, 7, 8, 0,
+    2, 1, 0, 7, 7, 2, 1, 2, 2, 1, 0, 8, 7, 0, 2, 6,
+    1, 4, 0, 4, 8, 1, 0, 2, 1, 8, 2, 6, 8, 8, 6, 8,
+    6, 6, 4, 4, 4, 1, 6, 4, 6, 8, 6, 6, 1, 0, 8, 8,
+    8, 8, 8, 8, 2, 4, 8, 8, 8, 8, 8, 8, 4, 8, 4, 4,
+    4, 8, 4, 4, 4, 8, 2, 8, 0, 2, 1, 8, 8, 3, 3, 3,
+    8, 3, 8, 8, 0, 8, 8, 8, 8, 0, 1, 3, 4, 0, 4, 3,
+    0, 8, 4, 2, 3, 3, 3, 1, 4, 4, 2, 2, 1, 0, 4, 1,
+    4, 4, 4, 4, 4, 8, 3, 3, 8, 8, 2, 2, 8, 1, 0, 8,
+    8, 0, 8, 1, 3, 3, 3, 2, 2, 8, 8, 0, 8, 1, 1, 6,
+    6, 4, 4, 4, 3, 3, 4, 8, 4, 4, 8, 8, 3, 1, 8, 8,
+    8, 3, 3, 3, 8, 4, 8, 8, 1, 4, 7, 7, 4, 1, 7, 7,
+    7, 1, 5, 5, 7, 7, 1, 7, 7, 7, 4, 4, 7, 7, 7, 4,
+    3, 4, 4, 4, 1, 3, 1, 3, 4, 1, 4, 4, 1, 3, 3, 4,
+    1, 4, 4, 4, 4, 4, 3, 3, 7, 7, 1, 7, 3, 3, 1, 7,
+    7, 1, 4, 3, 4, 4, 1, 4, 4, 4, 4, 3, 1, 1, 3, 4,
+    7, 4, 4,
+};
+
+constexpr int8_t FROZEN_POLICY_SEEDS[FROZEN_POLICY_NUM_POSITIONS][FROZEN_POLICY_NUM_ROWS * FROZEN_POLICY_NUM_COLS] = {
+    {127, 127, 126, 127, 127, 126, 127, 127, 127},
+    {0, 127, 125, 126, 126, 125, 124, 127, 127},
+    {0, 0, 127, 127, 127, 127, 127, 127, 127},
+    {127, 0, 126, 127, 127, 127, 126, 126, 126},
+    {0, 0, 127, 127, 127, 127, 127, 1, 127},
+    {0, 126, 0, 127, 126, 127, 127, 127, 127},
+    {0, 0, 0, 126, 127, 127, 1, 127, 127},
+    {0, 0, 0, 10, 127, 1, 127, 1, 127},
+    {127, 0, 1, 0, 127, 127, 127, 1, 127},
+    {0, 0, 127, 0, 2, 1, 1, 1, 1},
+    {0, 0, 0, 0, 127, 127, 127, 1, 1},
+    {127, 1, 0, 0, 127, 127, 127, 127, 127},
+    {0, 126, 0, 0, 1, 1, 1, 1, 1},
+    {0, 0, 0, 0, 127, 127, 2, 127, 127},
+    {127, 0, 0, 0, 1, 1, 2, 1, 1},
+    {0, 0, 0, 0, 1, 1, 4, 1, 1},
+    {0, 0, 127, 0, 127, 127, 31, 127, 1},
+    {127, 125, 0, 0, 127, 1, 126, 1, 127},
+    {0, 1, 0, 0, 1, 1, 1, 1, 1},
+    {0, 0, 0, 0, 127, 127, 127, 127, 127},
+    {127, 0, 0, 0, 127, 119, 1, 127, 127},
+    {0, 0, 0, 0, 127, 23, 107, 4, 127},
+    {0, 1, 0, 0, 127, 127, 127, 2, 3},
+    {1, 0, 0, 0, 127, 6, 127, 1, 1},
+    {0, 0, 0, 0, 127, 49, 18, 35, 92},
+    {0, 127, 127, 127, 0, 127, 127, 127, 127},
+    {127, 0, 127, 127, 0, 127, 127, 1, 127},
+    {0, 0, 127, 1, 0, 1, 1, 1, 1},
+    {0, 0, 0, 1, 0, 127, 127, 1, 1},
+    {0, 127, 0, 1, 0, 1, 4, 1, 1},
+    {0, 0, 0, 2, 0, 1, 1, 127, 1},
+    {0, 0, 127, 0, 0, 37, 2, 1, 2},
+    {0, 127, 0, 0, 0, 127, 1, 2, 1},
+    {127, 0, 0, 0, 0, 86, 1, 4, 9},
+    {127, 0, 127, 0, 0, 1, 127, 1, 1},
+    {0, 0, 8, 0, 0, 2, 9, 1, 127},
+    {0, 1, 0, 0, 0, 1, 127, 1, 1},
+    {1, 0, 0, 0, 0, 1, 126, 1, 1},
+    {0, 0, 0, 0, 0, 1, 127, 1, 8},
+    {127, 127, 0, 0, 0, 127, 126, 126, 5},
+    {0, 17, 0, 0, 0, 1, 3, 4, 127},
+    {2, 0, 0, 0, 0, 1, 1, 127, 1},
+    {0, 0, 0, 0, 0, 11, 45, 127, 2},
+    {0, 0, 0, 0, 0, 127, 127, 127, 127},
+    {127, 105, 126, 127, 0, 122, 127, 124, 127},
+    {0, 127, 127, 127, 0, 127, 127, 126, 127},
+    {127, 0, 127, 127, 0, 127, 127, 127, 127},
+    {0, 0, 1, 127, 0, 1, 1, 1, 6},
+    {0, 0, 1, 1, 0, 1, 4, 127, 1},
+    {0, 2, 0, 2, 0, 1, 1, 1, 127},
+    {0, 0, 0, 127, 0, 127, 32, 19, 127},
+    {0, 0, 0, 39, 0, 123, 13, 122, 74},
+    {0, 0, 127, 0, 0, 127, 127, 127, 127},
+    {1, 0, 1, 0, 0, 1, 1, 126, 1},
+    {0, 0, 5, 0, 0, 14, 127, 127, 2},
+    {0, 127, 0, 0, 0, 93, 17, 127, 127},
+    {36, 0, 0, 0, 0, 16, 54, 127, 127},
+    {0, 0, 0, 0, 0, 1, 1, 123, 13},
+    {1, 2, 0, 0, 0, 1, 123, 1, 1},
+    {0, 1, 0, 0, 0, 3, 127, 1, 1},
+    {127, 0, 0, 0, 0, 78, 127, 119, 127},
+    {0, 0, 0, 0, 0, 1, 126, 1, 1},
+    {0, 0, 0, 0, 0, 1, 127, 1, 1},
+    {1, 1, 0, 0, 0, 127, 1, 1, 1},
+    {0, 123, 0, 0, 0, 127, 2, 4, 1},
+    {127, 0, 0, 0, 0, 127, 7, 1, 3},
+    {0, 0, 0, 0, 0, 1, 1, 1, 1},
+    {0, 0, 0, 0, 0, 1, 1, 85, 1},
+    {0, 0, 0, 0, 0, 1, 2, 1, 1},
+    {0, 0, 127, 0, 127, 0, 3, 3, 20},
+    {0, 127, 0, 0, 127, 0, 8, 4, 3},
+    {127, 127, 127, 0, 127, 0, 127, 127, 127},
+    {0, 5, 1, 0, 1, 0, 127, 1, 1},
+    {0, 0, 87, 0, 127, 0, 127, 33, 127},
+    {127, 0, 8, 0, 1, 0, 127, 2, 1},
+    {0, 0, 127, 0, 127, 0, 2, 127, 127},
+    {0, 1, 0, 0, 1, 0, 127, 1, 127},
+    {1, 0, 0, 0, 1, 0, 1, 1, 127},
+    {0, 0, 0, 0, 2, 0, 127, 1, 127},
+    {127, 1, 0, 0, 127, 0, 127, 1, 1},
+    {0, 127, 0, 0, 127, 0, 127, 127, 127},
+    {51, 0, 0, 0, 18, 0, 127, 73, 32},
+    {0, 0, 0, 0, 2, 0, 127, 1, 1},
+    {0, 0, 0, 0, 127, 0, 127, 127, 1},
+    {0, 127, 127, 0, 0, 0, 107, 11, 18},
+    {127, 0, 20, 0, 0, 0, 27, 3, 25},
+    {0, 0, 1, 0, 0, 0, 1, 1, 1},
+    {0, 0, 0, 0, 0, 0, 127, 2, 1},
+    {127, 127, 0, 0, 0, 0, 127, 127, 127},
+    {0, 1, 0, 0, 0, 0, 11, 1, 1},
+    {0, 0, 0, 0, 0, 0, 127, 57, 1},
+    {127, 0, 0, 0, 0, 0, 10, 9, 1},
+    {0, 0, 0, 0, 0, 0, 2, 1, 127},
+    {0, 97, 127, 0, 0, 0, 127, 127, 29},
+    {97, 0, 41, 0, 0, 0, 115, 127, 127},
+    {0, 0, 1, 0, 0, 0, 1, 1, 1},
+    {0, 0, 0, 0, 0, 0, 1, 127, 127},
+    {0, 1, 0, 0, 0, 0, 1, 1, 1},
+    {0, 0, 0, 0, 0, 0, 68, 23, 127},
+    {127, 8, 127, 0, 0, 0, 127, 28, 127},
+    {0, 127, 127, 0, 0, 0, 3, 127, 127},
+    {127, 0, 127, 0, 0, 0, 127, 2, 127},
+    {0, 0, 1, 0, 0, 0, 127, 1, 1},
+    {0, 0, 1, 0, 0, 0, 2, 127, 1},
+    {1, 34, 0, 0, 0, 0, 1, 1, 127},
+    {0, 1, 0, 0, 0, 0, 1, 2, 127},
+    {0, 0, 0, 0, 0, 0, 127, 3, 127},
+    {2, 0, 0, 0, 0, 0, 1, 126, 127},
+    {0, 0, 0, 0, 0, 0, 2, 127, 49},
+    {0, 1, 0, 0, 0, 0, 127, 1, 1},
+    {1, 0, 0, 0, 0, 0, 127, 1, 2},
+    {0, 0, 0, 0, 0, 0, 127, 31, 27},
+    {0, 1, 1, 0, 127, 0, 1, 1, 5},
+    {1, 0, 4, 0, 127, 0, 1, 1, 1},
+    {0, 0, 127, 0, 127, 0, 1, 3, 7},
+    {0, 15, 0, 0, 127, 0, 8, 9, 5},
+    {0, 0, 0, 0, 1, 0, 1, 1, 1},
+    {0, 0, 0, 0, 127, 0, 3, 4, 1},
+    {12, 8, 15, 0, 0, 0, 29, 11, 18},
+    {0, 1, 1, 0, 0, 0, 1, 1, 3},
+    {1, 0, 1, 0, 0, 0, 1, 2, 1},
+    {0, 0, 1, 0, 0, 0, 127, 127, 4},
+    {0, 0, 127, 0, 0, 0, 127, 21, 127},
+    {0, 1, 0, 0, 0, 0, 127, 1, 1},
+    {0, 0, 0, 0, 0, 0, 127, 1, 1},
+    {0, 0, 0, 0, 0, 0, 1, 1, 10},
+    {0, 0, 0, 1, 127, 1, 0, 1, 1},
+    {127, 127, 0, 127, 127, 127, 0, 127, 127},
+    {0, 126, 0, 1, 2, 1, 0, 1, 3},
+    {0, 0, 0, 126, 127, 127, 0, 127, 127},
+    {127, 0, 0, 1, 1, 1, 0, 1, 1},
+    {0, 0, 0, 126, 1, 1, 0, 1, 4},
+    {0, 127, 0, 0, 127, 127, 0, 127, 127},
+    {127, 0, 0, 0, 3, 12, 0, 1, 1},
+    {2, 0, 0, 0, 127, 2, 0, 6, 3},
+    {0, 0, 0, 0, 32, 11, 0, 14, 26},
+    {127, 127, 0, 0, 127, 127, 0, 7, 127},
+    {0, 78, 0, 0, 127, 127, 0, 127, 127},
+    {22, 0, 0, 0, 127, 127, 0, 127, 127},
+    {0, 0, 0, 0, 127, 127, 0, 127, 127},
+    {0, 0, 0, 0, 127, 127, 0, 127, 127},
+    {0, 127, 0, 44, 0, 25, 0, 13, 56},
+    {83, 0, 0, 52, 0, 127, 0, 4, 127},
+    {127, 127, 0, 0, 0, 2, 0, 127, 127},
+    {0, 127, 0, 0, 0, 13, 0, 1, 4},
+    {0, 0, 0, 0, 0, 2, 0, 127, 1},
+    {127, 0, 0, 0, 0, 127, 0, 1, 1},
+    {0, 0, 0, 0, 0, 1, 0, 5, 127},
+    {0, 16, 0, 59, 0, 23, 0, 89, 38},
+    {127, 0, 0, 23, 0, 11, 0, 122, 127},
+    {0, 0, 0, 1, 0, 1, 0, 1, 1},
+    {127, 2, 0, 61, 0, 6, 0, 11, 127},
+    {0, 1, 0, 127, 0, 1, 0, 1, 1},
+    {56, 0, 0, 127, 0, 127, 0, 15, 127},
+    {0, 0, 0, 33, 0, 2, 0, 1, 127},
+    {0, 0, 0, 127, 0, 4, 0, 127, 1},
+    {0, 0, 0, 0, 0, 127, 0, 127, 127},
+    {127, 1, 0, 0, 0, 2, 0, 1, 1},
+    {0, 124, 0, 0, 0, 1, 0, 1, 6},
+    {0, 0, 0, 0, 0, 127, 0, 127, 127},
+    {127, 0, 0, 0, 0, 6, 0, 1, 2},
+    {1, 0, 0, 0, 0, 1, 0, 1, 1},
+    {0, 0, 0, 0, 0, 127, 0, 29, 127},
+    {0, 4, 0, 0, 0, 127, 0, 1, 1},
+    {1, 0, 0, 0, 0, 127, 0, 1, 1},
+    {0, 0, 0, 0, 0, 127, 0, 33, 48},
+    {0, 0, 127, 7, 127, 0, 0, 127, 127},
+    {0, 127, 0, 16, 127, 0, 0, 37, 127},
+    {127, 0, 0, 16, 127, 0, 0, 21, 4},
+    {0, 1, 127, 0, 5, 0, 0, 4, 127},
+    {1, 0, 127, 0, 127, 0, 0, 127, 127},
+    {0, 0, 127, 0, 2, 0, 0, 7, 1},
+    {0, 0, 0, 0, 1, 0, 0, 1, 1},
+    {127, 127, 0, 0, 127, 0, 0, 127, 127},
+    {0, 127, 0, 0, 12, 0, 0, 1, 1},
+    {0, 0, 0, 0, 127, 0, 0, 127, 127},
+    {127, 0, 0, 0, 127, 0, 0, 1, 2},
+    {0, 0, 0, 0, 127, 0, 0, 127, 127},
+    {0, 0, 127, 0, 0, 0, 0, 4, 9},
+    {0, 127, 0, 0, 0, 0, 0, 100, 127},
+    {127, 0, 0, 0, 0, 0, 0, 127, 127},
+    {0, 127, 127, 3, 0, 0, 0, 127, 127},
+    {127, 0, 27, 25, 0, 0, 0, 127, 109},
+    {0, 0, 1, 1, 0, 0, 0, 1, 1},
+    {0, 0, 0, 2, 0, 0, 0, 127, 127},
+    {0, 1, 0, 1, 0, 0, 0, 1, 8},
+    {0, 0, 0, 49, 0, 0, 0, 40, 127},
+    {1, 0, 0, 1, 0, 0, 0, 1, 1},
+    {0, 0, 0, 121, 0, 0, 0, 127, 1},
+    {0, 0, 127, 0, 0, 0, 0, 119, 127},
+    {0, 127, 0, 0, 0, 0, 0, 127, 127},
+    {127, 0, 0, 0, 0, 0, 0, 127, 1},
+    {0, 7, 1, 0, 0, 0, 0, 7, 127},
+    {0, 0, 127, 0, 0, 0, 0, 127, 127},
+    {13, 0, 1, 0, 0, 0, 0, 127, 1},
+    {0, 0, 127, 0, 0, 0, 0, 127, 127},
+    {0, 2, 0, 0, 0, 0, 0, 1, 127},
+    {4, 0, 0, 0, 0, 0, 0, 127, 29},
+    {0, 0, 0, 0, 0, 0, 0, 1, 127},
+    {127, 127, 0, 0, 0, 0, 0, 127, 127},
+    {0, 127, 0, 0, 0, 0, 0, 127, 127},
+    {127, 0, 0, 0, 0, 0, 0, 127, 127},
+    {0, 0, 0, 0, 0, 0, 0, 1, 127},
+    {0, 0, 0, 0, 0, 0, 0, 127, 1},
+    {0, 1, 1, 2, 1, 0, 0, 1, 127},
+    {0, 0, 4, 4, 127, 0, 0, 19, 127},
+    {127, 0, 1, 13, 1, 0, 0, 5, 127},
+    {0, 0, 1, 1, 1, 0, 0, 1, 1},
+    {0, 1, 0, 5, 127, 0, 0, 10, 1},
+    {4, 0, 0, 4, 127, 0, 0, 1, 2},
+    {0, 0, 0, 7, 53, 0, 0, 35, 14},
+    {0, 1, 0, 127, 1, 0, 0, 1, 127},
+    {0, 0, 0, 1, 1, 0, 0, 1, 127},
+    {0, 0, 0, 127, 1, 0, 0, 5, 127},
+    {0, 13, 51, 0, 18, 0, 0, 69, 107},
+    {127, 0, 5, 0, 1, 0, 0, 1, 1},
+    {0, 0, 1, 0, 1, 0, 0, 1, 1},
+    {0, 0, 0, 0, 127, 0, 0, 1, 2},
+    {127, 1, 0, 0, 1, 0, 0, 13, 127},
+    {0, 2, 0, 0, 1, 0, 0, 1, 1},
+    {0, 0, 0, 0, 23, 0, 0, 14, 127},
+    {127, 0, 0, 0, 1, 0, 0, 1, 3},
+    {0, 6, 10, 0, 23, 0, 0, 3, 57},
+    {6, 0, 18, 0, 127, 0, 0, 31, 46},
+    {0, 0, 1, 0, 127, 0, 0, 3, 5},
+    {0, 0, 1, 0, 127, 0, 0, 1, 1},
+    {16, 10, 0, 0, 127, 0, 0, 3, 2},
+    {0, 7, 0, 0, 116, 0, 0, 17, 3},
+    {0, 0, 0, 0, 127, 0, 0, 1, 2},
+    {14, 0, 0, 0, 92, 0, 0, 2, 4},
+    {0, 0, 0, 0, 98, 0, 0, 8, 1},
+    {0, 1, 0, 0, 1, 0, 0, 1, 1},
+    {1, 0, 0, 0, 38, 0, 0, 1, 1},
+    {0, 0, 0, 0, 127, 0, 0, 127, 127},
+    {0, 1, 127, 1, 0, 0, 0, 4, 6},
+    {8, 0, 127, 1, 0, 0, 0, 2, 1},
+    {0, 0, 127, 1, 0, 0, 0, 4, 3},
+    {0, 1, 0, 1, 0, 0, 0, 1, 1},
+    {0, 0, 0, 1, 0, 0, 0, 26, 127},
+    {1, 0, 0, 1, 0, 0, 0, 1, 1},
+    {0, 0, 0, 1, 0, 0, 0, 1, 127},
+    {0, 0, 127, 0, 0, 0, 0, 1, 1},
+    {0, 127, 0, 0, 0, 0, 0, 127, 127},
+    {122, 0, 0, 0, 0, 0, 0, 3, 127},
+    {0, 126, 38, 0, 0, 0, 0, 127, 127},
+    {0, 0, 1, 0, 0, 0, 0, 1, 1},
+    {127, 0, 127, 0, 0, 0, 0, 31, 127},
+    {0, 0, 1, 0, 0, 0, 0, 1, 3},
+    {1, 11, 0, 0, 0, 0, 0, 4, 127},
+    {0, 1, 0, 0, 0, 0, 0, 1, 127},
+    {1, 0, 0, 0, 0, 0, 0, 127, 127},
+    {0, 0, 0, 0, 0, 0, 0, 127, 40},
+    {0, 0, 0, 0, 0, 0, 0, 1, 127},
+    {0, 1, 3, 127, 0, 0, 0, 5, 3},
+    {0, 0, 1, 1, 0, 0, 0, 1, 1},
+    {0, 0, 1, 127, 0, 0, 0, 1, 1},
+    {0, 1, 0, 1, 0, 0, 0, 1, 1},
+    {0, 0, 0, 104, 0, 0, 0, 127, 127},
+    {1, 0, 0, 1, 0, 0, 0, 1, 1},
+    {0, 0, 0, 127, 0, 0, 0, 127, 4},
+    {0, 1, 0, 127, 0, 0, 0, 1, 1},
+    {0, 0, 0, 127, 0, 0, 0, 3, 127},
+    {0, 4, 1, 0, 0, 0, 0, 1, 127},
+    {0, 0, 57, 0, 0, 0, 0, 37, 127},
+    {127, 0, 2, 0, 0, 0, 0, 86, 2},
+    {0, 119, 0, 0, 0, 0, 0, 127, 95},
+    {127, 0, 0, 0, 0, 0, 0, 89, 5},
+    {0, 0, 0, 0, 0, 0, 0, 1, 1},
+    {127, 1, 0, 0, 0, 0, 0, 5, 127},
+    {17, 0, 0, 0, 0, 0, 0, 1, 127},
+    {0, 0, 0, 0, 0, 0, 0, 1, 127},
+    {0, 1, 0, 1, 58, 1, 0, 3, 1},
+    {1, 0, 0, 1, 127, 1, 0, 1, 1},
+    {0, 0, 0, 4, 127, 127, 0, 127, 127},
+    {3, 0, 0, 0, 56, 66, 0, 42, 38},
+    {0, 0, 0, 0, 114, 3, 0, 3, 2},
+    {0, 0, 0, 0, 127, 1, 0, 1, 1},
+    {1, 127, 0, 127, 0, 127, 0, 127, 2},
+    {0, 1, 0, 1, 0, 1, 0, 1, 127},
+    {1, 0, 0, 1, 0, 1, 0, 127, 1},
+    {0, 0, 0, 127, 0, 8, 0, 127, 3},
+    {0, 0, 0, 127, 0, 127, 0, 33, 62},
+    {0, 0, 0, 0, 0, 1, 0, 1, 1},
+    {127, 0, 0, 0, 0, 127, 0, 6, 1},
+    {0, 0, 0, 0, 0, 1, 0, 1, 1},
+    {0, 1, 1, 1, 1, 0, 0, 1, 1},
+    {0, 0, 127, 127, 127, 0, 0, 127, 127},
+    {1, 0, 1, 1, 126, 0, 0, 2, 1},
+    {0, 0, 14, 4, 127, 0, 0, 127, 127},
+    {0, 1, 0, 127, 1, 0, 0, 1, 127},
+    {1, 0, 0, 2, 1, 0, 0, 1, 127},
+    {0, 0, 0, 127, 1, 0, 0, 1, 127},
+    {0, 2, 0, 49, 127, 0, 0, 127, 127},
+    {52, 0, 0, 62, 29, 0, 0, 13, 25},
+    {0, 0, 0, 1, 1, 0, 0, 1, 1},
+    {0, 0, 0, 5, 127, 0, 0, 5, 1},
+    {0, 1, 1, 0, 127, 0, 0, 1, 9},
+    {1, 0, 5, 0, 127, 0, 0, 2, 10},
+    {0, 0, 65, 0, 104, 0, 0, 5, 5},
+    {0, 0, 0, 0, 1, 0, 0, 1, 1},
+    {3, 4, 0, 0, 127, 0, 0, 4, 10},
+    {0, 7, 0, 0, 127, 0, 0, 1, 2},
+    {0, 0, 0, 0, 127, 0, 0, 1, 1},
+    {11, 0, 0, 0, 86, 0, 0, 2, 2},
+    {0, 0, 0, 0, 89, 0, 0, 4, 2},
+    {38, 0, 20, 0, 115, 0, 0, 56, 5},
+    {0, 0, 7, 0, 25, 0, 0, 17, 127},
+    {48, 0, 0, 0, 3, 0, 0, 1, 127},
+    {0, 0, 0, 0, 1, 0, 0, 1, 127},
+    {0, 1, 0, 0, 127, 0, 0, 1, 1},
+    {1, 0, 0, 0, 1, 0, 0, 1, 1},
+    {0, 0, 0, 0, 44, 0, 0, 98, 89},
+    {0, 1, 1, 127, 0, 0, 0, 1, 1},
+    {1, 0, 1, 127, 0, 0, 0, 1, 2},
+    {0, 0, 1, 127, 0, 0, 0, 1, 1},
+    {0, 0, 0, 127, 0, 0, 0, 5, 4},
+    {0, 2, 0, 127, 0, 0, 0, 1, 1},
+    {0, 0, 0, 127, 0, 0, 0, 1, 1},
+    {83, 0, 0, 127, 0, 0, 0, 3, 5},
+    {0, 0, 0, 4, 0, 0, 0, 1, 1},
+    {127, 0, 1, 0, 0, 0, 0, 87, 1},
+    {0, 0, 4, 0, 0, 0, 0, 1, 127},
+    {127, 0, 0, 0, 0, 0, 0, 3, 127},
+    {127, 1, 0, 0, 0, 0, 0, 3, 1},
+    {0, 3, 0, 0, 0, 0, 0, 1, 127},
+    {127, 0, 0, 0, 0, 0, 0, 127, 3},
+    {0, 0, 0, 0, 0, 0, 0, 86, 127},
+    {127, 0, 127, 127, 0, 0, 0, 43, 127},
+    {0, 0, 1, 1, 0, 0, 0, 1, 1},
+    {0, 0, 2, 1, 0, 0, 0, 1, 1},
+    {0, 3, 0, 1, 0, 0, 0, 1, 127},
+    {0, 0, 0, 127, 0, 0, 0, 1, 127},
+    {3, 0, 0, 2, 0, 0, 0, 32, 127},
+    {0, 0, 0, 1, 0, 0, 0, 127, 25},
+    {0, 1, 1, 0, 0, 0, 0, 1, 1},
+    {0, 0, 127, 0, 0, 0, 0, 127, 127},
+    {1, 0, 1, 0, 0, 0, 0, 1, 1},
+    {0, 0, 127, 0, 0, 0, 0, 127, 53},
+    {0, 1, 0, 0, 0, 0, 0, 1, 127},
+    {4, 0, 0, 0, 0, 0, 0, 127, 125},
+    {0, 0, 0, 0, 0, 0, 0, 1, 127},
+    {1, 0, 1, 0, 0, 0, 0, 1, 1},
+    {0, 0, 127, 0, 0, 0, 0, 1, 1},
+    {0, 2, 0, 0, 0, 0, 0, 1, 1},
+    {127, 0, 0, 0, 0, 0, 0, 1, 1},
+    {0, 0, 0, 0, 0, 0, 0, 33, 127},
+    {0, 0, 127, 1, 1, 0, 0, 1, 1},
+    {0, 127, 0, 1, 1, 0, 0, 1, 4},
+    {0, 0, 0, 15, 1, 0, 0, 1, 1},
+    {0, 0, 0, 123, 127, 0, 0, 127, 1},
+    {0, 0, 0, 1, 1, 0, 0, 1, 1},
+    {53, 0, 127, 0, 18, 0, 0, 23, 127},
+    {0, 0, 2, 0, 127, 0, 0, 3, 127},
+    {0, 0, 103, 0, 1, 0, 0, 2, 1},
+    {0, 1, 0, 0, 127, 0, 0, 127, 127},
+    {0, 0, 0, 0, 46, 0, 0, 127, 127},
+    {19, 0, 0, 0, 127, 0, 0, 127, 127},
+    {0, 0, 0, 0, 127, 0, 0, 127, 127},
+    {0, 1, 0, 0, 1, 0, 0, 1, 1},
+    {1, 0, 0, 0, 1, 0, 0, 1, 2},
+    {0, 0, 0, 0, 127, 0, 0, 127, 127},
+    {0, 0, 127, 0, 127, 0, 0, 2, 1},
+    {0, 127, 0, 0, 127, 0, 0, 8, 6},
+    {127, 0, 0, 0, 4, 0, 0, 1, 1},
+    {0, 0, 1, 38, 0, 0, 0, 127, 1},
+    {0, 0, 50, 11, 0, 0, 0, 31, 127},
+    {0, 1, 0, 127, 0, 0, 0, 1, 1},
+    {0, 0, 0, 127, 0, 0, 0, 127, 1},
+    {127, 0, 0, 127, 0, 0, 0, 127, 127},
+    {0, 0, 0, 21, 0, 0, 0, 1, 127},
+    {0, 16, 0, 1, 0, 0, 0, 1, 127},
+    {0, 0, 0, 1, 0, 0, 0, 1, 127},
+    {0, 127, 127, 0, 0, 0, 0, 127, 127},
+    {0, 0, 2, 0, 0, 0, 0, 127, 1},
+    {1, 0, 127, 0, 0, 0, 0, 1, 127},
+    {0, 0, 1, 0, 0, 0, 0, 1, 127},
+    {0, 127, 0, 0, 0, 0, 0, 127, 127},
+    {127, 0, 0, 0, 0, 0, 0, 127, 127},
+    {0, 0, 0, 0, 0, 0, 0, 127, 127},
+    {0, 1, 0, 0, 0, 0, 0, 1, 127},
+    {1, 0, 0, 0, 0, 0, 0, 37, 127},
+    {0, 0, 0, 0, 0, 0, 0, 127, 26},
+    {0, 0, 0, 0, 0, 0, 0, 1, 127},
+    {127, 0, 5, 0, 0, 0, 0, 127, 5},
+    {0, 0, 1, 0, 0, 0, 0, 1, 1},
+    {0, 2, 0, 0, 0, 0, 0, 1, 2},
+    {127, 0, 0, 0, 0, 0, 0, 5, 1},
+    {0, 0, 0, 0, 0, 0, 0, 127, 127},
+    {0, 0, 0, 0, 0, 0, 0, 127, 127},
+    {0, 0, 119, 15, 0, 0, 0, 3, 2},
+    {0, 127, 0, 42, 0, 0, 0, 1, 2},
+    {1, 0, 127, 0, 0, 0, 0, 1, 1},
+    {0, 0, 127, 0, 0, 0, 0, 6, 1},
+    {0, 127, 0, 0, 0, 0, 0, 1, 1},
+    {127, 0, 0, 0, 0, 0, 0, 1, 1},
+    {0, 0, 0, 0, 0, 0, 0, 1, 127},
+    {0, 0, 0, 0, 0, 0, 0, 127, 1},
+    {62, 0, 31, 0, 5, 0, 10, 0, 16},
+    {0, 0, 1, 0, 1, 0, 1, 0, 1},
+    {0, 0, 0, 0, 5, 0, 50, 0, 47},
+    {0, 1, 0, 0, 1, 0, 1, 0, 1},
+    {0, 0, 0, 0, 127, 0, 17, 0, 4},
+    {30, 0, 0, 0, 4, 0, 5, 0, 2},
+    {0, 0, 0, 0, 127, 0, 127, 0, 127},
+    {0, 0, 35, 0, 0, 0, 26, 0, 119},
+    {0, 127, 0, 0, 0, 0, 127, 0, 1},
+    {127, 0, 0, 0, 0, 0, 127, 0, 127},
+    {0, 0, 127, 0, 0, 0, 127, 0, 127},
+    {0, 127, 0, 0, 0, 0, 127, 0, 116},
+    {22, 0, 33, 0, 0, 0, 10, 0, 127},
+    {0, 0, 127, 0, 0, 0, 127, 0, 127},
+    {0, 1, 0, 0, 0, 0, 127, 0, 127},
+    {1, 0, 0, 0, 0, 0, 1, 0, 127},
+    {0, 0, 0, 0, 0, 0, 1, 0, 127},
+    {0, 19, 0, 0, 0, 0, 127, 0, 20},
+    {107, 0, 0, 0, 0, 0, 44, 0, 127},
+    {0, 0, 0, 0, 0, 0, 1, 0, 1},
+    {0, 0, 0, 0, 0, 0, 127, 0, 1},
+    {1, 0, 4, 0, 127, 0, 3, 0, 7},
+    {0, 0, 3, 0, 62, 0, 19, 0, 6},
+    {0, 0, 1, 0, 127, 0, 1, 0, 1},
+    {0, 1, 0, 0, 1, 0, 1, 0, 1},
+    {0, 0, 0, 0, 83, 0, 127, 0, 1},
+    {0, 0, 0, 0, 104, 0, 19, 0, 12},
+    {22, 0, 20, 0, 0, 0, 127, 0, 8},
+    {0, 0, 1, 0, 0, 0, 1, 0, 127},
+    {0, 1, 0, 0, 0, 0, 127, 0, 1},
+    {0, 0, 0, 0, 0, 0, 127, 0, 2},
+    {0, 127, 0, 0, 2, 0, 0, 0, 127},
+    {92, 0, 0, 0, 3, 0, 0, 0, 7},
+    {0, 107, 0, 3, 0, 0, 0, 0, 127},
+    {0, 0, 0, 0, 0, 0, 0, 0, 29},
+    {0, 2, 0, 0, 0, 0, 0, 0, 107},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {18, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 0, 74, 2, 7, 0, 0, 0, 17},
+    {0, 0, 0, 1, 3, 0, 0, 0, 1},
+    {0, 3, 0, 4, 3, 0, 0, 0, 127},
+    {0, 0, 0, 1, 2, 0, 0, 0, 127},
+    {0, 0, 0, 1, 3, 0, 0, 0, 101},
+    {0, 0, 71, 0, 1, 0, 0, 0, 127},
+    {0, 80, 0, 0, 6, 0, 0, 0, 127},
+    {14, 0, 0, 0, 5, 0, 0, 0, 38},
+    {0, 0, 2, 0, 41, 0, 0, 0, 1},
+    {3, 0, 12, 0, 49, 0, 0, 0, 127},
+    {0, 0, 1, 0, 127, 0, 0, 0, 5},
+    {0, 1, 0, 0, 127, 0, 0, 0, 2},
+    {1, 0, 0, 0, 127, 0, 0, 0, 1},
+    {0, 0, 0, 0, 20, 0, 0, 0, 127},
+    {0, 1, 0, 0, 127, 0, 0, 0, 127},
+    {2, 0, 0, 0, 127, 0, 0, 0, 127},
+    {0, 0, 0, 0, 127, 0, 0, 0, 127},
+    {0, 0, 0, 0, 3, 0, 0, 0, 127},
+    {0, 0, 127, 1, 0, 0, 0, 0, 1},
+    {0, 98, 0, 1, 0, 0, 0, 0, 127},
+    {1, 0, 1, 0, 0, 0, 0, 0, 1},
+    {0, 0, 127, 0, 0, 0, 0, 0, 127},
+    {0, 127, 0, 0, 0, 0, 0, 0, 127},
+    {1, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 0, 0, 0, 0, 0, 0, 0, 53},
+    {0, 0, 6, 127, 0, 0, 0, 0, 77},
+    {0, 0, 3, 127, 0, 0, 0, 0, 5},
+    {0, 1, 0, 127, 0, 0, 0, 0, 127},
+    {0, 0, 0, 1, 0, 0, 0, 0, 127},
+    {0, 3, 0, 127, 0, 0, 0, 0, 89},
+    {0, 0, 0, 1, 0, 0, 0, 0, 89},
+    {0, 0, 0, 95, 0, 0, 0, 0, 127},
+    {1, 0, 1, 0, 0, 0, 0, 0, 1},
+    {0, 0, 1, 0, 0, 0, 0, 0, 127},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 2, 0, 0, 0, 0, 0, 0, 68},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {92, 0, 0, 0, 0, 0, 0, 0, 8},
+    {0, 1, 0, 1, 1, 0, 0, 0, 1},
+    {0, 0, 0, 127, 127, 0, 0, 0, 1},
+    {0, 0, 0, 16, 127, 0, 0, 0, 24},
+    {127, 0, 0, 0, 50, 0, 0, 0, 4},
+    {0, 0, 0, 0, 127, 0, 0, 0, 1},
+    {0, 23, 0, 127, 0, 0, 0, 0, 3},
+    {127, 0, 0, 0, 0, 0, 0, 0, 1},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 0, 3, 1, 74, 0, 0, 0, 2},
+    {0, 0, 127, 1, 127, 0, 0, 0, 1},
+    {0, 1, 0, 127, 4, 0, 0, 0, 4},
+    {0, 0, 0, 127, 127, 0, 0, 0, 3},
+    {0, 0, 0, 127, 127, 0, 0, 0, 127},
+    {0, 1, 0, 1, 1, 0, 0, 0, 1},
+    {0, 0, 0, 2, 127, 0, 0, 0, 127},
+    {0, 0, 3, 0, 56, 0, 0, 0, 6},
+    {7, 0, 25, 0, 3, 0, 0, 0, 4},
+    {0, 0, 127, 0, 71, 0, 0, 0, 70},
+    {0, 127, 0, 0, 127, 0, 0, 0, 127},
+    {127, 0, 0, 0, 127, 0, 0, 0, 127},
+    {0, 0, 0, 0, 127, 0, 0, 0, 127},
+    {0, 127, 0, 0, 127, 0, 0, 0, 127},
+    {0, 0, 0, 0, 59, 0, 0, 0, 2},
+    {0, 0, 0, 0, 1, 0, 0, 0, 1},
+    {0, 77, 0, 0, 127, 0, 0, 0, 1},
+    {0, 0, 0, 0, 127, 0, 0, 0, 1},
+    {0, 0, 0, 0, 62, 0, 0, 0, 3},
+    {0, 0, 1, 1, 0, 0, 0, 0, 127},
+    {0, 13, 0, 127, 0, 0, 0, 0, 2},
+    {0, 0, 0, 127, 0, 0, 0, 0, 1},
+    {0, 1, 0, 2, 0, 0, 0, 0, 127},
+    {0, 0, 0, 1, 0, 0, 0, 0, 127},
+    {14, 0, 113, 0, 0, 0, 0, 0, 21},
+    {0, 0, 127, 0, 0, 0, 0, 0, 1},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 127, 0, 0, 0, 0, 0, 0, 1},
+    {1, 0, 0, 0, 0, 0, 0, 0, 1},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 0, 55, 0, 0, 0, 0, 0, 127},
+    {127, 0, 0, 0, 0, 0, 0, 0, 1},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 127, 0, 0, 0, 0, 0, 0, 127},
+    {0, 8, 0, 127, 0, 0, 0, 0, 4},
+    {0, 0, 0, 1, 0, 0, 0, 0, 1},
+    {0, 0, 0, 127, 0, 0, 0, 0, 1},
+    {0, 0, 1, 0, 0, 0, 0, 0, 1},
+    {0, 0, 127, 0, 0, 0, 0, 0, 1},
+    {0, 1, 0, 0, 0, 0, 0, 0, 127},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {127, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 127, 0, 0, 127, 0, 1, 0, 1},
+    {0, 1, 0, 0, 0, 0, 1, 0, 1},
+    {0, 0, 0, 0, 0, 0, 127, 0, 1},
+    {0, 0, 0, 0, 0, 0, 127, 0, 127},
+    {0, 4, 0, 1, 127, 0, 0, 0, 1},
+    {0, 0, 0, 3, 127, 0, 0, 0, 1},
+    {0, 0, 0, 5, 107, 0, 0, 0, 2},
+    {0, 1, 0, 127, 1, 0, 0, 0, 127},
+    {0, 0, 0, 127, 1, 0, 0, 0, 14},
+    {0, 0, 0, 0, 83, 0, 0, 0, 2},
+    {0, 0, 0, 0, 1, 0, 0, 0, 127},
+    {0, 0, 0, 0, 14, 0, 0, 0, 3},
+    {0, 0, 0, 0, 1, 0, 0, 0, 1},
+    {0, 2, 0, 3, 0, 0, 0, 0, 127},
+    {0, 0, 0, 1, 0, 0, 0, 0, 127},
+    {0, 0, 0, 127, 0, 0, 0, 0, 127},
+    {0, 1, 0, 0, 0, 0, 0, 0, 1},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 1, 0, 0, 0, 0, 0, 0, 127},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 44, 0, 50, 0, 0, 0, 0, 1},
+    {0, 0, 0, 1, 0, 0, 0, 0, 1},
+    {0, 0, 0, 127, 0, 0, 0, 0, 1},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 0, 0, 0, 1, 0, 0, 0, 1},
+    {0, 0, 0, 1, 0, 0, 0, 0, 89},
+    {0, 0, 0, 0, 0, 0, 0, 0, 127},
+    {0, 127, 0, 3, 3, 4, 0, 28, 0},
+    {0, 0, 0, 0, 1, 1, 0, 1, 0},
+    {0, 98, 0, 0, 4, 5, 0, 127, 0},
+    {0, 0, 0, 0, 1, 1, 0, 127, 0},
+    {0, 0, 0, 0, 1, 1, 0, 1, 0},
+    {0, 127, 0, 0, 0, 1, 0, 127, 0},
+    {0, 0, 0, 1, 0, 1, 0, 127, 0},
+    {0, 73, 0, 3, 0, 1, 0, 127, 0},
+    {0, 0, 0, 1, 0, 1, 0, 127, 0},
+    {0, 127, 0, 0, 0, 1, 0, 127, 0},
+    {0, 0, 0, 0, 0, 127, 0, 127, 0},
+    {0, 1, 0, 0, 0, 127, 0, 127, 0},
+    {0, 0, 0, 0, 0, 9, 0, 127, 0},
+    {0, 0, 0, 0, 0, 1, 0, 127, 0},
+    {0, 127, 0, 0, 1, 0, 0, 35, 0},
+    {0, 48, 0, 0, 0, 0, 0, 127, 0},
+    {0, 0, 0, 0, 0, 0, 0, 127, 0},
+    {0, 0, 0, 0, 0, 0, 0, 127, 0},
+    {0, 1, 0, 0, 127, 0, 0, 1, 0},
+    {0, 0, 0, 0, 127, 0, 0, 127, 0},
+    {0, 0, 0, 0, 7, 0, 0, 77, 0},
+    {0, 21, 0, 0, 0, 0, 0, 127, 0},
+    {0, 0, 0, 0, 0, 0, 0, 58, 0},
+    {0, 1, 0, 1, 127, 2, 0, 1, 0},
+    {0, 0, 0, 127, 2, 1, 0, 1, 0},
+    {0, 0, 0, 2, 127, 1, 0, 2, 0},
+    {0, 0, 0, 0, 127, 127, 0, 127, 0},
+    {0, 0, 0, 0, 127, 2, 0, 1, 0},
+    {0, 11, 0, 1, 0, 1, 0, 1, 0},
+    {0, 0, 0, 127, 0, 1, 0, 127, 0},
+    {0, 1, 0, 1, 1, 0, 0, 1, 0},
+    {0, 0, 0, 127, 127, 0, 0, 127, 0},
+    {0, 0, 0, 1, 127, 0, 0, 1, 0},
+    {0, 127, 0, 0, 127, 0, 0, 2, 0},
+    {0, 1, 0, 0, 127, 0, 0, 1, 0},
+    {0, 0, 0, 0, 127, 0, 0, 1, 0},
+    {0, 127, 0, 127, 0, 0, 0, 1, 0},
+    {0, 4, 0, 127, 1, 0, 0, 1, 0},
+    {0, 0, 0, 127, 30, 0, 0, 63, 0},
+    {0, 0, 0, 4, 127, 0, 0, 1, 0},
+    {0, 127, 0, 0, 127, 0, 0, 127, 0},
+    {0, 0, 0, 0, 127, 0, 0, 127, 0},
+    {0, 0, 0, 0, 127, 0, 0, 1, 0},
+    {0, 0, 0, 0, 127, 0, 0, 1, 0},
+    {0, 0, 0, 0, 127, 0, 0, 1, 0},
+    {0, 0, 0, 0, 80, 0, 0, 2, 0},
+    {0, 11, 0, 127, 0, 0, 0, 8, 0},
+    {0, 0, 0, 127, 0, 0, 0, 1, 0},
+    {0, 0, 0, 70, 0, 0, 0, 127, 0},
+    {0, 0, 0, 0, 0, 0, 0, 127, 0},
+    {0, 127, 0, 0, 0, 0, 0, 1, 0},
+    {0, 0, 0, 0, 0, 0, 0, 127, 0},
+    {0, 0, 0, 127, 0, 0, 0, 1, 0},
+    {0, 0, 0, 1, 0, 0, 0, 1, 0},
+    {0, 127, 0, 0, 0, 0, 0, 127, 0},
+    {0, 0, 0, 0, 0, 0, 0, 127, 0},
+    {0, 0, 0, 0, 0, 0, 0, 127, 0},
+    {0, 127, 0, 127, 127, 0, 0, 0, 0},
+    {0, 0, 0, 0, 127, 0, 0, 0, 0},
+    {0, 0, 0, 127, 1, 0, 0, 0, 0},
+    {0, 0, 0, 1, 127, 0, 0, 0, 0},
+    {0, 0, 0, 0, 127, 0, 0, 0, 0},
+    {0, 1, 0, 0, 1, 0, 0, 0, 0},
+    {0, 0, 0, 0, 127, 0, 0, 0, 0},
+    {0, 0, 0, 0, 127, 0, 0, 0, 0},
+    {0, 0, 0, 0, 127, 0, 0, 0, 0},
+    {0, 0, 0, 0, 20, 0, 0, 0, 0},
+    {0, 0, 0, 127, 0, 0, 0, 0, 0},
+    {0, 127, 0, 1, 0, 0, 0, 0, 0},
+    {0, 127, 0, 0, 0, 0, 0, 0, 0},
+    {0, 0, 0, 127, 0, 0, 0, 0, 0},
+    {0, 0, 0, 0, 11, 0, 0, 0, 0},
+    {0, 0, 0, 0, 0, 41, 0, 89, 0},
+    {0, 0, 0, 0, 53, 0, 0, 4, 0},
+    {0, 0, 0, 0, 8, 0, 0, 0, 0},
+};
+
+#endif // FROZEN_POLICY_H
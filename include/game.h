@@ -7,13 +7,18 @@
 
 #include "constants.h"
 #include "game_bot.h"
+#include "match_box_history.h"
+#include "ponderer.h"
 #include "statistics.h"
 
 class Game
 {
 public:
-    Game();
+    explicit Game(const PlayerRoles & player_roles = DEFAULT_PLAYER_ROLES);
     void reset();
+    void set_player_roles(const PlayerRoles & player_roles);
+    PlayerRoles get_player_roles() const;
+    void set_pondering(bool pondering);
     bool play_next(int8_t row_index, int8_t col_index, Move & next_move);
     bool play_bot(int8_t & row_index, int8_t & col_index, Move & next_move);
     GameState get_game_state();
@@ -24,10 +29,15 @@ private:
     bool _play(int8_t row_index, int8_t col_index);
     bool _play_bot(int8_t & row_index, int8_t & col_index);
     void _switch_next_player();
+    void _start_pondering();
     void _print_game();
 
+    PlayerRoles _player_roles;
     Grid _grid;
     GameBot _game_bot;
+    MatchBoxHistory _bot_history;
+    Ponderer _ponderer;
+    bool _pondering;
     Statistics _statistics;
     std::string _game_status_string;
 };
@@ -0,0 +1,77 @@
+#ifndef GAME_ARCHIVE_H
+#define GAME_ARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "constants.h"
+
+// Number of leading moves indexed by the opening bitmaps.
+#define GAME_ARCHIVE_NUM_OPENING_MOVES (2)
+
+// One game decoded from the archive columns.
+struct ArchivedGame {
+    std::vector<Move> moves;
+    std::vector<MovePosition> move_positions;
+    GameOutcome game_outcome;
+    PlayerRoles player_roles;
+    uint32_t timestamp;
+};
+
+// Filters of GameArchive::find(). Fields left at their defaults match every
+// game. The opening is compared up to symmetry and regardless of which
+// player started, so {(0, 0)} matches every corner opening.
+struct GameArchiveQuery {
+    GameOutcome game_outcome = GameOutcome::UNKNOWN;
+    Move bot_move = Move::EMPTY;
+    std::vector<MovePosition> opening;
+    uint32_t from_timestamp = 0;
+    uint32_t to_timestamp = UINT32_MAX;
+};
+
+// Finished games stored column-wise: packed move sequences, outcomes, first
+// player, bot side and timestamps each live in their own array. Outcome and
+// opening filters are answered from bitmap indexes, and the bot side and
+// timestamp columns are only read for the games those bitmaps leave.
+// The indexes are rebuilt from the columns on load(). The archive also
+// records how many source files (game logs) it was built from, skipped ones
+// included, so callers can tell whether it is still up to date.
+class GameArchive
+{
+public:
+    GameArchive();
+    void clear();
+    void append(const std::vector<MovePosition> & move_positions, GameOutcome game_outcome, const PlayerRoles & player_roles, uint32_t timestamp);
+    size_t num_games() const;
+    void set_num_source_files(size_t num_source_files);
+    size_t num_source_files() const;
+    ArchivedGame get_game(size_t game_index) const;
+    void find(const GameArchiveQuery & query, std::vector<size_t> & game_indices) const;
+    size_t count(const GameArchiveQuery & query) const;
+    bool save(const std::string & filename) const;
+    bool load(const std::string & filename);
+private:
+    typedef std::vector<uint64_t> Bitmap;
+
+    void _index_game(size_t game_index);
+    bool _get_candidates(const GameArchiveQuery & query, Bitmap & candidates) const;
+    bool _matches_columns(const GameArchiveQuery & query, size_t game_index) const;
+    static void _set_bit(Bitmap & bitmap, size_t index);
+    static uint64_t _opening_key(const std::vector<MovePosition> & move_positions, size_t num_moves);
+
+    std::vector<uint64_t> _packed_moves;
+    std::vector<uint8_t> _game_outcomes;
+    std::vector<uint8_t> _first_player_moves;
+    std::vector<uint8_t> _bot_moves;
+    std::vector<uint32_t> _timestamps;
+    size_t _num_source_files;
+
+    Bitmap _game_outcome_bitmaps[static_cast<size_t>(GameOutcome::UNKNOWN)];
+    // By canonical_grid_index() after the first 1 .. GAME_ARCHIVE_NUM_OPENING_MOVES moves.
+    std::unordered_map<uint64_t, Bitmap> _opening_bitmaps[GAME_ARCHIVE_NUM_OPENING_MOVES];
+};
+
+#endif // GAME_ARCHIVE_H
@@ -1,49 +1,104 @@
 #ifndef GAME_BOT_H
 #define GAME_BOT_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
 #include <set>
 #include <vector>
 
+#include "anytime_search.h"
 #include "constants.h"
 #include "match_box.h"
+#include "match_box_history.h"
+#include "ntuple_network.h"
 #include "grid.h"
-
-enum class GridTransformation {
-    GRID_UNEQUAL = 0,
-    GRID_ROTATION_180 = 1,
-    GRID_ROTATION_LEFT = 2,
-    GRID_ROTATION_RIGHT = 3,
-    GRID_REFLECTION_X = 4,
-    GRID_REFLECTION_Y = 5,
-    GRID_REFLECTION_DIAG = 6,
-    GRID_REFLECTION_DIAG_1 = 7,
-    GRID_REFLECTION_DIAG_2 = 8,
-    GRID_EQUAL = 9,
-};
+#include "grid_symmetry.h"
+#include "policy_snapshot.h"
+#include "seed_delta_buffer.h"
+#include "shared_policy_segment.h"
+#include "tablebase.h"
+#include "task_scheduler.h"
 
 class GameBot
 {
 public:
     GameBot();
     bool get_next_move(const Grid & grid, MovePosition & position);
-    void finish_game(GameState game_state);
-    void load_move_history(const std::vector<Move> move_history, const std::vector<MovePosition> move_position_history);
+    bool get_next_move(const Grid & grid, MovePosition & position, MatchBoxHistory & history);
+    bool get_seeded_move(const Grid & grid, uint32_t random_number, MovePosition & position);
+    void get_next_moves(const Grid * grids, MatchBoxHistory * const * histories, MovePosition * positions, bool * valid_positions, size_t num_grids);
+    void finish_game(GameState game_state, Move side);
+    void finish_game(GameState game_state, MatchBoxHistory & history, Move side);
+    void finish_game(GameState game_state, MatchBoxHistory & history, SeedDeltaBuffer & delta_buffer, Move side);
+    void merge_seed_deltas(const std::vector<SeedDeltaBuffer *> & delta_buffers, TaskScheduler & scheduler = TaskScheduler::instance());
+    void set_seed_delta_merge_interval(size_t merge_interval);
+    void train_self_play(size_t num_games, TaskScheduler & scheduler = TaskScheduler::instance());
+    void load_move_history(const std::vector<Move> move_history, const std::vector<MovePosition> move_position_history, Move first_player_move, Move bot_move);
+    bool get_move_priors(const Grid & grid, float priors[NUM_ROWS][NUM_COLS]);
+    bool load_tablebase(const std::string & filename);
+    void set_search_budget(std::chrono::microseconds search_budget);
+    void set_search_stop_flag(const std::atomic<bool> * stop_flag);
+    SearchStatistics get_search_statistics() const;
+    void enable_policy_snapshots(size_t publish_interval);
+    void publish_policy();
+    uint64_t get_policy_version() const;
+    bool save_policy(const std::string & filename) const;
+    bool load_policy(const std::string & filename);
+    bool export_policy_header(const std::string & filename, bool export_seeds) const;
+    void store_shared_policy(SharedPolicySegment & segment);
+    void load_shared_policy(const SharedPolicySegment & segment);
+    void attach_shared_policy(SharedPolicySegment * segment);
+    void attach_ntuple_network(NTupleNetwork * network);
 private:
+    void _train_ntuple_network(GameState game_state, const MatchBoxHistory & history, Move side);
+    void _compute_canonical_cells();
+    PolicySnapshot * _create_policy_snapshot() const;
+    bool _search_next_move(const Grid & grid, MovePosition & position, MatchBoxHistory & history);
+    bool _probe_next_move(const Grid & grid, MovePosition & position, MatchBoxHistory & history);
+    void _record_chosen_move(const Grid & grid, MovePosition position, MatchBoxHistory & history);
     bool _transform_position(const Grid & grid, const Grid & match_box_grid, MovePosition & position);
+    static bool _transform_position(GridTransformation grid_transformation, MovePosition & position);
     MatchBox * _find_match_box(const Grid & grid);
+    MatchBox * _find_match_box(const Grid & grid, GridTransformation & grid_transformation);
+    static Grid _match_box_frame(const Grid & grid);
     bool _check_grids_equal(const Grid & first, const Grid & second);
     GridTransformation _get_grid_transformation(const Grid & first, const Grid & second);
     bool _check_grid_unique(const std::vector<Grid> & unique_grids, const Grid & grid);
-    void _punish_moves();
-    void _reward_moves();
-    void _reward_drawn_moves();
+    void _play_self_play_game(SeedDeltaBuffer & delta_buffer);
+    template <Move Side>
+    void _finish_game(GameState game_state, MatchBoxHistory & history);
+    template <Move Side>
+    void _finish_game(GameState game_state, MatchBoxHistory & history, SeedDeltaBuffer & delta_buffer);
+    void _punish_moves(const MatchBoxHistory & history);
+    void _reward_moves(const MatchBoxHistory & history);
+    void _reward_drawn_moves(const MatchBoxHistory & history);
 
     void _find_valid_children(const Grid & start_grid, std::map<size_t, std::vector<Grid>> & valid_grids);
 
     std::map<size_t, std::vector<Grid>> _valid_grids;
     std::map<size_t, std::vector<MatchBox> > _match_boxes;
-    std::vector<MatchBox *> _match_box_history;
-    std::vector<MovePosition> _move_position_history;
+    std::vector<MatchBox *> _match_boxes_by_index;
+    MatchBoxHistory _match_box_history;
+    Tablebase _tablebase;
+    AnytimeSearch _anytime_search;
+    std::chrono::microseconds _search_budget;
+    std::unique_ptr<PolicyStore> _policy_store;
+    size_t _policy_publish_interval;
+    size_t _games_since_policy_publish;
+    uint64_t _policy_version;
+    size_t _seed_delta_merge_interval;
+    // While attached, merge_seed_deltas() adds into the shared segment and
+    // reads the match boxes back from it.
+    SharedPolicySegment * _shared_policy;
+    // Per match box index: canonical_grid_index() of its grid, and the cell
+    // of the canonical frame each of its cells lands on.
+    std::vector<uint64_t> _canonical_keys;
+    std::vector<std::array<uint8_t, MAX_RANK>> _canonical_cells;
+    // Trained by finish_game() and scores search leaves while attached.
+    NTupleNetwork * _ntuple_network;
 };
 
 #endif // GAME_BOT_H
@@ -4,9 +4,9 @@
 #include <QLabel>
 #include <QWidget>
 
+#include "board_widget.h"
 #include "constants.h"
 #include "game.h"
-#include "game_cell.h"
 
 class GameWidget : public QWidget
 {
@@ -24,7 +24,7 @@ private:
     void _freeze_game();
     void _unfreeze_game();
 
-    GameCell * _game_cells[NUM_ROWS][NUM_COLS];
+    BoardWidget * _board_widget;
     QLabel * _move_label;
     QLabel * _status_label;
     Game _game;
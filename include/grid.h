@@ -10,18 +10,25 @@ class Grid
 {
 public:
 	Grid();
+	explicit Grid(Move first_player_move);
     bool operator==(const Grid & other) const;
 	void reset();
 	Move value(int8_t row, int8_t col) const;
 	bool set_value(int8_t row, int8_t col);
 	bool set_value(int8_t row, int8_t col, Move move);
+	void make_move(int8_t row, int8_t col, Move move);
+	void unmake_move(int8_t row, int8_t col);
 	std::vector<MovePosition> valid_move_positions() const;
+	Move first_player() const;
 	Move next_player() const;
 	GameState game_state() const;
 	bool has_game_ended() const;
 	bool can_win_in_one_move(MovePosition & position) const;
+	bool is_winning_move(int8_t row, int8_t col, Move move) const;
     std::vector<MovePosition> winning_moves() const;
     size_t rank() const;
+    uint64_t hash() const;
+    Grid swapped_players() const;
     void print_grid() const;
 private:
 	bool _has_game_ended() const;
@@ -31,6 +38,8 @@ private:
 	bool _get_completed_diag(std::vector<MovePosition> & winning_moves) const;
 
 	Move _grid[NUM_ROWS][NUM_COLS];
+	Move _first_player;
+	uint64_t _hash;
 };
 
 #endif // GRID_H
\ No newline at end of file
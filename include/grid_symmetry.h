@@ -0,0 +1,58 @@
+#ifndef GRID_SYMMETRY_H
+#define GRID_SYMMETRY_H
+
+#include <cstdint>
+
+#include "constants.h"
+#include "grid.h"
+
+enum class GridTransformation {
+    GRID_UNEQUAL = 0,
+    GRID_ROTATION_180 = 1,
+    GRID_ROTATION_LEFT = 2,
+    GRID_ROTATION_RIGHT = 3,
+    GRID_REFLECTION_X = 4,
+    GRID_REFLECTION_Y = 5,
+    GRID_REFLECTION_DIAG = 6,
+    GRID_REFLECTION_DIAG_1 = 7,
+    GRID_REFLECTION_DIAG_2 = 8,
+    GRID_EQUAL = 9,
+};
+
+#define STR_GRID_TRANSFORMATION(t) (\
+    t == GridTransformation::GRID_UNEQUAL ? "GRID_UNEQUAL" :\
+    t == GridTransformation::GRID_ROTATION_180 ? "GRID_ROTATION_180" :\
+    t == GridTransformation::GRID_ROTATION_LEFT ? "GRID_ROTATION_LEFT" :\
+    t == GridTransformation::GRID_ROTATION_RIGHT ? "GRID_ROTATION_RIGHT" :\
+    t == GridTransformation::GRID_REFLECTION_X ? "GRID_REFLECTION_X" :\
+    t == GridTransformation::GRID_REFLECTION_Y ? "GRID_REFLECTION_Y" :\
+    t == GridTransformation::GRID_REFLECTION_DIAG ? "GRID_REFLECTION_DIAG" :\
+    t == GridTransformation::GRID_REFLECTION_DIAG_1 ? "GRID_REFLECTION_DIAG_1" :\
+    t == GridTransformation::GRID_REFLECTION_DIAG_2 ? "GRID_REFLECTION_DIAG_2" :\
+    t == GridTransformation::GRID_EQUAL ? "GRID_EQUAL" :\
+    "UNKNOWN")
+
+#define NUM_GRID_SYMMETRIES (8)
+
+// The distinct mappings tested by find_grid_transformation(), in
+// the same order. GRID_REFLECTION_DIAG_2 maps cells exactly like
+// GRID_ROTATION_180, so it is left out.
+extern const GridTransformation GRID_SYMMETRIES[NUM_GRID_SYMMETRIES];
+
+bool grid_symmetry_is_valid(GridTransformation grid_transformation);
+MovePosition grid_symmetry_source(GridTransformation grid_transformation, size_t row, size_t col);
+Grid transform_grid(const Grid & grid, GridTransformation grid_transformation);
+// The first entry of GRID_SYMMETRIES whose transform_grid() of second equals
+// first, or GRID_UNEQUAL. Both grids are packed into 16-byte vectors and
+// every symmetry is one byte shuffle and compare (SSSE3 pshufb where the CPU
+// has it, NEON tbl, plain loops elsewhere).
+GridTransformation find_grid_transformation(const Grid & first, const Grid & second);
+
+// Base-3 number of a grid, cell (row, col) being digit row * NUM_COLS + col.
+uint64_t grid_index(const Grid & grid);
+Grid grid_from_index(uint64_t index);
+uint64_t canonical_grid_index(const Grid & grid);
+// Also returns the symmetry whose transform_grid() has the smallest index.
+uint64_t canonical_grid_index(const Grid & grid, GridTransformation & grid_transformation);
+
+#endif // GRID_SYMMETRY_H
@@ -0,0 +1,95 @@
+#ifndef LAZY_POLICY_STORE_H
+#define LAZY_POLICY_STORE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "constants.h"
+
+// Largest box: one seed byte per cell, empty cells given as a 64-bit mask.
+#define LAZY_POLICY_MAX_CELLS (64)
+#define LAZY_POLICY_NUM_SHARDS (64)
+#define LAZY_POLICY_INITIAL_SHARD_CAPACITY_LOG2 (8)
+// Seed blocks are allocated this many at a time.
+#define LAZY_POLICY_BLOCKS_PER_CHUNK (4096)
+
+struct LazyPolicyStatistics {
+    uint64_t num_boxes;
+    uint64_t num_resident_boxes;
+    uint64_t num_spilled_boxes;
+    uint64_t num_evictions;
+    uint64_t num_reloads;
+    size_t resident_bytes;
+    size_t table_bytes;
+};
+
+// Match box seeds for boards far too large to enumerate up front. A box is
+// created the first time its position key is looked up, with MAX_NUM_SEEDS
+// on every empty cell, so memory follows the positions actually reached.
+//
+// Keys are spread over LAZY_POLICY_NUM_SHARDS open-addressing tables, each
+// behind its own mutex and grown like SparseCellTable, so threads only meet
+// when they touch the same shard. A slot is 16 bytes; the seeds of a box sit
+// in a separate block, and at most memory_limit bytes of blocks are
+// resident. Beyond that, a clock hand sweeps the shards: boxes used since
+// its last pass get a second chance, the others are written to the spill
+// file and their block is reused. A spilled box keeps its slot and its
+// record in the file and is read back on its next lookup.
+//
+// Keys are supplied by the caller (e.g. a canonical Zobrist hash) and must
+// not be UINT64_MAX; like TranspositionTable, two positions sharing a key
+// share a box.
+class LazyPolicyStore
+{
+public:
+    LazyPolicyStore(size_t num_cells, size_t memory_limit);
+    ~LazyPolicyStore();
+    LazyPolicyStore(const LazyPolicyStore & other) = delete;
+    void operator=(const LazyPolicyStore & other) = delete;
+
+    bool open_spill_file(const std::string & filename);
+    size_t num_cells() const;
+    bool get_seeds(uint64_t key, uint64_t empty_cells, int8_t * seeds);
+    bool apply_seed_delta(uint64_t key, uint64_t empty_cells, size_t cell, int32_t rewards, int32_t punishments);
+    LazyPolicyStatistics get_statistics() const;
+private:
+    struct Slot;
+    struct Shard;
+
+    Shard & _shard(uint64_t key) const;
+    int8_t * _find_box(Shard & shard, uint64_t key, uint64_t empty_cells);
+    size_t _find_or_insert(Shard & shard, uint64_t key);
+    void _grow(Shard & shard);
+    int8_t * _block(uint32_t block_index) const;
+    uint32_t _allocate_block(Shard & locked_shard);
+    uint32_t _evict_one(Shard & locked_shard);
+    bool _spill(Slot & slot);
+    bool _reload(const Slot & slot);
+
+    size_t _num_cells;
+    size_t _max_resident_blocks;
+    std::unique_ptr<Shard[]> _shards;
+    std::atomic<size_t> _clock_shard;
+
+    std::mutex _block_mutex;
+    std::vector<std::unique_ptr<int8_t[]>> _chunks;
+    std::vector<uint32_t> _free_blocks;
+    size_t _num_chunks;
+    std::atomic<uint64_t> _num_resident_boxes;
+
+    int _spill_file;
+    std::atomic<uint32_t> _num_spill_records;
+
+    std::atomic<uint64_t> _num_boxes;
+    std::atomic<uint64_t> _num_spilled_boxes;
+    std::atomic<uint64_t> _num_evictions;
+    std::atomic<uint64_t> _num_reloads;
+    std::atomic<size_t> _num_slots;
+};
+
+#endif // LAZY_POLICY_STORE_H
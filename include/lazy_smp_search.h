@@ -0,0 +1,51 @@
+#ifndef LAZY_SMP_SEARCH_H
+#define LAZY_SMP_SEARCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "anytime_search.h"
+#include "constants.h"
+#include "grid.h"
+#include "qubic_board.h"
+#include "task_scheduler.h"
+#include "transposition_table.h"
+
+// Lazy SMP: every thread runs its own iterative deepening alpha-beta on the
+// same root and they only cooperate through the shared transposition table.
+// Helpers run as scheduler tasks and start at staggered depths so that they fill the table with
+// entries the main thread will need next. Qubic positions are stored under
+// their canonical symmetry, so all 48 images of a position share one entry.
+class LazySmpSearch
+{
+public:
+    LazySmpSearch(size_t num_threads, size_t table_size_log2, TaskScheduler & scheduler = TaskScheduler::instance());
+    bool search(const Grid & grid, std::chrono::microseconds search_budget, MovePosition & best_position);
+    bool search(const QubicBoard & board, std::chrono::microseconds search_budget, QubicMove & best_move);
+    void clear();
+    SearchStatistics get_statistics() const;
+    int32_t get_score() const;
+private:
+    template <typename Board, typename Position>
+    bool _search(const Board & board, std::chrono::microseconds search_budget, size_t max_rank, Position no_position, Position & best_position);
+    template <typename Board, typename Position>
+    void _iterative_deepening(const Board & board, size_t thread_index, Position no_position, Position & best_position, int32_t & best_score, uint64_t & nodes_searched, size_t & depth_reached);
+    template <typename Board, typename Position>
+    int32_t _negamax(Board & board, Move player, size_t depth, size_t ply, int32_t alpha, int32_t beta, Position no_position, uint64_t & nodes_searched);
+    int32_t _score_to_table(int32_t score, size_t ply) const;
+    int32_t _score_from_table(int32_t score, size_t ply) const;
+    bool _should_stop(uint64_t nodes_searched);
+
+    size_t _num_threads;
+    TaskScheduler & _scheduler;
+    TranspositionTable _transposition_table;
+    std::chrono::steady_clock::time_point _deadline;
+    std::atomic<bool> _stop;
+    SearchStatistics _statistics;
+    int32_t _score;
+    // Most moves in a game on the board being searched.
+    size_t _max_rank;
+};
+
+#endif // LAZY_SMP_SEARCH_H
@@ -1,6 +1,7 @@
 #ifndef MATCH_BOX_H
 #define MATCH_BOX_H
 
+#include <algorithm>
 #include <cstdint>
 #include <istream>
 #include <map>
@@ -8,21 +9,52 @@
 #include "constants.h"
 #include "grid.h"
 
+// Seeds added to or taken from a move at the end of a game.
+#define MATCH_BOX_WIN_REWARD (3)
+#define MATCH_BOX_DRAW_REWARD (1)
+#define MATCH_BOX_LOSS_PENALTY (1)
+
+// Seeds of one move after a batch of rewards and punishments: rewards
+// first, up to INT8_MAX, then punishments down to the same floor of one
+// seed that MatchBox::punish_move() keeps. Every store of match box seeds
+// applies deltas through this.
+inline int8_t apply_seed_delta_rule(int8_t seeds, int32_t rewards, int32_t punishments) {
+    int32_t remaining_seeds = std::min<int32_t>(seeds + rewards, INT8_MAX);
+    if (punishments > 0 && remaining_seeds > 1) {
+        remaining_seeds = std::max<int32_t>(remaining_seeds - punishments, 1);
+    }
+    return static_cast<int8_t>(remaining_seeds);
+}
+
+struct MatchBoxSeeds {
+    int8_t remaining_seeds[NUM_ROWS][NUM_COLS];
+};
+
 class MatchBox
 {
 public:
 	MatchBox();
+    static MovePosition sample_seeds(const MatchBoxSeeds & seeds, uint32_t random_number);
+
     MatchBox(const Grid grid);
+    MatchBox(const Grid grid, size_t index);
     MatchBox(const MatchBox & other);
     void operator=(const MatchBox & other);
     MovePosition pick_random_move();
+    MovePosition sample_move(uint32_t random_number) const;
     Grid get_grid() const;
+    size_t index() const;
+    MatchBoxSeeds get_seeds() const;
+    void set_seeds(const MatchBoxSeeds & seeds);
+    int8_t remaining_seeds(MovePosition move_position) const;
     void reward_drawn_move(MovePosition move_position);
     void reward_move(MovePosition move_position);
     void punish_move(MovePosition move_position);
+    void apply_seed_delta(MovePosition move_position, int32_t rewards, int32_t punishments);
 private:
     void _print_remaining_seeds() const;
     Grid _grid;
+    size_t _index;
     int8_t _remaining_seeds[NUM_ROWS][NUM_COLS];
 };
 
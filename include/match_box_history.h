@@ -0,0 +1,29 @@
+#ifndef MATCH_BOX_HISTORY_H
+#define MATCH_BOX_HISTORY_H
+
+#include <cstddef>
+#include <vector>
+
+#include "constants.h"
+
+class MatchBox;
+
+// Moves picked by the bot during one game, kept by the caller so that one
+// GameBot can serve many sessions at once.
+class MatchBoxHistory
+{
+public:
+    MatchBoxHistory();
+    void clear();
+    void record_move(MatchBox * match_box, MovePosition move_position);
+    void append(const MatchBoxHistory & other);
+    size_t size() const;
+    bool empty() const;
+    MatchBox * match_box(size_t index) const;
+    MovePosition move_position(size_t index) const;
+private:
+    std::vector<MatchBox *> _match_boxes;
+    std::vector<MovePosition> _move_positions;
+};
+
+#endif // MATCH_BOX_HISTORY_H
@@ -0,0 +1,88 @@
+#ifndef MCTS_BOT_H
+#define MCTS_BOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "constants.h"
+#include "grid.h"
+#include "task_scheduler.h"
+
+class GameBot;
+
+enum class MctsParallelism {
+    ROOT = 0,
+    TREE = 1,
+};
+
+struct MctsConfig {
+    size_t num_threads;
+    size_t num_iterations;
+    MctsParallelism parallelism;
+    float exploration;
+    uint32_t virtual_loss;
+    size_t arena_capacity;
+    uint64_t seed;
+};
+
+struct MctsStatistics {
+    uint64_t iterations;
+    size_t nodes_allocated;
+};
+
+// Statistics are updated with relaxed atomics so that tree-parallel workers
+// never take a lock. score counts half points for the player who moved into
+// the node: 2 per win, 1 per draw.
+struct MctsNode {
+    std::atomic<MctsNode *> children;
+    std::atomic<bool> expanding;
+    std::atomic<uint32_t> visits;
+    std::atomic<uint32_t> virtual_losses;
+    std::atomic<uint64_t> score;
+    float prior;
+    uint8_t num_children;
+    int8_t row;
+    int8_t col;
+    Move player;
+};
+
+// Bump allocator over a fixed block of nodes, reset before every search.
+class MctsNodeArena
+{
+public:
+    explicit MctsNodeArena(size_t capacity);
+    void reset();
+    MctsNode * allocate(size_t num_nodes);
+    size_t size() const;
+private:
+    std::unique_ptr<MctsNode[]> _nodes;
+    size_t _capacity;
+    std::atomic<size_t> _size;
+};
+
+class MctsBot
+{
+public:
+    static MctsConfig default_config();
+
+    explicit MctsBot(const MctsConfig & config, TaskScheduler & scheduler = TaskScheduler::instance());
+    void set_prior_bot(GameBot * prior_bot);
+    bool get_next_move(const Grid & grid, MovePosition & position);
+    MctsStatistics get_statistics() const;
+private:
+    void _run_iterations(const Grid & root_grid, MctsNode * root, MctsNodeArena & arena, size_t num_iterations, uint64_t seed);
+    bool _expand(const Grid & grid, MctsNode * node, Move player, MctsNodeArena & arena);
+    MctsNode * _select_child(MctsNode * node) const;
+    Move _rollout(Grid & grid, Move player, uint64_t & random_state) const;
+    void _initialise_node(MctsNode * node, int8_t row, int8_t col, Move player, float prior) const;
+
+    MctsConfig _config;
+    TaskScheduler & _scheduler;
+    GameBot * _prior_bot;
+    std::vector<std::unique_ptr<MctsNodeArena>> _arenas;
+    std::atomic<uint64_t> _iterations;
+};
+
+#endif // MCTS_BOT_H
@@ -0,0 +1,133 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Latency histograms and counters for the hot paths. Every thread records
+// into its own slots without locks; readers sum the slots of all threads.
+// Build with DEFINES += ENABLE_METRICS to turn them on, otherwise the
+// METRICS_* macros compile to nothing.
+
+enum class MetricTimer {
+    GRID_GAME_STATE = 0,
+    GAME_BOT_FIND_MATCH_BOX,
+    GAME_BOT_GET_NEXT_MOVE,
+    GAME_BOT_FINISH_GAME,
+    GAME_BOT_LOAD_MOVE_HISTORY,
+    STATISTICS_SAVE_GAME_MOVES,
+    NUM_TIMERS
+};
+
+#define STR_METRIC_TIMER(t) (\
+    t == MetricTimer::GRID_GAME_STATE ? "grid_game_state" :\
+    t == MetricTimer::GAME_BOT_FIND_MATCH_BOX ? "game_bot_find_match_box" :\
+    t == MetricTimer::GAME_BOT_GET_NEXT_MOVE ? "game_bot_get_next_move" :\
+    t == MetricTimer::GAME_BOT_FINISH_GAME ? "game_bot_finish_game" :\
+    t == MetricTimer::GAME_BOT_LOAD_MOVE_HISTORY ? "game_bot_load_move_history" :\
+    t == MetricTimer::STATISTICS_SAVE_GAME_MOVES ? "statistics_save_game_moves" :\
+    "unknown")
+
+enum class MetricCounter {
+    GAME_BOT_MATCH_BOX_MISSES = 0,
+    GAME_BOT_REPLAYED_MOVES,
+    GAME_BOT_FINISHED_GAMES,
+    NUM_COUNTERS
+};
+
+#define STR_METRIC_COUNTER(c) (\
+    c == MetricCounter::GAME_BOT_MATCH_BOX_MISSES ? "game_bot_match_box_misses" :\
+    c == MetricCounter::GAME_BOT_REPLAYED_MOVES ? "game_bot_replayed_moves" :\
+    c == MetricCounter::GAME_BOT_FINISHED_GAMES ? "game_bot_finished_games" :\
+    "unknown")
+
+// Log-linear buckets in the style of HDR histograms: values below
+// 2^METRICS_SUB_BUCKET_BITS ns get a bucket each, larger values keep
+// METRICS_SUB_BUCKET_BITS significant bits (about 3% relative error) up to
+// 2^METRICS_MAX_EXPONENT ns. Buckets are closed at the top, like Prometheus
+// le buckets, so every power of two ends a bucket and count_at_most() is
+// exact there.
+#define METRICS_SUB_BUCKET_BITS (5)
+#define METRICS_SUB_BUCKET_COUNT (1 << METRICS_SUB_BUCKET_BITS)
+#define METRICS_MAX_EXPONENT (40)
+#define METRICS_NUM_BUCKETS ((METRICS_MAX_EXPONENT - METRICS_SUB_BUCKET_BITS + 2) * METRICS_SUB_BUCKET_COUNT)
+
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+    void record(uint64_t nanoseconds);
+    void add(const LatencyHistogram & other);
+    uint64_t count() const;
+    uint64_t sum() const;
+    uint64_t count_at_most(uint64_t nanoseconds) const;
+    uint64_t percentile(double percentile) const;
+    static size_t bucket_index(uint64_t nanoseconds);
+    static uint64_t bucket_upper_bound(size_t bucket_index);
+private:
+    // Written by the owning thread only, so relaxed load + store is enough.
+    std::atomic<uint64_t> _buckets[METRICS_NUM_BUCKETS];
+    std::atomic<uint64_t> _count;
+    std::atomic<uint64_t> _sum;
+};
+
+class Metrics
+{
+public:
+    static void record_time(MetricTimer timer, uint64_t nanoseconds);
+    static void add_to_counter(MetricCounter counter, uint64_t value);
+    static void get_histogram(MetricTimer timer, LatencyHistogram & histogram);
+    static uint64_t get_counter(MetricCounter counter);
+    static bool write_prometheus(const std::string & filename);
+    static void print();
+};
+
+class ScopedMetricTimer
+{
+public:
+    explicit ScopedMetricTimer(MetricTimer timer);
+    ~ScopedMetricTimer();
+    ScopedMetricTimer(const ScopedMetricTimer & other) = delete;
+    void operator=(const ScopedMetricTimer & other) = delete;
+private:
+    MetricTimer _timer;
+    std::chrono::steady_clock::time_point _start;
+};
+
+// Writes Metrics::write_prometheus() to a file at a fixed interval from a
+// background thread, and once more when destroyed.
+class MetricsExporter
+{
+public:
+    MetricsExporter(const std::string & filename, std::chrono::milliseconds interval);
+    ~MetricsExporter();
+    MetricsExporter(const MetricsExporter & other) = delete;
+    void operator=(const MetricsExporter & other) = delete;
+private:
+    void _export_loop();
+
+    std::string _filename;
+    std::chrono::milliseconds _interval;
+    std::mutex _mutex;
+    std::condition_variable _stop_condition;
+    bool _stopping;
+    std::thread _thread;
+};
+
+#define METRICS_CONCAT_INNER(a, b) a##b
+#define METRICS_CONCAT(a, b) METRICS_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_METRICS
+#define METRICS_SCOPED_TIMER(timer) ScopedMetricTimer METRICS_CONCAT(_scoped_metric_timer_, __LINE__)(timer)
+#define METRICS_COUNTER_ADD(counter, value) Metrics::add_to_counter(counter, value)
+#else
+#define METRICS_SCOPED_TIMER(timer) do {} while (false)
+#define METRICS_COUNTER_ADD(counter, value) do {} while (false)
+#endif
+
+#endif // METRICS_H
@@ -0,0 +1,15 @@
+#ifndef MOVE_ORDERING_H
+#define MOVE_ORDERING_H
+
+#include <cstdint>
+
+#include "constants.h"
+#include "grid.h"
+
+// Fills positions with the empty cells of grid, best candidates first:
+// the hinted move (e.g. from a transposition table), moves that win on the
+// spot, moves that block an immediate win of the opponent, then the
+// centre, corners and edges. Returns the number of positions written.
+size_t order_moves(const Grid & grid, Move player, MovePosition hint, MovePosition positions[MAX_RANK]);
+
+#endif // MOVE_ORDERING_H
@@ -0,0 +1,68 @@
+#ifndef NTUPLE_NETWORK_H
+#define NTUPLE_NETWORK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "constants.h"
+#include "grid.h"
+
+// Longest tuple, so a lookup table has at most 3^4 entries.
+#define NTUPLE_MAX_TUPLE_SIZE (4)
+// Positions evaluated side by side, one per 32-bit SIMD lane.
+#define NTUPLE_BATCH_SIZE (8)
+#define NTUPLE_DEFAULT_LEARNING_RATE (0.1f)
+// Search score of a value of 1, well inside SEARCH_WIN_SCORE.
+#define NTUPLE_SEARCH_SCALE (100)
+
+// Value function over Grid cells: the sum, over a fixed set of cell tuples,
+// of one weight picked by the contents of each tuple. Every row, 2x2 square
+// and the main diagonal is a base tuple, and all its images under the grid
+// symmetries read the same lookup table, so what is learnt in one corner
+// holds in the others. Cells are seen as empty, own or opponent's, which
+// makes the value the expected outcome (-1 .. 1) for one player and lets
+// games started by either side train the same weights.
+//
+// All lookup tables are one contiguous float array. evaluate_batch() works
+// on NTUPLE_BATCH_SIZE positions at once, computing their table indices in
+// vector lanes and fetching the weights with AVX2 gathers where the CPU has
+// them, plain loops elsewhere.
+//
+// train_game() is a TD(0) pass over the afterstates one side left during a
+// game and may be called from several threads at once. Evaluation reads the
+// weights without locking, so it must not overlap training.
+class NTupleNetwork
+{
+public:
+    NTupleNetwork();
+    size_t num_tuples() const;
+    size_t num_weights() const;
+    void set_learning_rate(float learning_rate);
+    float evaluate(const Grid & grid, Move player) const;
+    void evaluate_batch(const Grid * grids, const Move * players, float * values, size_t num_grids) const;
+    void evaluate_batch_scalar(const Grid * grids, const Move * players, float * values, size_t num_grids) const;
+    bool select_move(const Grid & grid, MovePosition & position) const;
+    void train_game(const std::vector<Grid> & afterstates, Move player, float outcome);
+    bool save(const std::string & filename) const;
+    bool load(const std::string & filename);
+private:
+    void _add_tuple(const std::vector<MovePosition> & cells);
+    void _encode(const Grid * grids, const Move * players, size_t num_grids, int32_t states[MAX_RANK][NTUPLE_BATCH_SIZE]) const;
+    void _evaluate_lanes(const int32_t states[MAX_RANK][NTUPLE_BATCH_SIZE], float sums[NTUPLE_BATCH_SIZE], bool use_simd) const;
+    void _evaluate_batch(const Grid * grids, const Move * players, float * values, size_t num_grids, bool use_simd) const;
+    void _update(const Grid & grid, Move player, float delta);
+
+    // Per tuple instance: its cells as row * NUM_COLS + col, padded to
+    // NTUPLE_MAX_TUPLE_SIZE, and where its lookup table starts.
+    std::vector<int32_t> _tuple_cells;
+    std::vector<int32_t> _tuple_sizes;
+    std::vector<int32_t> _tuple_offsets;
+    std::vector<float> _weights;
+    float _learning_rate;
+    std::mutex _train_mutex;
+};
+
+#endif // NTUPLE_NETWORK_H
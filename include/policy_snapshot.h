@@ -0,0 +1,84 @@
+#ifndef POLICY_SNAPSHOT_H
+#define POLICY_SNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "constants.h"
+#include "match_box.h"
+
+#define POLICY_STORE_NUM_READER_SLOTS (256)
+
+// Immutable copy of every match box's seeds, indexed by MatchBox::index().
+class PolicySnapshot
+{
+public:
+    PolicySnapshot(uint64_t version, std::vector<MatchBoxSeeds> seeds);
+    uint64_t version() const;
+    size_t size() const;
+    const MatchBoxSeeds & seeds(size_t index) const;
+    MovePosition sample_move(size_t index, uint32_t random_number) const;
+private:
+    uint64_t _version;
+    std::vector<MatchBoxSeeds> _seeds;
+};
+
+// Read-copy-update holder of the current PolicySnapshot. Readers announce
+// the epoch they started in and load the current pointer; they never lock
+// or wait. Writers swap in a new snapshot and free an old one only once
+// every reader that could still see it has finished.
+class PolicyStore
+{
+public:
+    explicit PolicyStore(PolicySnapshot * snapshot);
+    ~PolicyStore();
+    PolicyStore(const PolicyStore & other) = delete;
+    void operator=(const PolicyStore & other) = delete;
+
+    void publish(PolicySnapshot * snapshot);
+    size_t reclaim();
+    uint64_t version() const;
+private:
+    friend class PolicyReadGuard;
+
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch;
+    };
+
+    struct RetiredSnapshot {
+        PolicySnapshot * snapshot;
+        uint64_t retire_epoch;
+    };
+
+    size_t _pin(const PolicySnapshot * & snapshot);
+    void _unpin(size_t slot_index);
+    size_t _reclaim_retired();
+    uint64_t _min_active_epoch() const;
+
+    std::atomic<PolicySnapshot *> _current;
+    std::atomic<uint64_t> _epoch;
+    ReaderSlot _reader_slots[POLICY_STORE_NUM_READER_SLOTS];
+    std::mutex _writer_mutex;
+    std::vector<RetiredSnapshot> _retired;
+};
+
+// Pins the current snapshot for the lifetime of the guard.
+class PolicyReadGuard
+{
+public:
+    explicit PolicyReadGuard(PolicyStore & store);
+    ~PolicyReadGuard();
+    PolicyReadGuard(const PolicyReadGuard & other) = delete;
+    void operator=(const PolicyReadGuard & other) = delete;
+
+    const PolicySnapshot & snapshot() const;
+private:
+    PolicyStore & _store;
+    const PolicySnapshot * _snapshot;
+    size_t _slot_index;
+};
+
+#endif // POLICY_SNAPSHOT_H
@@ -0,0 +1,66 @@
+#ifndef PONDERER_H
+#define PONDERER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "constants.h"
+#include "game_bot.h"
+#include "grid.h"
+#include "match_box_history.h"
+
+// Bot reply worked out ahead of time for one human move.
+struct PonderedReply {
+    Grid grid;
+    MovePosition position;
+    bool valid_position;
+    MatchBoxHistory history;
+};
+
+// Background worker that asks the GameBot for its reply to every legal
+// human move while the human is thinking. Replies are cached by the hash
+// of the grid after the human move. Work is tagged with a generation that
+// cancel() and start() bump, so stale work is dropped, and those calls, like
+// take_reply(), raise the GameBot's search stop flag so that a search still
+// running for a stale reply returns at its next poll instead of using up
+// its budget.
+//
+// The worker is the only caller of the GameBot while pondering; callers
+// must let take_reply() or cancel() return before using the GameBot
+// themselves.
+class Ponderer
+{
+public:
+    explicit Ponderer(GameBot & game_bot);
+    ~Ponderer();
+    Ponderer(const Ponderer & other) = delete;
+    void operator=(const Ponderer & other) = delete;
+
+    void start(const Grid & grid);
+    void cancel();
+    bool take_reply(const Grid & grid, MovePosition & position, MatchBoxHistory & history);
+    size_t num_replies();
+private:
+    void _worker_loop();
+    void _stop_and_wait_until_idle(std::unique_lock<std::mutex> & lock);
+
+    GameBot & _game_bot;
+    std::mutex _mutex;
+    std::condition_variable _work_condition;
+    std::condition_variable _idle_condition;
+    Grid _grid;
+    uint64_t _generation;
+    bool _has_work;
+    bool _busy;
+    bool _stopping;
+    std::atomic<bool> _stop_search;
+    std::unordered_map<uint64_t, std::vector<PonderedReply>> _replies;
+    std::thread _thread;
+};
+
+#endif // PONDERER_H
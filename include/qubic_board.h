@@ -0,0 +1,72 @@
+#ifndef QUBIC_BOARD_H
+#define QUBIC_BOARD_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "constants.h"
+#include "qubic_symmetry.h"
+
+#define QUBIC_NUM_LINES (76)
+// Most lines through one cell: the corners and the eight centre cells.
+#define QUBIC_MAX_LINES_PER_CELL (7)
+
+// A mark in cell x + 4 * y + 16 * z.
+struct QubicMove {
+    uint8_t cell;
+
+    bool operator==(const QubicMove & other) const {
+        return cell == other.cell;
+    }
+    bool operator!=(const QubicMove & other) const {
+        return !(*this == other);
+    }
+};
+
+constexpr QubicMove QUBIC_NO_MOVE = {QUBIC_NUM_CELLS};
+
+// 4x4x4 tic-tac-toe: four in a line along any of the 76 rows, columns,
+// pillars and diagonals wins. Each side is one 64-bit word. Per-line mark
+// counts are updated on every move, so the outcome, the open three-in-a-line
+// threats of each side and the line evaluation never rescan the cube.
+//
+// The board also keeps its Zobrist hash under each of the 48 cube
+// symmetries, so canonical_hash() is the same for every symmetric position.
+class QubicBoard
+{
+public:
+    static uint64_t line_mask(size_t line);
+
+    QubicBoard();
+    explicit QubicBoard(Move first_player_move);
+    void reset();
+    Move value(size_t cell) const;
+    uint64_t cells(Move move) const;
+    uint64_t empty_cells() const;
+    Move first_player() const;
+    Move next_player() const;
+    GameState game_state() const;
+    bool has_game_ended() const;
+    size_t rank() const;
+    size_t num_threats(Move move) const;
+    uint64_t threat_cells(Move move) const;
+    int32_t line_score(Move move) const;
+    bool is_legal_move(const QubicMove & move) const;
+    void make_move(const QubicMove & move);
+    void unmake_move(const QubicMove & move);
+    uint64_t hash() const;
+    uint64_t canonical_hash(QubicTransformation & qubic_transformation) const;
+    void print_board() const;
+private:
+    uint64_t _cells[2];
+    uint8_t _line_counts[2][QUBIC_NUM_LINES];
+    size_t _num_threats[2];
+    // Sum over lines open for one side only of the squared mark count, positive for CROSS.
+    int32_t _line_score;
+    uint64_t _hashes[NUM_QUBIC_SYMMETRIES];
+    size_t _rank;
+    Move _first_player;
+    GameState _game_state;
+};
+
+#endif // QUBIC_BOARD_H
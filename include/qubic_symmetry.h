@@ -0,0 +1,40 @@
+#ifndef QUBIC_SYMMETRY_H
+#define QUBIC_SYMMETRY_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define QUBIC_SIZE (4)
+#define QUBIC_NUM_CELLS ((QUBIC_SIZE) * (QUBIC_SIZE) * (QUBIC_SIZE))
+#define NUM_QUBIC_SYMMETRIES (48)
+
+// A symmetry of the 4x4x4 cube, numbered axis_permutation * 8 + reflections:
+// the coordinates are permuted first, then axis i is reflected if bit i of
+// the reflections is set. Cell x + 4 * y + 16 * z of the cube holds
+// coordinates (x, y, z). This is the 3D counterpart of GridTransformation,
+// with QUBIC_TRANSFORMATION_EQUAL and QUBIC_TRANSFORMATION_UNEQUAL playing the
+// roles of GRID_EQUAL and GRID_UNEQUAL.
+typedef uint8_t QubicTransformation;
+
+#define QUBIC_TRANSFORMATION_EQUAL (0)
+#define QUBIC_TRANSFORMATION_UNEQUAL (NUM_QUBIC_SYMMETRIES)
+
+// targets[t][cell] is the cell that cell moves to under t, sources[t] is the
+// inverse mapping.
+struct QubicSymmetryTable {
+    uint8_t targets[NUM_QUBIC_SYMMETRIES][QUBIC_NUM_CELLS];
+    uint8_t sources[NUM_QUBIC_SYMMETRIES][QUBIC_NUM_CELLS];
+};
+
+extern const QubicSymmetryTable QUBIC_SYMMETRY_TABLE;
+
+uint64_t transform_qubic_cells(uint64_t cells, QubicTransformation qubic_transformation);
+// The transformation that maps the first pair of bitboards onto the second,
+// or QUBIC_TRANSFORMATION_UNEQUAL. Like GameBot::_get_grid_transformation(),
+// lower numbered transformations win when several apply.
+QubicTransformation find_qubic_transformation(uint64_t crosses, uint64_t noughts, uint64_t other_crosses, uint64_t other_noughts);
+// Replaces the bitboards with their smallest image, crosses compared first,
+// and returns the transformation that produced it.
+QubicTransformation canonical_qubic_cells(uint64_t & crosses, uint64_t & noughts);
+
+#endif // QUBIC_SYMMETRY_H
@@ -0,0 +1,27 @@
+#ifndef SEARCH_ADAPTERS_H
+#define SEARCH_ADAPTERS_H
+
+#include <cstddef>
+
+#include "constants.h"
+#include "grid.h"
+#include "move_ordering.h"
+
+// The templated searches (AnytimeSearch, LazySmpSearch) play and order moves
+// through search_make_move(), search_unmake_move() and search_order_moves()
+// overloads, one set per board type. These are the Grid ones, shared by all
+// searches; other boards keep theirs next to the search that uses them.
+inline void search_make_move(Grid & grid, const MovePosition & position, Move player) {
+    grid.make_move(position.first, position.second, player);
+}
+
+inline void search_unmake_move(Grid & grid, const MovePosition & position) {
+    grid.unmake_move(position.first, position.second);
+}
+
+// positions holds at least MAX_RANK entries.
+inline size_t search_order_moves(const Grid & grid, Move player, MovePosition hint, MovePosition * positions) {
+    return order_moves(grid, player, hint, positions);
+}
+
+#endif // SEARCH_ADAPTERS_H
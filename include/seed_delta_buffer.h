@@ -0,0 +1,39 @@
+#ifndef SEED_DELTA_BUFFER_H
+#define SEED_DELTA_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "constants.h"
+
+// Seeds gained and lost by one match box cell. Kept apart so that the merge
+// can apply the punish_move floor once, after all the rewards.
+struct SeedDelta {
+    uint16_t rewards[NUM_ROWS][NUM_COLS];
+    uint16_t punishments[NUM_ROWS][NUM_COLS];
+};
+
+// Match box updates of one training thread, keyed by match box index, that
+// are folded into the shared match boxes by GameBot::merge_seed_deltas().
+// A buffer is only ever touched by the thread that owns it.
+class SeedDeltaBuffer
+{
+public:
+    SeedDeltaBuffer();
+    void clear();
+    void reward(size_t match_box_index, MovePosition move_position, uint16_t seeds);
+    void punish(size_t match_box_index, MovePosition move_position, uint16_t seeds);
+    void finish_game();
+    size_t num_games() const;
+    bool empty() const;
+    const SeedDelta * find(size_t match_box_index) const;
+private:
+    SeedDelta & _delta(size_t match_box_index);
+
+    std::unordered_map<size_t, SeedDelta> _deltas;
+    size_t _num_games;
+};
+
+#endif // SEED_DELTA_BUFFER_H
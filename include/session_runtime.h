@@ -0,0 +1,165 @@
+#ifndef SESSION_RUNTIME_H
+#define SESSION_RUNTIME_H
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "constants.h"
+#include "game_bot.h"
+#include "grid.h"
+#include "match_box_history.h"
+#include "task_scheduler.h"
+
+#define SESSION_DEFAULT_NUM_EVENT_LOOPS (2)
+// Coroutine frames up to this size come from SessionFramePool, bigger ones
+// from the global heap.
+#define SESSION_FRAME_BLOCK_SIZE (512)
+#define SESSION_FRAMES_PER_CHUNK (1024)
+// Finished games between two policy snapshots seen by the sessions.
+#define SESSION_POLICY_PUBLISH_INTERVAL (256)
+
+// Free list of fixed-size blocks for session coroutine frames, carved out
+// of chunks that are kept until the process exits. Opening and closing a
+// session costs a pop and a push instead of a heap allocation.
+class SessionFramePool
+{
+public:
+    static SessionFramePool & instance();
+
+    void * allocate(size_t size);
+    void deallocate(void * frame, size_t size);
+    size_t num_allocated() const;
+    size_t max_frame_size() const;
+private:
+    SessionFramePool();
+
+    struct FreeBlock {
+        FreeBlock * next;
+    };
+
+    mutable std::mutex _mutex;
+    FreeBlock * _free_blocks;
+    std::vector<std::unique_ptr<char[]>> _chunks;
+    size_t _num_allocated;
+    size_t _max_frame_size;
+};
+
+// Coroutine type of one session. It starts suspended, so the event loop
+// that owns the session decides when it first runs, and stays suspended at
+// the end until the loop destroys it.
+class SessionTask
+{
+public:
+    struct promise_type {
+        SessionTask get_return_object() noexcept;
+        std::suspend_always initial_suspend() noexcept;
+        std::suspend_always final_suspend() noexcept;
+        void return_void() noexcept;
+        void unhandled_exception() noexcept;
+
+        static void * operator new(size_t size);
+        static void operator delete(void * frame, size_t size);
+    };
+
+    std::coroutine_handle<promise_type> handle() const;
+private:
+    explicit SessionTask(std::coroutine_handle<promise_type> handle);
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
+// Called on the event loop thread of the session, so they must not block.
+// move_requested() hands over the grid a client move is wanted for.
+struct SessionCallbacks {
+    std::function<void(uint64_t session_id, const Grid & grid)> move_requested;
+    std::function<void(uint64_t session_id, MovePosition position)> bot_moved;
+    std::function<void(uint64_t session_id, GameState game_state)> game_finished;
+};
+
+// Serves many concurrent games with one shared GameBot. Every session is a
+// coroutine that awaits the next client move, then the bot move, and once
+// the game is over the commit of its log; while it waits it holds no
+// thread, only its coroutine frame (a few hundred bytes, see
+// session_size()).
+//
+// Sessions live on a small number of event loop threads, picked by session
+// id, and are only ever resumed there, so session state needs no locks.
+// Bot moves are computed on the TaskScheduler from the current policy
+// snapshot. Finished games are appended to the log file by one committer
+// thread in batches, one flush per batch, which also teaches them to the
+// GameBot. The GameBot must not be used elsewhere while the runtime exists.
+class SessionRuntime
+{
+public:
+    SessionRuntime(GameBot & game_bot, const std::string & log_filename, size_t num_event_loops = SESSION_DEFAULT_NUM_EVENT_LOOPS, TaskScheduler & scheduler = TaskScheduler::instance());
+    ~SessionRuntime();
+    SessionRuntime(const SessionRuntime & other) = delete;
+    void operator=(const SessionRuntime & other) = delete;
+
+    bool is_open() const;
+    void set_callbacks(const SessionCallbacks & callbacks);
+    uint64_t open_session(const PlayerRoles & player_roles = DEFAULT_PLAYER_ROLES);
+    void submit_move(uint64_t session_id, MovePosition position);
+    void wait_for_sessions();
+    size_t num_open_sessions() const;
+    uint64_t num_committed_games() const;
+    static size_t session_size();
+private:
+    struct Session;
+    struct EventLoop;
+    struct ClientMoveAwaiter;
+    struct BotMoveAwaiter;
+    struct LogCommitAwaiter;
+
+    enum class SessionEventType {
+        OPEN,
+        CLIENT_MOVE,
+        RESUME,
+    };
+
+    struct SessionEvent {
+        SessionEventType type;
+        uint64_t session_id;
+        PlayerRoles player_roles;
+        MovePosition position;
+        std::coroutine_handle<> handle;
+    };
+
+    SessionTask _run_session(uint64_t session_id, PlayerRoles player_roles);
+    void _post(uint64_t session_id, const SessionEvent & event);
+    void _event_loop(EventLoop & loop);
+    void _handle_event(EventLoop & loop, const SessionEvent & event);
+    void _resume(std::coroutine_handle<> handle);
+    void _committer_loop();
+    void _write_game(const Session & session);
+
+    GameBot & _game_bot;
+    SessionCallbacks _callbacks;
+    std::vector<std::unique_ptr<EventLoop>> _loops;
+    std::atomic<uint64_t> _next_session_id;
+    mutable std::mutex _sessions_mutex;
+    std::condition_variable _sessions_condition;
+    size_t _num_open_sessions;
+    TaskGroup _bot_move_tasks;
+
+    FILE * _log_file;
+    std::mutex _commit_mutex;
+    std::condition_variable _commit_condition;
+    std::vector<Session *> _pending_commits;
+    bool _stopping;
+    std::atomic<uint64_t> _num_committed_games;
+    std::thread _committer_thread;
+};
+
+#endif // SESSION_RUNTIME_H
@@ -0,0 +1,61 @@
+#ifndef SHARED_POLICY_SEGMENT_H
+#define SHARED_POLICY_SEGMENT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "constants.h"
+#include "match_box.h"
+
+#define SHARED_POLICY_DEFAULT_NAME "/tictactoe_policy"
+
+// Match box seeds shared by several processes on one host through a POSIX
+// shared-memory segment. The seeds are a flat array indexed by
+// canonical_grid_index(), one byte per cell in the canonical frame, so
+// every process finds a position at the same place without any table.
+//
+// One coordinator creates the segment, fills in the starting seeds and
+// checkpoints it to disk; trainers open it and fold their seed deltas in
+// with atomic saturating adds. A trainer that crashes loses only the deltas
+// it had not merged yet.
+class SharedPolicySegment
+{
+public:
+    SharedPolicySegment();
+    ~SharedPolicySegment();
+    SharedPolicySegment(const SharedPolicySegment & other) = delete;
+    void operator=(const SharedPolicySegment & other) = delete;
+
+    static bool remove(const std::string & name);
+
+    bool create(const std::string & name);
+    bool open(const std::string & name);
+    void close();
+    bool is_open() const;
+    void mark_ready();
+
+    uint64_t num_positions() const;
+    int8_t seeds(uint64_t position_index, size_t cell) const;
+    void set_seeds(uint64_t position_index, size_t cell, int8_t seeds);
+    void apply_seed_delta(uint64_t position_index, size_t cell, int32_t rewards, int32_t punishments);
+
+    uint64_t version() const;
+    uint64_t num_games() const;
+    uint64_t checkpoint_version() const;
+    void finish_merge(uint64_t num_games);
+    void set_checkpoint_version(uint64_t version);
+private:
+    struct Header;
+
+    std::atomic<int8_t> & _seeds(uint64_t position_index, size_t cell) const;
+    bool _map(int file_descriptor, bool initialize);
+
+    void * _mapping;
+    size_t _mapping_size;
+    Header * _header;
+    std::atomic<int8_t> * _seed_array;
+};
+
+#endif // SHARED_POLICY_SEGMENT_H
@@ -0,0 +1,77 @@
+#ifndef SPARSE_BOARD_H
+#define SPARSE_BOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "constants.h"
+#include "sparse_cell_table.h"
+
+#define SPARSE_DEFAULT_WIN_LENGTH (5)
+#define SPARSE_MAX_WIN_LENGTH (8)
+// Candidate moves are the empty cells at most this many steps (in any
+// direction) from a stone.
+#define SPARSE_CANDIDATE_RADIUS (2)
+
+struct SparseMove {
+    int32_t x;
+    int32_t y;
+
+    bool operator==(const SparseMove & other) const {
+        return x == other.x && y == other.y;
+    }
+    bool operator!=(const SparseMove & other) const {
+        return !(*this == other);
+    }
+};
+
+constexpr SparseMove SPARSE_NO_MOVE = {INT32_MIN, INT32_MIN};
+
+// Gomoku-style board without edges: win_length stones in a row, column or
+// diagonal win. Only the stones are stored, in an open-addressing table, so
+// memory follows the number of stones rather than the board size.
+//
+// make_move() and unmake_move() only look at the 4 * (2 * win_length - 1)
+// cells on the lines through the move. From those they update the outcome,
+// the number of windows each side is one stone short of filling (threats), a
+// line evaluation over every win_length window, and the candidate moves
+// near the stones.
+class SparseBoard
+{
+public:
+    explicit SparseBoard(size_t win_length = SPARSE_DEFAULT_WIN_LENGTH, Move first_player_move = DEFAULT_FIRST_PLAYER_MOVE);
+    void reset();
+    Move value(int32_t x, int32_t y) const;
+    size_t win_length() const;
+    Move first_player() const;
+    Move next_player() const;
+    GameState game_state() const;
+    bool has_game_ended() const;
+    size_t rank() const;
+    size_t num_threats(Move move) const;
+    int32_t line_score(Move move) const;
+    bool is_legal_move(const SparseMove & move) const;
+    void generate_moves(std::vector<SparseMove> & moves) const;
+    void make_move(const SparseMove & move);
+    void unmake_move(const SparseMove & move);
+    uint64_t hash() const;
+    void print_board() const;
+private:
+    void _update_lines(const SparseMove & move, Move player, int32_t sign);
+    void _update_candidates(const SparseMove & move, int32_t sign);
+
+    size_t _win_length;
+    SparseCellTable<Move> _stones;
+    // Number of stones within SPARSE_CANDIDATE_RADIUS of each cell that has any.
+    SparseCellTable<uint16_t> _neighbour_counts;
+    size_t _num_threats[2];
+    // Sum over windows open for one side only of the squared stone count, positive for CROSS.
+    int32_t _line_score;
+    uint64_t _hash;
+    size_t _rank;
+    Move _first_player;
+    GameState _game_state;
+};
+
+#endif // SPARSE_BOARD_H
@@ -0,0 +1,142 @@
+#ifndef SPARSE_CELL_TABLE_H
+#define SPARSE_CELL_TABLE_H
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+// Open-addressing hash map from (x, y) board coordinates to a Value, with
+// linear probing. Erased slots are refilled by shifting the rest of their
+// probe run back, so lookups never wade through tombstones and their cost
+// depends only on the load factor, which is kept at or below one half.
+template <typename Value>
+class SparseCellTable
+{
+public:
+    explicit SparseCellTable(size_t capacity_log2 = 6) :
+        _slots(size_t(1) << capacity_log2),
+        _size(0)
+    {
+
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    void clear() {
+        for (Slot & slot : _slots) {
+            slot.used = false;
+        }
+        _size = 0;
+    }
+
+    Value * find(int32_t x, int32_t y) {
+        Slot & slot = _slots[_find_slot(_key(x, y))];
+        return slot.used ? &slot.value : nullptr;
+    }
+
+    const Value * find(int32_t x, int32_t y) const {
+        const Slot & slot = _slots[_find_slot(_key(x, y))];
+        return slot.used ? &slot.value : nullptr;
+    }
+
+    // The value at (x, y), inserted as default_value if there is none yet.
+    Value & find_or_insert(int32_t x, int32_t y, Value default_value) {
+        uint64_t key = _key(x, y);
+        size_t index = _find_slot(key);
+        if (!_slots[index].used) {
+            if (2 * (_size + 1) > _slots.size()) {
+                _grow();
+                index = _find_slot(key);
+            }
+            _slots[index].key = key;
+            _slots[index].value = default_value;
+            _slots[index].used = true;
+            ++_size;
+        }
+        return _slots[index].value;
+    }
+
+    bool erase(int32_t x, int32_t y) {
+        size_t mask = _slots.size() - 1;
+        size_t index = _find_slot(_key(x, y));
+        if (!_slots[index].used) {
+            return false;
+        }
+        // Backward shift: move later members of the run into the hole when
+        // their home slot does not lie between the hole and themselves.
+        size_t next = index;
+        while (true) {
+            next = (next + 1) & mask;
+            if (!_slots[next].used) {
+                break;
+            }
+            size_t home = _hash(_slots[next].key) & mask;
+            bool stays = index <= next ? (index < home && home <= next) : (index < home || home <= next);
+            if (!stays) {
+                _slots[index] = _slots[next];
+                index = next;
+            }
+        }
+        _slots[index].used = false;
+        --_size;
+        return true;
+    }
+
+    // Calls function(x, y, value) for every entry, in no particular order.
+    template <typename Function>
+    void for_each(Function function) const {
+        for (const Slot & slot : _slots) {
+            if (slot.used) {
+                function(static_cast<int32_t>(slot.key >> 32), static_cast<int32_t>(slot.key & UINT32_MAX), slot.value);
+            }
+        }
+    }
+private:
+    struct Slot {
+        uint64_t key;
+        Value value;
+        bool used = false;
+    };
+
+    static uint64_t _key(int32_t x, int32_t y) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    static uint64_t _hash(uint64_t key) {
+        // splitmix64 finaliser, nearby coordinates land far apart.
+        key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+        return key ^ (key >> 31);
+    }
+
+    // The slot holding key, or the empty slot where it would go.
+    size_t _find_slot(uint64_t key) const {
+        size_t mask = _slots.size() - 1;
+        size_t index = _hash(key) & mask;
+        while (_slots[index].used && _slots[index].key != key) {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+
+    void _grow() {
+        std::vector<Slot> old_slots(2 * _slots.size());
+        old_slots.swap(_slots);
+        _size = 0;
+        for (const Slot & slot : old_slots) {
+            if (slot.used) {
+                size_t index = _find_slot(slot.key);
+                assert(!_slots[index].used);
+                _slots[index] = slot;
+                ++_size;
+            }
+        }
+    }
+
+    std::vector<Slot> _slots;
+    size_t _size;
+};
+
+#endif // SPARSE_CELL_TABLE_H
@@ -5,23 +5,30 @@
 #include <vector>
 
 #include "constants.h"
+#include "game_archive.h"
 
 class Statistics
 {
 public:
     explicit Statistics();
-    void start_new_game();
+    ~Statistics();
+    void start_new_game(const PlayerRoles & player_roles);
     void log_move(Move move, MovePosition move_position);
     void game_finished(GameState game_state);
-    void read_move_history(std::vector<std::vector<Move>> & move_history, std::vector<std::vector<MovePosition>> & move_position_history, std::vector<GameState> & game_state_history);
+    void read_move_history(std::vector<std::vector<Move>> & move_history, std::vector<std::vector<MovePosition>> & move_position_history, std::vector<GameState> & game_state_history, std::vector<PlayerRoles> & player_roles_history);
+    const GameArchive & get_game_archive() const;
 private:
-	GameOutcome _get_game_outcome_from_game_state(GameState game_state);
-	GameState _get_game_state_from_game_outcome(GameOutcome game_outcome);
+	GameOutcome _get_game_outcome_from_game_state(GameState game_state, Move player_move);
+	GameState _get_game_state_from_game_outcome(GameOutcome game_outcome, Move player_move);
 	void _save_game_moves(GameOutcome game_outcome);
-	void _read_game_moves(std::string game_log_filename, std::vector<Move> & moves, std::vector<MovePosition> & move_positions, GameState & game_state);
+	void _save_game_archive();
+	void _read_game_moves(std::string game_log_filename, std::vector<Move> & moves, std::vector<MovePosition> & move_positions, GameState & game_state, PlayerRoles & player_roles);
 
 	std::vector<Move> moves;
 	std::vector<MovePosition> move_positions;
+	PlayerRoles _player_roles;
+	GameArchive _game_archive;
+	size_t _num_unsaved_games;
 };
 
 #endif // STATISTICS_H
@@ -0,0 +1,64 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "constants.h"
+#include "grid.h"
+#include "task_scheduler.h"
+
+// Game-theoretic value of a position for the player to move.
+enum class TablebaseResult {
+    UNKNOWN = 0,
+    WIN = 1,
+    DRAW = 2,
+    LOSS = 3,
+};
+
+#define STR_TABLEBASE_RESULT(r) (\
+    r == TablebaseResult::UNKNOWN ? "UNKNOWN" :\
+    r == TablebaseResult::WIN ? "WIN" :\
+    r == TablebaseResult::DRAW ? "DRAW" :\
+    r == TablebaseResult::LOSS ? "LOSS" :\
+    "UNKNOWN")
+
+// Win/draw/loss table for every legal position of the compiled board size,
+// built by retrograde analysis one rank at a time from the full board back
+// to the empty one. Only canonical positions (see canonical_grid_index())
+// are filled in. The file keeps the results at 2 bits per position,
+// optionally followed by one distance-to-end byte per position, and is
+// memory-mapped when loaded.
+class Tablebase
+{
+public:
+    Tablebase();
+    ~Tablebase();
+    Tablebase(const Tablebase & other) = delete;
+    void operator=(const Tablebase & other) = delete;
+
+    void generate(TaskScheduler & scheduler = TaskScheduler::instance());
+    bool save(const std::string & filename, bool save_distances) const;
+    bool load(const std::string & filename);
+    void unload();
+    bool is_loaded() const;
+    bool has_distances() const;
+    uint64_t num_positions() const;
+    bool probe(const Grid & grid, TablebaseResult & result, uint8_t & distance) const;
+    bool get_best_move(const Grid & grid, MovePosition & position) const;
+private:
+    TablebaseResult _result(uint64_t index) const;
+    uint8_t _distance(uint64_t index) const;
+    void _solve_position(uint64_t index);
+
+    std::vector<uint8_t> _results;
+    std::vector<uint8_t> _distances;
+    const uint8_t * _mapped_results;
+    const uint8_t * _mapped_distances;
+    void * _mapping;
+    size_t _mapping_size;
+    uint64_t _num_positions;
+};
+
+#endif // TABLEBASE_H
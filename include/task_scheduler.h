@@ -0,0 +1,101 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "work_stealing_deque.h"
+
+class TaskGroup;
+
+struct WorkerStatistics {
+    uint64_t tasks_executed;
+    uint64_t tasks_stolen;
+    uint64_t steal_attempts;
+    uint64_t busy_ns;
+    uint64_t idle_ns;
+    double utilization;
+};
+
+// Pool of workers with one Chase-Lev deque each. Tasks spawned on a worker
+// go to the bottom of its own deque; idle workers take from the shared
+// injection queue (tasks submitted by other threads) and then steal from
+// the top of the other deques. Threads waiting on a TaskGroup run tasks
+// instead of blocking.
+class TaskScheduler
+{
+public:
+    static TaskScheduler & instance();
+
+    explicit TaskScheduler(size_t num_workers, bool pin_workers = false);
+    ~TaskScheduler();
+    TaskScheduler(const TaskScheduler & other) = delete;
+    void operator=(const TaskScheduler & other) = delete;
+
+    size_t num_workers() const;
+    void parallel_for(size_t begin, size_t end, size_t grain_size, const std::function<void(size_t, size_t)> & body);
+    std::vector<WorkerStatistics> get_worker_statistics() const;
+    void print_worker_statistics() const;
+private:
+    friend class TaskGroup;
+
+    struct Task {
+        std::function<void()> function;
+        TaskGroup * group;
+    };
+
+    struct alignas(64) Worker {
+        WorkStealingDeque<Task> deque;
+        std::thread thread;
+        std::atomic<uint64_t> tasks_executed;
+        std::atomic<uint64_t> tasks_stolen;
+        std::atomic<uint64_t> steal_attempts;
+        std::atomic<uint64_t> busy_ns;
+        std::atomic<uint64_t> idle_ns;
+    };
+
+    void _submit(Task * task);
+    bool _run_next_task(int64_t worker_index);
+    Task * _find_task(int64_t worker_index);
+    void _execute(Task * task, int64_t worker_index);
+    void _worker_loop(size_t worker_index, bool pin_worker);
+    int64_t _current_worker_index() const;
+
+    std::unique_ptr<Worker[]> _workers;
+    size_t _num_workers;
+    std::mutex _injection_mutex;
+    std::deque<Task *> _injection_queue;
+    std::atomic<size_t> _num_injected;
+    std::mutex _sleep_mutex;
+    std::condition_variable _sleep_condition;
+    std::atomic<size_t> _num_sleeping;
+    std::atomic<bool> _stopping;
+};
+
+// Tasks run through a group can be waited for together. wait() is called
+// by the destructor as well.
+class TaskGroup
+{
+public:
+    explicit TaskGroup(TaskScheduler & scheduler = TaskScheduler::instance());
+    ~TaskGroup();
+    TaskGroup(const TaskGroup & other) = delete;
+    void operator=(const TaskGroup & other) = delete;
+
+    void run(std::function<void()> function);
+    void wait();
+private:
+    friend class TaskScheduler;
+
+    TaskScheduler & _scheduler;
+    std::atomic<size_t> _num_pending;
+};
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,47 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "constants.h"
+#include "game_bot.h"
+#include "task_scheduler.h"
+
+// Totals of a round robin. The matrices are indexed [player][opponent] and
+// counted from the point of view of the row player.
+struct TournamentResult {
+    std::vector<std::string> names;
+    std::vector<std::vector<uint64_t>> wins;
+    std::vector<std::vector<uint64_t>> draws;
+    std::vector<std::vector<uint64_t>> losses;
+    std::vector<double> ratings;
+    std::vector<double> rating_errors;
+    uint64_t num_games;
+    double seconds;
+    double games_per_second;
+};
+
+// Headless round robin between match box policies. Every pair plays the
+// same number of games and takes turns at moving first. Each game draws
+// its random numbers from a generator seeded by the tournament seed and
+// the game index only, so results do not depend on the number of threads.
+class Tournament
+{
+public:
+    explicit Tournament(uint64_t seed);
+    void add_player(const std::string & name, GameBot * bot);
+    size_t num_players() const;
+    TournamentResult run(size_t games_per_pair, TaskScheduler & scheduler = TaskScheduler::instance());
+    static void print_result(const TournamentResult & result);
+private:
+    GameState _play_game(GameBot * first_bot, GameBot * second_bot, uint64_t game_index) const;
+    static void _estimate_ratings(TournamentResult & result);
+
+    uint64_t _seed;
+    std::vector<std::string> _names;
+    std::vector<GameBot *> _bots;
+};
+
+#endif // TOURNAMENT_H
@@ -0,0 +1,41 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+// Begin/end events in the Chrome Trace Event JSON format, for looking at
+// startup and training in a trace viewer (chrome://tracing, Perfetto).
+// Each thread buffers its events and hands them to the file writer in
+// batches. Build with DEFINES += ENABLE_TRACING to turn TRACE_SCOPE on;
+// names must be string literals.
+class Tracer
+{
+public:
+    static bool start(const std::string & filename);
+    static void stop();
+    static bool is_enabled();
+    static void record(const char * name, char phase);
+};
+
+class ScopedTraceEvent
+{
+public:
+    explicit ScopedTraceEvent(const char * name);
+    ~ScopedTraceEvent();
+    ScopedTraceEvent(const ScopedTraceEvent & other) = delete;
+    void operator=(const ScopedTraceEvent & other) = delete;
+private:
+    const char * _name;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_TRACING
+#define TRACE_SCOPE(name) ScopedTraceEvent TRACE_CONCAT(_scoped_trace_event_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) do {} while (false)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,50 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "constants.h"
+
+enum class TranspositionBound {
+    NONE = 0,
+    EXACT = 1,
+    LOWER = 2,
+    UPPER = 3,
+};
+
+// No best move stored in a TranspositionEntry.
+#define TT_NO_CELL (0xFF)
+
+// The best move is a board-agnostic cell number, row * NUM_COLS + col on a
+// Grid and 0 .. 63 on a QubicBoard, or TT_NO_CELL.
+struct TranspositionEntry {
+    int32_t score;
+    uint8_t depth;
+    TranspositionBound bound;
+    uint8_t best_cell;
+};
+
+// Lossy, lock-free table shared by all search threads. Each slot keeps the
+// key XOR-ed with its data, so a slot torn by concurrent writers fails the
+// key check on probe instead of returning mixed data.
+class TranspositionTable
+{
+public:
+    explicit TranspositionTable(size_t size_log2);
+    void clear();
+    bool probe(uint64_t hash, TranspositionEntry & entry) const;
+    void store(uint64_t hash, const TranspositionEntry & entry);
+    size_t size() const;
+private:
+    struct Slot {
+        std::atomic<uint64_t> key;
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Slot[]> _slots;
+    size_t _mask;
+};
+
+#endif // TRANSPOSITION_TABLE_H
@@ -0,0 +1,76 @@
+#ifndef ULTIMATE_BOARD_H
+#define ULTIMATE_BOARD_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "constants.h"
+#include "grid.h"
+
+#define ULTIMATE_NUM_SUB_BOARDS (MAX_RANK)
+#define ULTIMATE_MAX_RANK ((ULTIMATE_NUM_SUB_BOARDS) * (MAX_RANK))
+// forced_sub_board() when the next move may go to any open sub-board.
+#define ULTIMATE_ANY_SUB_BOARD (ULTIMATE_NUM_SUB_BOARDS)
+
+// A mark in cell row * NUM_COLS + col of one sub-board. Sub-boards are
+// numbered the same way on the meta-board.
+struct UltimateMove {
+    uint8_t sub_board;
+    uint8_t cell;
+
+    bool operator==(const UltimateMove & other) const {
+        return sub_board == other.sub_board && cell == other.cell;
+    }
+    bool operator!=(const UltimateMove & other) const {
+        return !(*this == other);
+    }
+};
+
+constexpr UltimateMove ULTIMATE_NO_MOVE = {ULTIMATE_NUM_SUB_BOARDS, MAX_RANK};
+
+// Ultimate tic-tac-toe: nine sub-boards on a meta-board. A move must go to
+// the sub-board matching the cell of the previous move, unless that
+// sub-board is won or full. Winning a sub-board claims its meta-board cell;
+// three claimed cells in a line win the game, and a meta-board with every
+// sub-board closed and no line is a draw.
+//
+// Every sub-board and the meta-board is kept as its grid_index(), so that
+// outcomes are single lookups in a table computed at compile time over all
+// 3^9 cell combinations, and as an occupancy bit mask for move generation.
+class UltimateBoard
+{
+public:
+    static GameState sub_board_outcome(uint32_t sub_board_index);
+
+    UltimateBoard();
+    explicit UltimateBoard(Move first_player_move);
+    void reset();
+    Move value(size_t sub_board, size_t cell) const;
+    Move first_player() const;
+    Move next_player() const;
+    GameState game_state() const;
+    bool has_game_ended() const;
+    GameState sub_board_state(size_t sub_board) const;
+    Grid sub_grid(size_t sub_board) const;
+    size_t forced_sub_board() const;
+    size_t rank() const;
+    bool is_legal_move(const UltimateMove & move) const;
+    size_t generate_moves(UltimateMove moves[ULTIMATE_MAX_RANK]) const;
+    void make_move(const UltimateMove & move);
+    void unmake_move(const UltimateMove & move);
+    uint64_t perft(size_t depth);
+    void print_board() const;
+private:
+    uint16_t _sub_board_indices[ULTIMATE_NUM_SUB_BOARDS];
+    uint16_t _occupied[ULTIMATE_NUM_SUB_BOARDS];
+    // grid_index() of the meta-board: won sub-boards only, drawn ones are empty.
+    uint16_t _meta_index;
+    uint16_t _closed;
+    // Forced sub-board before every move, so unmake_move() needs no argument but the move.
+    uint8_t _forced_sub_boards[ULTIMATE_MAX_RANK + 1];
+    size_t _rank;
+    Move _first_player;
+    GameState _game_state;
+};
+
+#endif // ULTIMATE_BOARD_H
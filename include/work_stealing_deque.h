@@ -0,0 +1,121 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Chase-Lev deque (Le, Pop, Cohen, Zappa Nardelli, PPoPP 2013). The owning
+// worker pushes and pops at the bottom, any other thread may steal from the
+// top. Outgrown buffers are kept until the deque is destroyed because a
+// thief may still be reading from them.
+template <typename T>
+class WorkStealingDeque
+{
+public:
+    explicit WorkStealingDeque(size_t capacity_log2 = 8) :
+        _top(0),
+        _bottom(0)
+    {
+        _buffers.emplace_back(new Buffer(capacity_log2));
+        _buffer.store(_buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    void push(T * item) {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        int64_t top = _top.load(std::memory_order_acquire);
+        Buffer * buffer = _buffer.load(std::memory_order_relaxed);
+        if (bottom - top > buffer->capacity() - 1) {
+            buffer = _grow(buffer, bottom, top);
+        }
+        buffer->put(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    T * pop() {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        Buffer * buffer = _buffer.load(std::memory_order_relaxed);
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = _top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T * item = buffer->get(bottom);
+        if (top == bottom) {
+            // Last item, race against thieves for it.
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    T * steal() {
+        int64_t top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = _bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+        Buffer * buffer = _buffer.load(std::memory_order_acquire);
+        T * item = buffer->get(top);
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    bool empty() const {
+        return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+    }
+private:
+    class Buffer
+    {
+    public:
+        explicit Buffer(size_t capacity_log2) :
+            _mask((static_cast<int64_t>(1) << capacity_log2) - 1),
+            _items(new std::atomic<T *>[static_cast<size_t>(1) << capacity_log2])
+        {
+
+        }
+        int64_t capacity() const {
+            return _mask + 1;
+        }
+        T * get(int64_t index) const {
+            return _items[index & _mask].load(std::memory_order_relaxed);
+        }
+        void put(int64_t index, T * item) {
+            _items[index & _mask].store(item, std::memory_order_relaxed);
+        }
+    private:
+        int64_t _mask;
+        std::unique_ptr<std::atomic<T *>[]> _items;
+    };
+
+    Buffer * _grow(Buffer * buffer, int64_t bottom, int64_t top) {
+        size_t capacity_log2 = 0;
+        while ((static_cast<int64_t>(1) << capacity_log2) < 2 * buffer->capacity()) {
+            ++capacity_log2;
+        }
+        Buffer * new_buffer = new Buffer(capacity_log2);
+        for (int64_t index = top; index < bottom; ++index) {
+            new_buffer->put(index, buffer->get(index));
+        }
+        _buffers.emplace_back(new_buffer);
+        _buffer.store(new_buffer, std::memory_order_release);
+        return new_buffer;
+    }
+
+    alignas(64) std::atomic<int64_t> _top;
+    alignas(64) std::atomic<int64_t> _bottom;
+    std::atomic<Buffer *> _buffer;
+    std::vector<std::unique_ptr<Buffer>> _buffers;
+};
+
+#endif // WORK_STEALING_DEQUE_H
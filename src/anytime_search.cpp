@@ -0,0 +1,273 @@
+#include "anytime_search.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+#include "constants.h"
+#include "grid.h"
+#include "search_adapters.h"
+#include "ultimate_board.h"
+
+// A won sub-board is worth this many completed-cell points of a sub-board line.
+#define ULTIMATE_META_LINE_WEIGHT (8)
+
+// UltimateBoard adapters for the templated search, next to the Grid ones
+// from search_adapters.h.
+static void search_make_move(UltimateBoard & board, const UltimateMove & move, Move player) {
+    assert(board.next_player() == player);
+    (void) player;
+    board.make_move(move);
+}
+
+static void search_unmake_move(UltimateBoard & board, const UltimateMove & move) {
+    board.unmake_move(move);
+}
+
+static size_t search_order_moves(const UltimateBoard & board, Move player, UltimateMove hint, UltimateMove moves[ULTIMATE_MAX_RANK]) {
+    // Only the hinted move is promoted; the generator order is kept otherwise.
+    (void) player;
+    size_t num_moves = board.generate_moves(moves);
+    for (size_t move_index = 1; move_index < num_moves; ++move_index) {
+        if (moves[move_index] == hint) {
+            std::swap(moves[0], moves[move_index]);
+            break;
+        }
+    }
+    return num_moves;
+}
+
+AnytimeSearch::AnytimeSearch() :
+    _aborted(false),
+    _stop_flag(nullptr)
+{
+    _statistics.nodes_searched = 0;
+    _statistics.depth_reached = 0;
+    _statistics.solved = false;
+}
+
+void AnytimeSearch::set_leaf_evaluator(LeafEvaluator leaf_evaluator) {
+    _leaf_evaluator = leaf_evaluator;
+}
+
+void AnytimeSearch::set_stop_flag(const std::atomic<bool> * stop_flag) {
+    _stop_flag = stop_flag;
+}
+
+bool AnytimeSearch::search(const Grid & grid, std::chrono::microseconds search_budget, MovePosition & best_position) {
+    return _search(grid, search_budget, MAX_RANK, MovePosition(NUM_ROWS, NUM_COLS), best_position);
+}
+
+bool AnytimeSearch::search(const UltimateBoard & board, std::chrono::microseconds search_budget, UltimateMove & best_move) {
+    return _search(board, search_budget, ULTIMATE_MAX_RANK, ULTIMATE_NO_MOVE, best_move);
+}
+
+SearchStatistics AnytimeSearch::get_statistics() const {
+    return _statistics;
+}
+
+template <typename Board, typename Position>
+bool AnytimeSearch::_search(const Board & board, std::chrono::microseconds search_budget, size_t max_rank, Position no_position, Position & best_position) {
+    _deadline = std::chrono::steady_clock::now() + search_budget;
+    _aborted = false;
+    _statistics.nodes_searched = 0;
+    _statistics.depth_reached = 0;
+    _statistics.solved = false;
+
+    best_position = no_position;
+
+    Move player = board.next_player();
+    if (player == Move::EMPTY || board.game_state() != GameState::ONGOING) {
+        return false;
+    }
+
+    Board search_board = board;
+    size_t max_depth = max_rank - board.rank();
+    for (size_t depth = 1; depth <= max_depth && !_should_stop(); ++depth) {
+        Position position = no_position;
+        int32_t score = _search_root(search_board, player, depth, no_position, best_position, position);
+        if (_aborted) {
+            break;
+        }
+        best_position = position;
+        _statistics.depth_reached = depth;
+        if (std::abs(score) >= SEARCH_WIN_SCORE - static_cast<int32_t>(max_rank) || depth == max_depth) {
+            _statistics.solved = true;
+            break;
+        }
+    }
+    return best_position != no_position;
+}
+
+template <typename Board, typename Position>
+int32_t AnytimeSearch::_search_root(Board & board, Move player, size_t depth, Position no_position, Position previous_best_position, Position & best_position) {
+    int32_t alpha = -SEARCH_INFINITY;
+    int32_t beta = SEARCH_INFINITY;
+    best_position = no_position;
+
+    // The previous iteration's best move is searched first.
+    Position positions[ULTIMATE_MAX_RANK];
+    size_t num_positions = search_order_moves(board, player, previous_best_position, positions);
+    for (size_t position_index = 0; position_index < num_positions; ++position_index) {
+        const Position & position = positions[position_index];
+        search_make_move(board, position, player);
+        int32_t score = -_negamax(board, OPPONENT_MOVE(player), depth - 1, 1, -beta, -alpha, no_position);
+        search_unmake_move(board, position);
+
+        if (_aborted) {
+            return alpha;
+        }
+        if (score > alpha) {
+            alpha = score;
+            best_position = position;
+        }
+    }
+    return alpha;
+}
+
+template <typename Board, typename Position>
+int32_t AnytimeSearch::_negamax(Board & board, Move player, size_t depth, size_t ply, int32_t alpha, int32_t beta, Position no_position) {
+    ++_statistics.nodes_searched;
+    if (_statistics.nodes_searched % SEARCH_DEADLINE_CHECK_INTERVAL == 0 && _should_stop()) {
+        _aborted = true;
+        return 0;
+    }
+
+    switch (board.game_state()) {
+        case GameState::CROSS_WINS:
+        case GameState::NOUGHT_WINS:
+            // The previous player completed a line.
+            return -(SEARCH_WIN_SCORE - static_cast<int32_t>(ply));
+        case GameState::DRAW:
+            return 0;
+        case GameState::ONGOING:
+        case GameState::INVALID:
+        default:
+            break;
+    }
+    if (depth == 0) {
+        return _evaluate(board, player);
+    }
+
+    int32_t best_score = -SEARCH_INFINITY;
+    Position positions[ULTIMATE_MAX_RANK];
+    size_t num_positions = search_order_moves(board, player, no_position, positions);
+    for (size_t position_index = 0; position_index < num_positions; ++position_index) {
+        const Position & position = positions[position_index];
+        search_make_move(board, position, player);
+        int32_t score = -_negamax(board, OPPONENT_MOVE(player), depth - 1, ply + 1, -beta, -alpha, no_position);
+        search_unmake_move(board, position);
+
+        if (_aborted) {
+            return 0;
+        }
+        best_score = std::max(best_score, score);
+        alpha = std::max(alpha, score);
+        if (alpha >= beta) {
+            return best_score;
+        }
+    }
+    return best_score;
+}
+
+int32_t AnytimeSearch::evaluate(const Grid & grid, Move player) {
+    // Lines that are still open for one side only, weighted by how many of
+    // that side's marks they already hold.
+    int32_t score = 0;
+    size_t num_lines = NUM_ROWS + NUM_COLS + (NUM_ROWS == NUM_COLS ? NUM_DIAGS : 0);
+    for (size_t line = 0; line < num_lines; ++line) {
+        int32_t own = 0, other = 0;
+        size_t line_length = line < NUM_ROWS ? NUM_COLS : NUM_ROWS;
+        for (size_t index = 0; index < line_length; ++index) {
+            size_t row = 0, col = 0;
+            if (line < NUM_ROWS) {
+                row = line;
+                col = index;
+            } else if (line < NUM_ROWS + NUM_COLS) {
+                row = index;
+                col = line - NUM_ROWS;
+            } else if (line == NUM_ROWS + NUM_COLS) {
+                row = index;
+                col = index;
+            } else {
+                row = index;
+                col = NUM_COLS - index - 1;
+            }
+            Move move = grid.value(row, col);
+            if (move == player) {
+                ++own;
+            } else if (move != Move::EMPTY) {
+                ++other;
+            }
+        }
+        if (other == 0) {
+            score += own * own;
+        } else if (own == 0) {
+            score -= other * other;
+        }
+    }
+    return score;
+}
+
+int32_t AnytimeSearch::clamp_heuristic_score(int32_t score) {
+    return std::max(-SEARCH_MAX_HEURISTIC_SCORE, std::min(SEARCH_MAX_HEURISTIC_SCORE, score));
+}
+
+int32_t AnytimeSearch::evaluate(const UltimateBoard & board, Move player) {
+    // Meta-board lines that only one side can still complete, weighted like
+    // the Grid evaluation, plus the Grid evaluation of every open sub-board.
+    static const size_t lines[NUM_ROWS + NUM_COLS + NUM_DIAGS][NUM_ROWS] = {
+        {0, 1, 2}, {3, 4, 5}, {6, 7, 8},
+        {0, 3, 6}, {1, 4, 7}, {2, 5, 8},
+        {0, 4, 8}, {2, 4, 6},
+    };
+    GameState own_win = player == Move::CROSS ? GameState::CROSS_WINS : GameState::NOUGHT_WINS;
+    int32_t score = 0;
+    for (const auto & line : lines) {
+        int32_t own = 0, other = 0;
+        bool blocked = false;
+        for (size_t sub_board : line) {
+            GameState sub_board_state = board.sub_board_state(sub_board);
+            if (sub_board_state == GameState::DRAW) {
+                blocked = true;
+            } else if (sub_board_state == own_win) {
+                ++own;
+            } else if (sub_board_state != GameState::ONGOING) {
+                ++other;
+            }
+        }
+        if (blocked) {
+            continue;
+        }
+        if (other == 0) {
+            score += ULTIMATE_META_LINE_WEIGHT * own * own;
+        } else if (own == 0) {
+            score -= ULTIMATE_META_LINE_WEIGHT * other * other;
+        }
+    }
+    for (size_t sub_board = 0; sub_board < ULTIMATE_NUM_SUB_BOARDS; ++sub_board) {
+        if (board.sub_board_state(sub_board) == GameState::ONGOING) {
+            score += evaluate(board.sub_grid(sub_board), player);
+        }
+    }
+    return clamp_heuristic_score(score);
+}
+
+int32_t AnytimeSearch::_evaluate(const Grid & grid, Move player) const {
+    return _leaf_evaluator ? _leaf_evaluator(grid, player) : evaluate(grid, player);
+}
+
+int32_t AnytimeSearch::_evaluate(const UltimateBoard & board, Move player) const {
+    return evaluate(board, player);
+}
+
+bool AnytimeSearch::_deadline_reached() {
+    return std::chrono::steady_clock::now() >= _deadline;
+}
+
+bool AnytimeSearch::_should_stop() {
+    return (_stop_flag != nullptr && _stop_flag->load(std::memory_order_relaxed)) || _deadline_reached();
+}
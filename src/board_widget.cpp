@@ -0,0 +1,184 @@
+#include "board_widget.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <QColor>
+#include <QPainter>
+#include <QPen>
+#include <QRectF>
+
+#include "constants.h"
+
+BoardWidget::BoardWidget(int8_t num_rows, int8_t num_cols, QWidget * parent) :
+    QWidget(parent),
+    _num_rows(0),
+    _num_cols(0),
+    _cell_size(1)
+{
+    // paintEvent() covers every pixel, so Qt need not clear the background.
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    set_board_size(num_rows, num_cols);
+}
+
+void BoardWidget::set_board_size(int8_t num_rows, int8_t num_cols) {
+    assert(num_rows > 0 && num_cols > 0);
+    _num_rows = num_rows;
+    _num_cols = num_cols;
+    _cells.assign(static_cast<size_t>(num_rows) * num_cols, Move::EMPTY);
+    _winning_cells.assign(_cells.size(), false);
+    _winning_positions.clear();
+    _update_geometry();
+    updateGeometry();
+    update();
+}
+
+int8_t BoardWidget::num_rows() const {
+    return _num_rows;
+}
+
+int8_t BoardWidget::num_cols() const {
+    return _num_cols;
+}
+
+void BoardWidget::clear() {
+    std::fill(_cells.begin(), _cells.end(), Move::EMPTY);
+    std::fill(_winning_cells.begin(), _winning_cells.end(), false);
+    _winning_positions.clear();
+    update();
+}
+
+Move BoardWidget::cell(int8_t row_index, int8_t col_index) const {
+    return _cells[_cell_index(row_index, col_index)];
+}
+
+void BoardWidget::set_cell(int8_t row_index, int8_t col_index, Move move) {
+    Move & cell = _cells[_cell_index(row_index, col_index)];
+    if (cell == move) {
+        return;
+    }
+    cell = move;
+    update(_cell_rect(row_index, col_index));
+}
+
+void BoardWidget::set_winning_cells(const std::vector<MovePosition> & winning_cells) {
+    // Cells leaving and joining the line are repainted, nothing else.
+    for (const MovePosition & position : _winning_positions) {
+        _winning_cells[_cell_index(position.first, position.second)] = false;
+        update(_cell_rect(position.first, position.second));
+    }
+    _winning_positions = winning_cells;
+    for (const MovePosition & position : _winning_positions) {
+        _winning_cells[_cell_index(position.first, position.second)] = true;
+        update(_cell_rect(position.first, position.second));
+    }
+}
+
+QSize BoardWidget::sizeHint() const {
+    int cell_size = std::max(BOARD_MIN_CELL_SIZE, BOARD_SIZE_HINT / std::max(_num_rows, _num_cols));
+    return QSize(cell_size * _num_cols, cell_size * _num_rows);
+}
+
+QSize BoardWidget::minimumSizeHint() const {
+    return QSize(BOARD_MIN_CELL_SIZE * _num_cols, BOARD_MIN_CELL_SIZE * _num_rows);
+}
+
+void BoardWidget::paintEvent(QPaintEvent * event) {
+    QPainter painter(this);
+    const QRect & dirty_rect = event->rect();
+    painter.fillRect(dirty_rect, palette().window());
+
+    // Only the cells overlapping the dirty rectangle.
+    QRect board_rect(_origin, QSize(_cell_size * _num_cols, _cell_size * _num_rows));
+    QRect paint_rect = dirty_rect & board_rect;
+    if (paint_rect.isEmpty()) {
+        return;
+    }
+    int8_t first_row = static_cast<int8_t>((paint_rect.top() - _origin.y()) / _cell_size);
+    int8_t last_row = static_cast<int8_t>(std::min<int>(_num_rows - 1, (paint_rect.bottom() - _origin.y()) / _cell_size));
+    int8_t first_col = static_cast<int8_t>((paint_rect.left() - _origin.x()) / _cell_size);
+    int8_t last_col = static_cast<int8_t>(std::min<int>(_num_cols - 1, (paint_rect.right() - _origin.x()) / _cell_size));
+
+    for (int8_t row = first_row; row <= last_row; ++row) {
+        for (int8_t col = first_col; col <= last_col; ++col) {
+            _paint_cell(painter, row, col);
+        }
+    }
+}
+
+void BoardWidget::mouseReleaseEvent(QMouseEvent * event) {
+    int8_t row_index = 0, col_index = 0;
+    if (event->button() != Qt::LeftButton || !_cell_at(event->pos(), row_index, col_index)) {
+        QWidget::mouseReleaseEvent(event);
+        return;
+    }
+    emit cell_clicked(row_index, col_index);
+}
+
+void BoardWidget::resizeEvent(QResizeEvent * event) {
+    QWidget::resizeEvent(event);
+    _update_geometry();
+}
+
+void BoardWidget::_update_geometry() {
+    _cell_size = std::max(1, std::min(width() / _num_cols, height() / _num_rows));
+    _origin = QPoint((width() - _cell_size * _num_cols) / 2, (height() - _cell_size * _num_rows) / 2);
+}
+
+void BoardWidget::_paint_cell(QPainter & painter, int8_t row_index, int8_t col_index) const {
+    QRect rect = _cell_rect(row_index, col_index);
+    bool winning = _winning_cells[_cell_index(row_index, col_index)];
+    painter.fillRect(rect, winning ? QColor(Qt::green) : QColor(Qt::white));
+
+    // Each cell draws its own top and left border; the last row and column
+    // close the board.
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setPen(QPen(QColor(Qt::gray), 1));
+    painter.drawLine(rect.topLeft(), rect.topRight());
+    painter.drawLine(rect.topLeft(), rect.bottomLeft());
+    if (row_index == _num_rows - 1) {
+        painter.drawLine(rect.bottomLeft(), rect.bottomRight());
+    }
+    if (col_index == _num_cols - 1) {
+        painter.drawLine(rect.topRight(), rect.bottomRight());
+    }
+
+    Move move = _cells[_cell_index(row_index, col_index)];
+    if (move == Move::EMPTY) {
+        return;
+    }
+    qreal margin = _cell_size / 5.0;
+    QRectF symbol_rect = QRectF(rect).adjusted(margin, margin, -margin, -margin);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(QPen(QColor(Qt::black), std::max(2.0, _cell_size / 12.0), Qt::SolidLine, Qt::RoundCap));
+    painter.setBrush(Qt::NoBrush);
+    if (move == Move::CROSS) {
+        painter.drawLine(symbol_rect.topLeft(), symbol_rect.bottomRight());
+        painter.drawLine(symbol_rect.topRight(), symbol_rect.bottomLeft());
+    } else {
+        painter.drawEllipse(symbol_rect);
+    }
+}
+
+QRect BoardWidget::_cell_rect(int8_t row_index, int8_t col_index) const {
+    return QRect(_origin.x() + col_index * _cell_size, _origin.y() + row_index * _cell_size, _cell_size, _cell_size);
+}
+
+bool BoardWidget::_cell_at(const QPoint & point, int8_t & row_index, int8_t & col_index) const {
+    int x = point.x() - _origin.x();
+    int y = point.y() - _origin.y();
+    if (x < 0 || y < 0 || x >= _cell_size * _num_cols || y >= _cell_size * _num_rows) {
+        return false;
+    }
+    row_index = static_cast<int8_t>(y / _cell_size);
+    col_index = static_cast<int8_t>(x / _cell_size);
+    return true;
+}
+
+size_t BoardWidget::_cell_index(int8_t row_index, int8_t col_index) const {
+    assert(row_index >= 0 && row_index < _num_rows);
+    assert(col_index >= 0 && col_index < _num_cols);
+    return static_cast<size_t>(row_index) * _num_cols + col_index;
+}
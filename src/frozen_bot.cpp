@@ -0,0 +1,73 @@
+#include "frozen_bot.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+#include "frozen_policy.h"
+#include "grid_symmetry.h"
+#include "match_box.h"
+
+static_assert(FROZEN_POLICY_NUM_ROWS == NUM_ROWS && FROZEN_POLICY_NUM_COLS == NUM_COLS,
+              "frozen_policy.h was exported for another board size");
+
+bool FrozenBot::get_next_move(const Grid & grid, MovePosition & position) const {
+    position = std::make_pair(NUM_ROWS, NUM_COLS);
+    size_t position_index = 0;
+    GridTransformation grid_transformation = GridTransformation::GRID_EQUAL;
+    if (!_find_position(grid, position_index, grid_transformation)) {
+        return false;
+    }
+    size_t cell = FROZEN_POLICY_MOVES[position_index];
+    position = grid_symmetry_source(grid_transformation, cell / NUM_COLS, cell % NUM_COLS);
+    return true;
+}
+
+bool FrozenBot::get_next_move(const Grid & grid, uint32_t random_number, MovePosition & position) const {
+#if FROZEN_POLICY_HAS_SEEDS
+    position = std::make_pair(NUM_ROWS, NUM_COLS);
+    size_t position_index = 0;
+    GridTransformation grid_transformation = GridTransformation::GRID_EQUAL;
+    if (!_find_position(grid, position_index, grid_transformation)) {
+        return false;
+    }
+    MatchBoxSeeds seeds;
+    for (size_t cell = 0; cell < NUM_ROWS * NUM_COLS; ++cell) {
+        seeds.remaining_seeds[cell / NUM_COLS][cell % NUM_COLS] = FROZEN_POLICY_SEEDS[position_index][cell];
+    }
+    MovePosition canonical_position = MatchBox::sample_seeds(seeds, random_number);
+    if (canonical_position.first >= NUM_ROWS || canonical_position.second >= NUM_COLS) {
+        return false;
+    }
+    position = grid_symmetry_source(grid_transformation, canonical_position.first, canonical_position.second);
+    return true;
+#else
+    // Exported without seeds: always the best move.
+    (void) random_number;
+    return get_next_move(grid, position);
+#endif
+}
+
+size_t FrozenBot::num_positions() const {
+    return FROZEN_POLICY_NUM_POSITIONS;
+}
+
+uint64_t FrozenBot::version() const {
+    return FROZEN_POLICY_VERSION;
+}
+
+bool FrozenBot::_find_position(const Grid & grid, size_t & position_index, GridTransformation & grid_transformation) {
+    if (grid.has_game_ended()) {
+        return false;
+    }
+    // Exported positions are games started by DEFAULT_FIRST_PLAYER_MOVE.
+    uint64_t key = grid.first_player() == DEFAULT_FIRST_PLAYER_MOVE ?
+        canonical_grid_index(grid, grid_transformation) : canonical_grid_index(grid.swapped_players(), grid_transformation);
+    const uint32_t * keys_end = FROZEN_POLICY_KEYS + FROZEN_POLICY_NUM_POSITIONS;
+    const uint32_t * found_key = std::lower_bound(FROZEN_POLICY_KEYS, keys_end, key);
+    if (found_key == keys_end || *found_key != key) {
+        return false;
+    }
+    position_index = static_cast<size_t>(found_key - FROZEN_POLICY_KEYS);
+    return true;
+}
@@ -8,16 +8,45 @@
 #include <tuple>
 
 #include "game_bot.h"
-
-Game::Game() {
-    reset();
+#include "trace.h"
+
+Game::Game(const PlayerRoles & player_roles) :
+    _player_roles(player_roles),
+    _ponderer(_game_bot),
+    _pondering(true)
+{
+    // Train on the logs before reset() can start pondering.
     _load_game_history();
+    reset();
 }
 
 void Game::reset() {
-    _grid.reset();
+    _ponderer.cancel();
+    _grid = Grid(_player_roles.first_player_move);
+    _bot_history.clear();
     _game_status_string = "";
-    _statistics.start_new_game();
+    _statistics.start_new_game(_player_roles);
+    _start_pondering();
+}
+
+void Game::set_player_roles(const PlayerRoles & player_roles) {
+    // Takes effect from the next reset().
+    assert(player_roles.first_player_move != Move::EMPTY);
+    assert(player_roles.player_move != player_roles.bot_move);
+    _player_roles = player_roles;
+}
+
+PlayerRoles Game::get_player_roles() const {
+    return _player_roles;
+}
+
+void Game::set_pondering(bool pondering) {
+    _pondering = pondering;
+    if (_pondering) {
+        _start_pondering();
+    } else {
+        _ponderer.cancel();
+    }
 }
 
 bool Game::play_next(int8_t row_index, int8_t col_index, Move & next_move) {
@@ -25,7 +54,7 @@ bool Game::play_next(int8_t row_index, int8_t col_index, Move & next_move) {
     _grid.print_grid();
 
     next_move = _grid.next_player();
-    if (next_move != PLAYER_MOVE) {
+    if (_player_roles.play_bot && next_move != _player_roles.player_move) {
         return false;
     }
     return _play(row_index, col_index);
@@ -36,7 +65,7 @@ bool Game::play_bot(int8_t & row_index, int8_t & col_index, Move & next_move) {
     _grid.print_grid();
 
     next_move = _grid.next_player();
-    if (next_move != BOT_MOVE) {
+    if (!_player_roles.play_bot || next_move != _player_roles.bot_move) {
         return false;
     }
     return _play_bot(row_index, col_index);
@@ -55,15 +84,18 @@ std::vector<MovePosition> Game::get_winning_moves() {
 }
 
 void Game::_load_game_history() {
+    TRACE_SCOPE("Game::_load_game_history");
     printf("Loading Game History\n");
     std::vector<std::vector<Move>> move_history;
     std::vector<std::vector<MovePosition>> move_position_history;
     std::vector<GameState> game_state_history;
+    std::vector<PlayerRoles> player_roles_history;
 
-    _statistics.read_move_history(move_history, move_position_history, game_state_history);
+    _statistics.read_move_history(move_history, move_position_history, game_state_history, player_roles_history);
 
     assert(move_history.size() == move_position_history.size());
     assert(move_history.size() == game_state_history.size());
+    assert(move_history.size() == player_roles_history.size());
 
     size_t num_games = move_history.size();
 
@@ -71,9 +103,10 @@ void Game::_load_game_history() {
         std::vector<Move> moves = move_history.at(game_index);
         std::vector<MovePosition> move_positions = move_position_history.at(game_index);
         GameState game_state = game_state_history.at(game_index);
+        const PlayerRoles & player_roles = player_roles_history.at(game_index);
 
-        _game_bot.load_move_history(moves, move_positions);
-        _game_bot.finish_game(game_state);
+        _game_bot.load_move_history(moves, move_positions, player_roles.first_player_move, player_roles.bot_move);
+        _game_bot.finish_game(game_state, player_roles.bot_move);
     }
 }
 
@@ -111,7 +144,10 @@ bool Game::_play(int8_t row_index, int8_t col_index) {
     _game_status_string = status;
 
     if (_grid.has_game_ended()) {
-        _game_bot.finish_game(_grid.game_state());
+        _ponderer.cancel();
+        if (_player_roles.play_bot) {
+            _game_bot.finish_game(_grid.game_state(), _bot_history, _player_roles.bot_move);
+        }
         _statistics.game_finished(_grid.game_state());
     }
 
@@ -120,12 +156,25 @@ bool Game::_play(int8_t row_index, int8_t col_index) {
 
 bool Game::_play_bot(int8_t & row_index, int8_t & col_index) {
     MovePosition position;
-    bool valid_move = _game_bot.get_next_move(_grid, position);
+    bool valid_move = _ponderer.take_reply(_grid, position, _bot_history);
+    if (!valid_move) {
+        valid_move = _game_bot.get_next_move(_grid, position, _bot_history);
+    }
     if (!valid_move) {
         return false;
     }
     row_index = static_cast<int8_t>(position.first);
     col_index = static_cast<int8_t>(position.second);
 
-    return _play(row_index, col_index);
+    bool success = _play(row_index, col_index);
+    _start_pondering();
+    return success;
+}
+
+void Game::_start_pondering() {
+    // Only worth it while the human is to move against the bot.
+    if (!_pondering || !_player_roles.play_bot || _grid.next_player() != _player_roles.player_move) {
+        return;
+    }
+    _ponderer.start(_grid);
 }
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include "game_archive.h"
+
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "grid.h"
+#include "grid_symmetry.h"
+
+#define GAME_ARCHIVE_MAGIC "TTTARCH2"
+
+// A packed move sequence holds the number of moves in its low bits followed
+// by one row * NUM_COLS + col cell per move.
+#define GAME_ARCHIVE_CELL_BITS (4)
+#define GAME_ARCHIVE_CELL_MASK ((uint64_t(1) << GAME_ARCHIVE_CELL_BITS) - 1)
+
+static_assert(NUM_ROWS * NUM_COLS <= GAME_ARCHIVE_CELL_MASK,
+              "a cell index does not fit in GAME_ARCHIVE_CELL_BITS");
+static_assert((NUM_ROWS * NUM_COLS + 1) * GAME_ARCHIVE_CELL_BITS <= 64,
+              "a game does not fit in one packed move sequence");
+
+// Followed by the columns, one after the other, each num_games long.
+struct GameArchiveHeader {
+    char magic[8];
+    uint64_t num_games;
+    uint64_t num_source_files;
+};
+
+GameArchive::GameArchive() {
+    clear();
+}
+
+void GameArchive::clear() {
+    _packed_moves.clear();
+    _game_outcomes.clear();
+    _first_player_moves.clear();
+    _bot_moves.clear();
+    _timestamps.clear();
+    _num_source_files = 0;
+    for (Bitmap & bitmap : _game_outcome_bitmaps) {
+        bitmap.clear();
+    }
+    for (auto & opening_bitmaps : _opening_bitmaps) {
+        opening_bitmaps.clear();
+    }
+}
+
+void GameArchive::append(const std::vector<MovePosition> & move_positions, GameOutcome game_outcome, const PlayerRoles & player_roles, uint32_t timestamp) {
+    assert(move_positions.size() <= NUM_ROWS * NUM_COLS);
+    assert(game_outcome != GameOutcome::UNKNOWN);
+    uint64_t packed_moves = move_positions.size();
+    for (size_t move_index = 0; move_index < move_positions.size(); ++move_index) {
+        const MovePosition & move_position = move_positions.at(move_index);
+        assert(move_position.first < NUM_ROWS && move_position.second < NUM_COLS);
+        uint64_t cell = move_position.first * NUM_COLS + move_position.second;
+        packed_moves |= cell << ((move_index + 1) * GAME_ARCHIVE_CELL_BITS);
+    }
+    _packed_moves.push_back(packed_moves);
+    _game_outcomes.push_back(static_cast<uint8_t>(game_outcome));
+    _first_player_moves.push_back(static_cast<uint8_t>(player_roles.first_player_move));
+    _bot_moves.push_back(static_cast<uint8_t>(player_roles.bot_move));
+    _timestamps.push_back(timestamp);
+    _index_game(_packed_moves.size() - 1);
+}
+
+size_t GameArchive::num_games() const {
+    return _packed_moves.size();
+}
+
+void GameArchive::set_num_source_files(size_t num_source_files) {
+    _num_source_files = num_source_files;
+}
+
+size_t GameArchive::num_source_files() const {
+    return _num_source_files;
+}
+
+ArchivedGame GameArchive::get_game(size_t game_index) const {
+    assert(game_index < num_games());
+    ArchivedGame game;
+    game.game_outcome = static_cast<GameOutcome>(_game_outcomes[game_index]);
+    game.player_roles.first_player_move = static_cast<Move>(_first_player_moves[game_index]);
+    game.player_roles.bot_move = static_cast<Move>(_bot_moves[game_index]);
+    game.player_roles.player_move = OPPONENT_MOVE(game.player_roles.bot_move);
+    game.player_roles.play_bot = true;
+    game.timestamp = _timestamps[game_index];
+
+    uint64_t packed_moves = _packed_moves[game_index];
+    size_t num_moves = packed_moves & GAME_ARCHIVE_CELL_MASK;
+    Move move = game.player_roles.first_player_move;
+    for (size_t move_index = 0; move_index < num_moves; ++move_index) {
+        size_t cell = (packed_moves >> ((move_index + 1) * GAME_ARCHIVE_CELL_BITS)) & GAME_ARCHIVE_CELL_MASK;
+        game.moves.push_back(move);
+        game.move_positions.push_back(std::make_pair(cell / NUM_COLS, cell % NUM_COLS));
+        move = OPPONENT_MOVE(move);
+    }
+    return game;
+}
+
+void GameArchive::find(const GameArchiveQuery & query, std::vector<size_t> & game_indices) const {
+    game_indices.clear();
+    Bitmap candidates;
+    if (!_get_candidates(query, candidates)) {
+        return;
+    }
+    for (size_t word_index = 0; word_index < candidates.size(); ++word_index) {
+        for (uint64_t word = candidates[word_index]; word != 0; word &= word - 1) {
+            size_t bit_index = 0;
+            while (((word >> bit_index) & 1) == 0) {
+                ++bit_index;
+            }
+            size_t game_index = word_index * 64 + bit_index;
+            if (_matches_columns(query, game_index)) {
+                game_indices.push_back(game_index);
+            }
+        }
+    }
+}
+
+size_t GameArchive::count(const GameArchiveQuery & query) const {
+    bool needs_columns = query.bot_move != Move::EMPTY || query.from_timestamp != 0 || query.to_timestamp != UINT32_MAX;
+    if (needs_columns) {
+        std::vector<size_t> game_indices;
+        find(query, game_indices);
+        return game_indices.size();
+    }
+    // Answered from the bitmaps alone.
+    Bitmap candidates;
+    if (!_get_candidates(query, candidates)) {
+        return 0;
+    }
+    size_t num_matches = 0;
+    for (uint64_t word : candidates) {
+        num_matches += std::bitset<64>(word).count();
+    }
+    return num_matches;
+}
+
+bool GameArchive::save(const std::string & filename) const {
+    GameArchiveHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, GAME_ARCHIVE_MAGIC, sizeof(header.magic));
+    header.num_games = num_games();
+    header.num_source_files = _num_source_files;
+
+    // Written aside and renamed so that a crash never leaves half an archive.
+    std::string temporary_filename = filename + ".tmp";
+    FILE * file = fopen(temporary_filename.c_str(), "wb");
+    if (file == nullptr) {
+        printf("GameArchive::save(): Cannot open file = %s\n", temporary_filename.c_str());
+        return false;
+    }
+    size_t num_games = header.num_games;
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(_packed_moves.data(), sizeof(uint64_t), num_games, file) == num_games
+        && fwrite(_game_outcomes.data(), sizeof(uint8_t), num_games, file) == num_games
+        && fwrite(_first_player_moves.data(), sizeof(uint8_t), num_games, file) == num_games
+        && fwrite(_bot_moves.data(), sizeof(uint8_t), num_games, file) == num_games
+        && fwrite(_timestamps.data(), sizeof(uint32_t), num_games, file) == num_games;
+    success = fclose(file) == 0 && success;
+    success = success && rename(temporary_filename.c_str(), filename.c_str()) == 0;
+    if (!success) {
+        printf("GameArchive::save(): Cannot write file = %s\n", filename.c_str());
+        remove(temporary_filename.c_str());
+    }
+    return success;
+}
+
+bool GameArchive::load(const std::string & filename) {
+    clear();
+    FILE * file = fopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+        printf("GameArchive::load(): Cannot open file = %s\n", filename.c_str());
+        return false;
+    }
+    GameArchiveHeader header;
+    bool success = fread(&header, sizeof(header), 1, file) == 1
+        && memcmp(header.magic, GAME_ARCHIVE_MAGIC, sizeof(header.magic)) == 0;
+    size_t num_games = success ? header.num_games : 0;
+    if (success) {
+        _packed_moves.resize(num_games);
+        _game_outcomes.resize(num_games);
+        _first_player_moves.resize(num_games);
+        _bot_moves.resize(num_games);
+        _timestamps.resize(num_games);
+        _num_source_files = header.num_source_files;
+        success = fread(_packed_moves.data(), sizeof(uint64_t), num_games, file) == num_games
+            && fread(_game_outcomes.data(), sizeof(uint8_t), num_games, file) == num_games
+            && fread(_first_player_moves.data(), sizeof(uint8_t), num_games, file) == num_games
+            && fread(_bot_moves.data(), sizeof(uint8_t), num_games, file) == num_games
+            && fread(_timestamps.data(), sizeof(uint32_t), num_games, file) == num_games;
+    }
+    fclose(file);
+
+    for (size_t game_index = 0; success && game_index < num_games; ++game_index) {
+        uint64_t packed_moves = _packed_moves[game_index];
+        size_t num_moves = packed_moves & GAME_ARCHIVE_CELL_MASK;
+        Move first_player_move = static_cast<Move>(_first_player_moves[game_index]);
+        Move bot_move = static_cast<Move>(_bot_moves[game_index]);
+        success = num_moves <= NUM_ROWS * NUM_COLS
+            && _game_outcomes[game_index] < static_cast<uint8_t>(GameOutcome::UNKNOWN)
+            && OPPONENT_MOVE(first_player_move) != Move::EMPTY
+            && OPPONENT_MOVE(bot_move) != Move::EMPTY;
+        for (size_t move_index = 0; success && move_index < num_moves; ++move_index) {
+            success = ((packed_moves >> ((move_index + 1) * GAME_ARCHIVE_CELL_BITS)) & GAME_ARCHIVE_CELL_MASK) < NUM_ROWS * NUM_COLS;
+        }
+        if (success) {
+            _index_game(game_index);
+        }
+    }
+    if (!success) {
+        printf("GameArchive::load(): Invalid file = %s\n", filename.c_str());
+        clear();
+    }
+    return success;
+}
+
+void GameArchive::_index_game(size_t game_index) {
+    _set_bit(_game_outcome_bitmaps[_game_outcomes[game_index]], game_index);
+
+    uint64_t packed_moves = _packed_moves[game_index];
+    size_t num_moves = packed_moves & GAME_ARCHIVE_CELL_MASK;
+    std::vector<MovePosition> opening;
+    for (size_t move_index = 0; move_index < num_moves && move_index < GAME_ARCHIVE_NUM_OPENING_MOVES; ++move_index) {
+        size_t cell = (packed_moves >> ((move_index + 1) * GAME_ARCHIVE_CELL_BITS)) & GAME_ARCHIVE_CELL_MASK;
+        opening.push_back(std::make_pair(cell / NUM_COLS, cell % NUM_COLS));
+        _set_bit(_opening_bitmaps[move_index][_opening_key(opening, opening.size())], game_index);
+    }
+}
+
+bool GameArchive::_get_candidates(const GameArchiveQuery & query, Bitmap & candidates) const {
+    if (query.opening.size() > GAME_ARCHIVE_NUM_OPENING_MOVES) {
+        printf("GameArchive::_get_candidates(): Only the first %d moves are indexed.\n", GAME_ARCHIVE_NUM_OPENING_MOVES);
+        return false;
+    }
+    size_t num_games = this->num_games();
+    candidates.assign((num_games + 63) / 64, UINT64_MAX);
+    if (num_games % 64 != 0) {
+        candidates.back() = (uint64_t(1) << (num_games % 64)) - 1;
+    }
+
+    // Words past the end of a bitmap have no games set.
+    auto intersect = [&candidates](const Bitmap & bitmap) {
+        for (size_t word_index = 0; word_index < candidates.size(); ++word_index) {
+            candidates[word_index] &= word_index < bitmap.size() ? bitmap[word_index] : 0;
+        }
+    };
+    if (query.game_outcome != GameOutcome::UNKNOWN) {
+        intersect(_game_outcome_bitmaps[static_cast<size_t>(query.game_outcome)]);
+    }
+    if (!query.opening.empty()) {
+        const auto & opening_bitmaps = _opening_bitmaps[query.opening.size() - 1];
+        auto found = opening_bitmaps.find(_opening_key(query.opening, query.opening.size()));
+        if (found == opening_bitmaps.end()) {
+            return false;
+        }
+        intersect(found->second);
+    }
+    return true;
+}
+
+bool GameArchive::_matches_columns(const GameArchiveQuery & query, size_t game_index) const {
+    if (query.bot_move != Move::EMPTY && _bot_moves[game_index] != static_cast<uint8_t>(query.bot_move)) {
+        return false;
+    }
+    if (query.from_timestamp != 0 || query.to_timestamp != UINT32_MAX) {
+        uint32_t timestamp = _timestamps[game_index];
+        return timestamp >= query.from_timestamp && timestamp <= query.to_timestamp;
+    }
+    return true;
+}
+
+void GameArchive::_set_bit(Bitmap & bitmap, size_t index) {
+    if (bitmap.size() <= index / 64) {
+        bitmap.resize(index / 64 + 1, 0);
+    }
+    bitmap[index / 64] |= uint64_t(1) << (index % 64);
+}
+
+uint64_t GameArchive::_opening_key(const std::vector<MovePosition> & move_positions, size_t num_moves) {
+    // Replayed from the default first player whoever actually started, as
+    // the match boxes do, so that X and O openings share an index.
+    Grid grid;
+    for (size_t move_index = 0; move_index < num_moves; ++move_index) {
+        const MovePosition & move_position = move_positions.at(move_index);
+        if (move_position.first >= NUM_ROWS || move_position.second >= NUM_COLS
+            || !grid.set_value(move_position.first, move_position.second)) {
+            return UINT64_MAX;
+        }
+    }
+    return canonical_grid_index(grid);
+}
@@ -1,43 +1,111 @@
 #include "game_bot.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "grid.h"
+#include "metrics.h"
+#include "policy_snapshot.h"
+#include "seed_delta_buffer.h"
+#include "task_scheduler.h"
+#include "trace.h"
 
 #include <fstream>
 
-GameBot::GameBot() {
+// Match boxes handed to one merge task.
+#define SEED_DELTA_MERGE_GRAIN_SIZE (256)
+
+#define POLICY_MAGIC "TTTPLCY1"
+
+// Followed by the seeds of every match box in index order.
+struct PolicyHeader {
+    char magic[8];
+    uint32_t num_rows;
+    uint32_t num_cols;
+    uint64_t num_match_boxes;
+};
+
+static uint32_t _thread_random() {
+    // xorshift32, one generator per thread so that concurrent sessions
+    // never share (or lock) random state.
+    static thread_local uint32_t random_state = static_cast<uint32_t>(
+        std::hash<std::thread::id>()(std::this_thread::get_id()) ^ static_cast<size_t>(std::time(nullptr))) | 1;
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+GameBot::GameBot() :
+    _search_budget(0),
+    _policy_publish_interval(1),
+    _games_since_policy_publish(0),
+    _policy_version(0),
+    _seed_delta_merge_interval(64),
+    _shared_policy(nullptr),
+    _ntuple_network(nullptr)
+{
+    TRACE_SCOPE("GameBot::GameBot");
     Grid start_grid;
 
     _valid_grids.clear();
     _valid_grids[0].push_back(start_grid);
 
     size_t num_valid_grids = 0;
+    size_t num_match_boxes = 0;
     size_t num_valid_grids_by_rank[MAX_RANK + 1] = {0};
 
-    _find_valid_children(start_grid, _valid_grids);
+    {
+        TRACE_SCOPE("GameBot::_find_valid_children");
+        _find_valid_children(start_grid, _valid_grids);
+    }
 
     for (size_t rank = 0; rank < MAX_RANK + 1; ++rank) {
         num_valid_grids_by_rank[rank] = _valid_grids[rank].size();
         num_valid_grids += num_valid_grids_by_rank[rank];
 
         for (const Grid & valid_grid : _valid_grids[rank]) {
-            MatchBox match_box(valid_grid);
+            MatchBox match_box(valid_grid, num_match_boxes++);
             _match_boxes[rank].push_back(match_box);
         }
         printf("GameBot::GameBot(): Rank = %ld, num_valid_grids = %ld\n", rank, num_valid_grids_by_rank[rank]);
     }
     printf("GameBot::GameBot(): Valid grids found = %ld\n", num_valid_grids);
     fflush(stdout);
+
+    // The match box vectors do not change after this point.
+    _match_boxes_by_index.resize(num_match_boxes, nullptr);
+    for (auto & rank_match_boxes : _match_boxes) {
+        for (MatchBox & match_box : rank_match_boxes.second) {
+            _match_boxes_by_index.at(match_box.index()) = &match_box;
+        }
+    }
 }
 
 bool GameBot::get_next_move(const Grid & grid, MovePosition & position) {
+    return get_next_move(grid, position, _match_box_history);
+}
+
+bool GameBot::get_next_move(const Grid & grid, MovePosition & position, MatchBoxHistory & history) {
+    METRICS_SCOPED_TIMER(MetricTimer::GAME_BOT_GET_NEXT_MOVE);
+    if (_tablebase.is_loaded() && _probe_next_move(grid, position, history)) {
+        return true;
+    }
+    if (_search_budget.count() > 0 && _search_next_move(grid, position, history)) {
+        return true;
+    }
+
     bool valid_position = false;
     MatchBox * match_box = _find_match_box(grid);
     MovePosition position_before_transform;
@@ -52,56 +120,253 @@ bool GameBot::get_next_move(const Grid & grid, MovePosition & position) {
         }
         return false;
     }
-    position_before_transform = match_box->pick_random_move();
+    if (_policy_store) {
+        PolicyReadGuard guard(*_policy_store);
+        position_before_transform = guard.snapshot().sample_move(match_box->index(), _thread_random());
+    } else {
+        position_before_transform = match_box->pick_random_move();
+    }
     position = position_before_transform;
-    valid_position = _transform_position(match_box->get_grid(), grid, position);
+    valid_position = _transform_position(match_box->get_grid(), _match_box_frame(grid), position);
 
     if (valid_position) {
-        _match_box_history.push_back(match_box);
-        _move_position_history.push_back(position_before_transform);
+        history.record_move(match_box, position_before_transform);
     }
 
-    printf("GameBot::get_next_move(): GameBot wants to play %s at (%lu, %lu)\n", STR_MOVE(BOT_MOVE), position.first, position.second);
+    printf("GameBot::get_next_move(): GameBot wants to play %s at (%lu, %lu)\n", STR_MOVE(grid.next_player()), position.first, position.second);
     return valid_position;
 }
 
-void GameBot::finish_game(GameState game_state) {
-    assert(_match_box_history.size() == _move_position_history.size());
-    switch (game_state) {
-        case GameState::DRAW:
-            _reward_drawn_moves();
-            break;
-        case GameState::NOUGHT_WINS:
-            if (BOT_MOVE == Move::NOUGHT) {
-                _reward_moves();
-            } else {
-                _punish_moves();
-            }
+bool GameBot::get_seeded_move(const Grid & grid, uint32_t random_number, MovePosition & position) {
+    position = std::make_pair(NUM_ROWS, NUM_COLS);
+    if (grid.rank() >= _match_boxes.size()) {
+        return false;
+    }
+    GridTransformation grid_transformation = GridTransformation::GRID_UNEQUAL;
+    MatchBox * match_box = _find_match_box(grid, grid_transformation);
+    if (match_box == nullptr) {
+        return false;
+    }
+    if (_policy_store) {
+        PolicyReadGuard guard(*_policy_store);
+        position = guard.snapshot().sample_move(match_box->index(), random_number);
+    } else {
+        position = match_box->sample_move(random_number);
+    }
+    if (position.first >= NUM_ROWS || position.second >= NUM_COLS) {
+        return false;
+    }
+    return _transform_position(grid_transformation, position);
+}
+
+void GameBot::get_next_moves(const Grid * grids, MatchBoxHistory * const * histories, MovePosition * positions, bool * valid_positions, size_t num_grids) {
+    assert(grids != nullptr || num_grids == 0);
+    assert(positions != nullptr || num_grids == 0);
+    assert(valid_positions != nullptr || num_grids == 0);
+
+    // Counting sort of the batch by rank, so that every grid of one rank is
+    // matched against the same match box vector before moving to the next.
+    size_t grids_per_rank[MAX_RANK + 2] = {0};
+    for (size_t grid_index = 0; grid_index < num_grids; ++grid_index) {
+        size_t rank = grids[grid_index].rank();
+        assert(rank <= MAX_RANK);
+        ++grids_per_rank[rank + 1];
+    }
+    for (size_t rank = 1; rank < MAX_RANK + 2; ++rank) {
+        grids_per_rank[rank] += grids_per_rank[rank - 1];
+    }
+    std::vector<size_t> grid_order(num_grids);
+    for (size_t grid_index = 0; grid_index < num_grids; ++grid_index) {
+        grid_order[grids_per_rank[grids[grid_index].rank()]++] = grid_index;
+    }
+
+    // One snapshot serves the whole batch.
+    std::unique_ptr<PolicyReadGuard> guard;
+    const PolicySnapshot * snapshot = nullptr;
+    if (_policy_store) {
+        guard.reset(new PolicyReadGuard(*_policy_store));
+        snapshot = &guard->snapshot();
+    }
+
+    for (size_t grid_index : grid_order) {
+        const Grid & grid = grids[grid_index];
+        MovePosition & position = positions[grid_index];
+        valid_positions[grid_index] = false;
+        position = std::make_pair(NUM_ROWS, NUM_COLS);
+
+        if (grid.rank() >= _match_boxes.size()) {
+            continue;
+        }
+        GridTransformation grid_transformation = GridTransformation::GRID_UNEQUAL;
+        MatchBox * match_box = _find_match_box(grid, grid_transformation);
+        if (match_box == nullptr) {
+            continue;
+        }
+        uint32_t random_number = _thread_random();
+        MovePosition position_before_transform = snapshot != nullptr ?
+            snapshot->sample_move(match_box->index(), random_number) : match_box->sample_move(random_number);
+        if (position_before_transform.first >= NUM_ROWS || position_before_transform.second >= NUM_COLS) {
+            continue;
+        }
+        position = position_before_transform;
+        if (!_transform_position(grid_transformation, position)) {
+            continue;
+        }
+        valid_positions[grid_index] = true;
+
+        MatchBoxHistory * history = histories != nullptr ? histories[grid_index] : nullptr;
+        if (history != nullptr) {
+            history->record_move(match_box, position_before_transform);
+        }
+    }
+}
+
+void GameBot::finish_game(GameState game_state, Move side) {
+    finish_game(game_state, _match_box_history, side);
+}
+
+void GameBot::finish_game(GameState game_state, MatchBoxHistory & history, Move side) {
+    METRICS_SCOPED_TIMER(MetricTimer::GAME_BOT_FINISH_GAME);
+    METRICS_COUNTER_ADD(MetricCounter::GAME_BOT_FINISHED_GAMES, 1);
+    if (_ntuple_network != nullptr) {
+        _train_ntuple_network(game_state, history, side);
+    }
+    switch (side) {
+        case Move::CROSS:
+            _finish_game<Move::CROSS>(game_state, history);
             break;
-        case GameState::CROSS_WINS:
-            if (BOT_MOVE == Move::CROSS) {
-                _reward_moves();
-            } else {
-                _punish_moves();
-            }
+        case Move::NOUGHT:
+            _finish_game<Move::NOUGHT>(game_state, history);
             break;
-        case GameState::ONGOING:
-        case GameState::INVALID:
+        case Move::EMPTY:
         default:
-            // Shouldn't be here
+            printf("GameBot::finish_game(): Invalid side = %s\n", STR_MOVE(side));
             return;
     }
-    _match_box_history.clear();
-    _move_position_history.clear();
+
+    if (_policy_store && ++_games_since_policy_publish >= _policy_publish_interval) {
+        publish_policy();
+    }
+}
+
+void GameBot::finish_game(GameState game_state, MatchBoxHistory & history, SeedDeltaBuffer & delta_buffer, Move side) {
+    METRICS_SCOPED_TIMER(MetricTimer::GAME_BOT_FINISH_GAME);
+    METRICS_COUNTER_ADD(MetricCounter::GAME_BOT_FINISHED_GAMES, 1);
+    if (_ntuple_network != nullptr) {
+        _train_ntuple_network(game_state, history, side);
+    }
+    switch (side) {
+        case Move::CROSS:
+            _finish_game<Move::CROSS>(game_state, history, delta_buffer);
+            break;
+        case Move::NOUGHT:
+            _finish_game<Move::NOUGHT>(game_state, history, delta_buffer);
+            break;
+        case Move::EMPTY:
+        default:
+            printf("GameBot::finish_game(): Invalid side = %s\n", STR_MOVE(side));
+            break;
+    }
+}
+
+void GameBot::merge_seed_deltas(const std::vector<SeedDeltaBuffer *> & delta_buffers, TaskScheduler & scheduler) {
+    TRACE_SCOPE("GameBot::merge_seed_deltas");
+    // Every task owns a disjoint range of match box indices, so the match
+    // boxes are written without locks. The buffers are only read here.
+    scheduler.parallel_for(0, _match_boxes_by_index.size(), SEED_DELTA_MERGE_GRAIN_SIZE, [&](size_t begin, size_t end) {
+        for (size_t match_box_index = begin; match_box_index < end; ++match_box_index) {
+            int32_t rewards[NUM_ROWS][NUM_COLS] = {{0}};
+            int32_t punishments[NUM_ROWS][NUM_COLS] = {{0}};
+            bool touched = false;
+            for (const SeedDeltaBuffer * delta_buffer : delta_buffers) {
+                const SeedDelta * delta = delta_buffer->find(match_box_index);
+                if (delta == nullptr) {
+                    continue;
+                }
+                touched = true;
+                for (size_t row = 0; row < NUM_ROWS; ++row) {
+                    for (size_t col = 0; col < NUM_COLS; ++col) {
+                        rewards[row][col] += delta->rewards[row][col];
+                        punishments[row][col] += delta->punishments[row][col];
+                    }
+                }
+            }
+            if (!touched) {
+                continue;
+            }
+
+            MatchBox * match_box = _match_boxes_by_index[match_box_index];
+            for (size_t row = 0; row < NUM_ROWS; ++row) {
+                for (size_t col = 0; col < NUM_COLS; ++col) {
+                    if (rewards[row][col] == 0 && punishments[row][col] == 0) {
+                        continue;
+                    }
+                    if (_shared_policy != nullptr) {
+                        _shared_policy->apply_seed_delta(_canonical_keys[match_box_index],
+                            _canonical_cells[match_box_index][row * NUM_COLS + col], rewards[row][col], punishments[row][col]);
+                    } else {
+                        match_box->apply_seed_delta(std::make_pair(row, col), rewards[row][col], punishments[row][col]);
+                    }
+                }
+            }
+        }
+    });
+
+    size_t num_games = 0;
+    for (SeedDeltaBuffer * delta_buffer : delta_buffers) {
+        num_games += delta_buffer->num_games();
+        delta_buffer->clear();
+    }
+    if (_shared_policy != nullptr) {
+        // The segment now holds the updates of every trainer; play on from it.
+        _shared_policy->finish_merge(num_games);
+        load_shared_policy(*_shared_policy);
+        return;
+    }
+    publish_policy();
+}
+
+void GameBot::set_seed_delta_merge_interval(size_t merge_interval) {
+    _seed_delta_merge_interval = merge_interval > 0 ? merge_interval : 1;
+}
+
+void GameBot::train_self_play(size_t num_games, TaskScheduler & scheduler) {
+    size_t num_workers = scheduler.num_workers();
+    std::vector<SeedDeltaBuffer> delta_buffers(num_workers);
+    std::vector<SeedDeltaBuffer *> delta_buffer_pointers;
+    for (SeedDeltaBuffer & delta_buffer : delta_buffers) {
+        delta_buffer_pointers.push_back(&delta_buffer);
+    }
+
+    // Each round plays up to the merge interval of games per worker while
+    // the match boxes are only read, then merges all buffers at once.
+    size_t num_games_played = 0;
+    while (num_games_played < num_games) {
+        size_t num_round_games = std::min(num_games - num_games_played, num_workers * _seed_delta_merge_interval);
+        scheduler.parallel_for(0, num_workers, 1, [&](size_t begin, size_t end) {
+            TRACE_SCOPE("GameBot::_play_self_play_game");
+            for (size_t worker_index = begin; worker_index < end; ++worker_index) {
+                size_t num_worker_games = num_round_games / num_workers + (worker_index < num_round_games % num_workers ? 1 : 0);
+                for (size_t game_index = 0; game_index < num_worker_games; ++game_index) {
+                    _play_self_play_game(delta_buffers[worker_index]);
+                }
+            }
+        });
+        merge_seed_deltas(delta_buffer_pointers, scheduler);
+        num_games_played += num_round_games;
+    }
+    printf("GameBot::train_self_play(): Played %lu games\n", num_games_played);
 }
 
-void GameBot::load_move_history(const std::vector<Move> move_history, const std::vector<MovePosition> move_position_history) {
+void GameBot::load_move_history(const std::vector<Move> move_history, const std::vector<MovePosition> move_position_history, Move first_player_move, Move bot_move) {
+    METRICS_SCOPED_TIMER(MetricTimer::GAME_BOT_LOAD_MOVE_HISTORY);
+    TRACE_SCOPE("GameBot::load_move_history");
+    METRICS_COUNTER_ADD(MetricCounter::GAME_BOT_REPLAYED_MOVES, move_history.size());
     assert(move_history.size() == move_position_history.size());
 
     _match_box_history.clear();
-    _move_position_history.clear();
 
-    Grid grid;
+    Grid grid(first_player_move);
     for (size_t move_index = 0; move_index < move_history.size(); ++move_index) {
         const Move move = move_history.at(move_index);
         const size_t row_index = move_position_history.at(move_index).first;
@@ -118,7 +383,7 @@ void GameBot::load_move_history(const std::vector<Move> move_history, const std:
         if (grid_before_move.rank() >= _match_boxes.size()) {
             break;
         }
-        if (move != BOT_MOVE) {
+        if (move != bot_move) {
             continue;
         }
         if (grid_before_move.has_game_ended()) {
@@ -131,76 +396,425 @@ void GameBot::load_move_history(const std::vector<Move> move_history, const std:
         match_box->get_grid().print_grid();
 
         MovePosition transformed_position(row_index, col_index);
-        _transform_position(grid_before_move, match_box->get_grid(), transformed_position);
+        _transform_position(_match_box_frame(grid_before_move), match_box->get_grid(), transformed_position);
 
         printf("Transformed position: (%lu, %lu)\n", transformed_position.first, transformed_position.second);
-        _match_box_history.push_back(match_box);
-        _move_position_history.push_back(transformed_position);
+        _match_box_history.record_move(match_box, transformed_position);
+    }
+}
+
+bool GameBot::get_move_priors(const Grid & grid, float priors[NUM_ROWS][NUM_COLS]) {
+    for (size_t row = 0; row < NUM_ROWS; ++row) {
+        for (size_t col = 0; col < NUM_COLS; ++col) {
+            priors[row][col] = 0.0f;
+        }
+    }
+    if (grid.rank() >= _match_boxes.size()) {
+        return false;
+    }
+    GridTransformation grid_transformation = GridTransformation::GRID_UNEQUAL;
+    MatchBox * match_box = _find_match_box(grid, grid_transformation);
+    if (match_box == nullptr) {
+        return false;
+    }
+
+    MatchBoxSeeds seeds;
+    if (_policy_store) {
+        PolicyReadGuard guard(*_policy_store);
+        seeds = guard.snapshot().seeds(match_box->index());
+    } else {
+        seeds = match_box->get_seeds();
+    }
+
+    float total_remaining_seeds = 0.0f;
+    for (size_t row = 0; row < NUM_ROWS; ++row) {
+        for (size_t col = 0; col < NUM_COLS; ++col) {
+            MovePosition position(row, col);
+            int8_t remaining_seeds = seeds.remaining_seeds[row][col];
+            if (remaining_seeds <= 0 || !_transform_position(grid_transformation, position)) {
+                continue;
+            }
+            priors[position.first][position.second] += remaining_seeds;
+            total_remaining_seeds += remaining_seeds;
+        }
+    }
+    if (total_remaining_seeds <= 0.0f) {
+        return false;
+    }
+    for (size_t row = 0; row < NUM_ROWS; ++row) {
+        for (size_t col = 0; col < NUM_COLS; ++col) {
+            priors[row][col] /= total_remaining_seeds;
+        }
+    }
+    return true;
+}
+
+bool GameBot::load_tablebase(const std::string & filename) {
+    return _tablebase.load(filename);
+}
+
+void GameBot::set_search_budget(std::chrono::microseconds search_budget) {
+    _search_budget = search_budget;
+}
+
+void GameBot::set_search_stop_flag(const std::atomic<bool> * stop_flag) {
+    _anytime_search.set_stop_flag(stop_flag);
+}
+
+SearchStatistics GameBot::get_search_statistics() const {
+    return _anytime_search.get_statistics();
+}
+
+void GameBot::enable_policy_snapshots(size_t publish_interval) {
+    _policy_publish_interval = publish_interval > 0 ? publish_interval : 1;
+    _games_since_policy_publish = 0;
+    if (!_policy_store) {
+        _policy_store.reset(new PolicyStore(_create_policy_snapshot()));
+    }
+}
+
+void GameBot::publish_policy() {
+    if (!_policy_store) {
+        return;
+    }
+    TRACE_SCOPE("GameBot::publish_policy");
+    ++_policy_version;
+    _policy_store->publish(_create_policy_snapshot());
+    _games_since_policy_publish = 0;
+}
+
+uint64_t GameBot::get_policy_version() const {
+    return _policy_store ? _policy_store->version() : _policy_version;
+}
+
+bool GameBot::save_policy(const std::string & filename) const {
+    PolicyHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, POLICY_MAGIC, sizeof(header.magic));
+    header.num_rows = NUM_ROWS;
+    header.num_cols = NUM_COLS;
+    header.num_match_boxes = _match_boxes_by_index.size();
+
+    std::vector<MatchBoxSeeds> seeds;
+    seeds.reserve(_match_boxes_by_index.size());
+    for (const MatchBox * match_box : _match_boxes_by_index) {
+        seeds.push_back(match_box->get_seeds());
+    }
+
+    FILE * file = fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        printf("GameBot::save_policy(): Cannot open file = %s\n", filename.c_str());
+        return false;
+    }
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(seeds.data(), sizeof(MatchBoxSeeds), seeds.size(), file) == seeds.size();
+    fclose(file);
+    if (!success) {
+        printf("GameBot::save_policy(): Cannot write file = %s\n", filename.c_str());
+    }
+    return success;
+}
+
+bool GameBot::load_policy(const std::string & filename) {
+    FILE * file = fopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+        printf("GameBot::load_policy(): Cannot open file = %s\n", filename.c_str());
+        return false;
+    }
+    PolicyHeader header;
+    std::vector<MatchBoxSeeds> seeds(_match_boxes_by_index.size());
+    bool success = fread(&header, sizeof(header), 1, file) == 1
+        && memcmp(header.magic, POLICY_MAGIC, sizeof(header.magic)) == 0
+        && header.num_rows == NUM_ROWS
+        && header.num_cols == NUM_COLS
+        && header.num_match_boxes == seeds.size()
+        && fread(seeds.data(), sizeof(MatchBoxSeeds), seeds.size(), file) == seeds.size();
+    fclose(file);
+    if (!success) {
+        printf("GameBot::load_policy(): Invalid policy file = %s\n", filename.c_str());
+        return false;
+    }
+
+    for (size_t match_box_index = 0; match_box_index < seeds.size(); ++match_box_index) {
+        _match_boxes_by_index[match_box_index]->set_seeds(seeds[match_box_index]);
+    }
+    publish_policy();
+    return true;
+}
+
+bool GameBot::export_policy_header(const std::string & filename, bool export_seeds) const {
+    // One entry per canonical position, seeds moved into the canonical
+    // frame, sorted by key so FrozenBot can binary search.
+    std::map<uint64_t, MatchBoxSeeds> canonical_seeds;
+    for (const MatchBox * match_box : _match_boxes_by_index) {
+        GridTransformation grid_transformation = GridTransformation::GRID_EQUAL;
+        uint64_t key = canonical_grid_index(match_box->get_grid(), grid_transformation);
+        MatchBoxSeeds seeds = match_box->get_seeds();
+        MatchBoxSeeds & key_seeds = canonical_seeds[key];
+        for (size_t row = 0; row < NUM_ROWS; ++row) {
+            for (size_t col = 0; col < NUM_COLS; ++col) {
+                MovePosition source = grid_symmetry_source(grid_transformation, row, col);
+                key_seeds.remaining_seeds[row][col] = seeds.remaining_seeds[source.first][source.second];
+            }
+        }
+    }
+
+    FILE * file = fopen(filename.c_str(), "w");
+    if (file == nullptr) {
+        printf("GameBot::export_policy_header(): Cannot open file = %s\n", filename.c_str());
+        return false;
+    }
+    fprintf(file, "// Generated by GameBot::export_policy_header(). Do not edit.\n");
+    fprintf(file, "#ifndef FROZEN_POLICY_H\n#define FROZEN_POLICY_H\n\n#include <cstddef>\n#include <cstdint>\n\n");
+    fprintf(file, "#define FROZEN_POLICY_NUM_ROWS (%d)\n", NUM_ROWS);
+    fprintf(file, "#define FROZEN_POLICY_NUM_COLS (%d)\n", NUM_COLS);
+    fprintf(file, "#define FROZEN_POLICY_NUM_POSITIONS (%lu)\n", canonical_seeds.size());
+    fprintf(file, "#define FROZEN_POLICY_VERSION (%lu)\n", get_policy_version());
+    fprintf(file, "#define FROZEN_POLICY_HAS_SEEDS (%d)\n\n", export_seeds ? 1 : 0);
+
+    // canonical_grid_index() of every position, ascending.
+    fprintf(file, "constexpr uint32_t FROZEN_POLICY_KEYS[FROZEN_POLICY_NUM_POSITIONS] = {");
+    size_t position_index = 0;
+    for (const auto & key_seeds : canonical_seeds) {
+        fprintf(file, "%s%lu,", position_index++ % 12 == 0 ? "\n    " : " ", key_seeds.first);
+    }
+    fprintf(file, "\n};\n\n");
+
+    // Cell row * NUM_COLS + col with the most seeds, in the canonical frame.
+    fprintf(file, "constexpr uint8_t FROZEN_POLICY_MOVES[FROZEN_POLICY_NUM_POSITIONS] = {");
+    position_index = 0;
+    for (const auto & key_seeds : canonical_seeds) {
+        size_t best_cell = 0;
+        int8_t best_seeds = 0;
+        for (size_t cell = 0; cell < NUM_ROWS * NUM_COLS; ++cell) {
+            int8_t seeds = key_seeds.second.remaining_seeds[cell / NUM_COLS][cell % NUM_COLS];
+            if (seeds > best_seeds) {
+                best_seeds = seeds;
+                best_cell = cell;
+            }
+        }
+        fprintf(file, "%s%lu,", position_index++ % 16 == 0 ? "\n    " : " ", best_cell);
+    }
+    fprintf(file, "\n};\n");
+
+    if (export_seeds) {
+        // Remaining seeds per cell, in the canonical frame.
+        fprintf(file, "\nconstexpr int8_t FROZEN_POLICY_SEEDS[FROZEN_POLICY_NUM_POSITIONS][FROZEN_POLICY_NUM_ROWS * FROZEN_POLICY_NUM_COLS] = {\n");
+        for (const auto & key_seeds : canonical_seeds) {
+            fprintf(file, "    {");
+            for (size_t cell = 0; cell < NUM_ROWS * NUM_COLS; ++cell) {
+                fprintf(file, "%s%d", cell == 0 ? "" : ", ", key_seeds.second.remaining_seeds[cell / NUM_COLS][cell % NUM_COLS]);
+            }
+            fprintf(file, "},\n");
+        }
+        fprintf(file, "};\n");
+    }
+    fprintf(file, "\n#endif // FROZEN_POLICY_H\n");
+
+    bool success = fclose(file) == 0;
+    if (!success) {
+        printf("GameBot::export_policy_header(): Cannot write file = %s\n", filename.c_str());
+    }
+    return success;
+}
+
+void GameBot::store_shared_policy(SharedPolicySegment & segment) {
+    _compute_canonical_cells();
+    for (size_t match_box_index = 0; match_box_index < _match_boxes_by_index.size(); ++match_box_index) {
+        MatchBoxSeeds seeds = _match_boxes_by_index[match_box_index]->get_seeds();
+        for (size_t cell = 0; cell < MAX_RANK; ++cell) {
+            segment.set_seeds(_canonical_keys[match_box_index], _canonical_cells[match_box_index][cell],
+                seeds.remaining_seeds[cell / NUM_COLS][cell % NUM_COLS]);
+        }
+    }
+}
+
+void GameBot::load_shared_policy(const SharedPolicySegment & segment) {
+    _compute_canonical_cells();
+    for (size_t match_box_index = 0; match_box_index < _match_boxes_by_index.size(); ++match_box_index) {
+        MatchBoxSeeds seeds;
+        for (size_t cell = 0; cell < MAX_RANK; ++cell) {
+            seeds.remaining_seeds[cell / NUM_COLS][cell % NUM_COLS] =
+                segment.seeds(_canonical_keys[match_box_index], _canonical_cells[match_box_index][cell]);
+        }
+        _match_boxes_by_index[match_box_index]->set_seeds(seeds);
+    }
+    publish_policy();
+}
+
+void GameBot::attach_shared_policy(SharedPolicySegment * segment) {
+    _shared_policy = segment;
+    if (_shared_policy != nullptr) {
+        load_shared_policy(*_shared_policy);
+    }
+}
+
+void GameBot::attach_ntuple_network(NTupleNetwork * network) {
+    _ntuple_network = network;
+    if (_ntuple_network == nullptr) {
+        _anytime_search.set_leaf_evaluator(nullptr);
+        return;
+    }
+    // The network scores afterstates for the player who just moved.
+    _anytime_search.set_leaf_evaluator([network](const Grid & grid, Move player) {
+        return static_cast<int32_t>(-network->evaluate(grid, OPPONENT_MOVE(player)) * NTUPLE_SEARCH_SCALE);
+    });
+}
+
+void GameBot::_train_ntuple_network(GameState game_state, const MatchBoxHistory & history, Move side) {
+    if (history.empty() || game_state == GameState::ONGOING || game_state == GameState::INVALID) {
+        return;
+    }
+    float outcome = 0.0f;
+    if (game_state != GameState::DRAW) {
+        outcome = (game_state == GameState::CROSS_WINS) == (side == Move::CROSS) ? 1.0f : -1.0f;
+    }
+    // Replayed in the match box frame, where the bot may hold the other
+    // symbol; the network only tells own marks from the opponent's.
+    std::vector<Grid> afterstates;
+    Move player = history.match_box(0)->get_grid().next_player();
+    for (size_t move_index = 0; move_index < history.size(); ++move_index) {
+        Grid afterstate = history.match_box(move_index)->get_grid();
+        MovePosition move_position = history.move_position(move_index);
+        afterstate.make_move(static_cast<int8_t>(move_position.first), static_cast<int8_t>(move_position.second), player);
+        afterstates.push_back(afterstate);
+    }
+    _ntuple_network->train_game(afterstates, player, outcome);
+}
+
+void GameBot::_compute_canonical_cells() {
+    if (!_canonical_keys.empty()) {
+        return;
+    }
+    // The same frame as export_policy_header(): canonical cell (row, col)
+    // holds the seeds of grid_symmetry_source() in the match box.
+    _canonical_keys.resize(_match_boxes_by_index.size());
+    _canonical_cells.resize(_match_boxes_by_index.size());
+    for (size_t match_box_index = 0; match_box_index < _match_boxes_by_index.size(); ++match_box_index) {
+        GridTransformation grid_transformation = GridTransformation::GRID_EQUAL;
+        _canonical_keys[match_box_index] = canonical_grid_index(_match_boxes_by_index[match_box_index]->get_grid(), grid_transformation);
+        for (size_t row = 0; row < NUM_ROWS; ++row) {
+            for (size_t col = 0; col < NUM_COLS; ++col) {
+                MovePosition source = grid_symmetry_source(grid_transformation, row, col);
+                _canonical_cells[match_box_index][source.first * NUM_COLS + source.second] = static_cast<uint8_t>(row * NUM_COLS + col);
+            }
+        }
+    }
+}
+
+PolicySnapshot * GameBot::_create_policy_snapshot() const {
+    TRACE_SCOPE("GameBot::_create_policy_snapshot");
+    std::vector<MatchBoxSeeds> seeds;
+    seeds.reserve(_match_boxes_by_index.size());
+    for (const MatchBox * match_box : _match_boxes_by_index) {
+        seeds.push_back(match_box->get_seeds());
+    }
+    return new PolicySnapshot(_policy_version, std::move(seeds));
+}
+
+bool GameBot::_search_next_move(const Grid & grid, MovePosition & position, MatchBoxHistory & history) {
+    bool found = _anytime_search.search(grid, _search_budget, position);
+    SearchStatistics statistics = _anytime_search.get_statistics();
+    printf("GameBot::_search_next_move(): nodes_searched = %lu, depth_reached = %lu, solved = %d\n",
+           statistics.nodes_searched, statistics.depth_reached, statistics.solved);
+    if (!found) {
+        printf("GameBot::_search_next_move(): No search result within %ld us. Falling back to match boxes.\n",
+               static_cast<long>(_search_budget.count()));
+        return false;
+    }
+
+    _record_chosen_move(grid, position, history);
+
+    printf("GameBot::get_next_move(): GameBot wants to play %s at (%lu, %lu)\n", STR_MOVE(grid.next_player()), position.first, position.second);
+    return true;
+}
+
+bool GameBot::_probe_next_move(const Grid & grid, MovePosition & position, MatchBoxHistory & history) {
+    TablebaseResult result = TablebaseResult::UNKNOWN;
+    uint8_t distance = 0;
+    if (!_tablebase.probe(grid, result, distance) || !_tablebase.get_best_move(grid, position)) {
+        return false;
+    }
+    printf("GameBot::_probe_next_move(): Tablebase result = %s in %d moves\n", STR_TABLEBASE_RESULT(result), distance);
+
+    _record_chosen_move(grid, position, history);
+
+    printf("GameBot::get_next_move(): GameBot wants to play %s at (%lu, %lu)\n", STR_MOVE(grid.next_player()), position.first, position.second);
+    return true;
+}
+
+void GameBot::_record_chosen_move(const Grid & grid, MovePosition position, MatchBoxHistory & history) {
+    // Keep training the match boxes on moves picked elsewhere as if they
+    // had picked them themselves.
+    if (grid.rank() >= _match_boxes.size()) {
+        return;
+    }
+    MatchBox * match_box = _find_match_box(grid);
+    if (match_box == nullptr) {
+        return;
+    }
+    if (_transform_position(_match_box_frame(grid), match_box->get_grid(), position)) {
+        history.record_move(match_box, position);
     }
 }
 
 bool GameBot::_transform_position(const Grid & grid, const Grid & match_box_grid, MovePosition & position) {
+    GridTransformation grid_transformation = _get_grid_transformation(grid, match_box_grid);
+    printf("GameBot::_transform_position(): %s\n", STR_GRID_TRANSFORMATION(grid_transformation));
+    return _transform_position(grid_transformation, position);
+}
+
+bool GameBot::_transform_position(GridTransformation grid_transformation, MovePosition & position) {
     size_t row_index = position.first;
     size_t col_index = position.second;
     assert(row_index < NUM_ROWS);
     assert(col_index < NUM_COLS);
 
-    GridTransformation grid_transformation = _get_grid_transformation(grid, match_box_grid);
     switch (grid_transformation) {
         case GridTransformation::GRID_UNEQUAL: {
-            printf("GameBot::_transform_position(): GRID_UNEQUAL\n");
             return false;
         }
         case GridTransformation::GRID_ROTATION_180: {
-            printf("GameBot::_transform_position(): GRID_ROTATION_180\n");
             position.first = NUM_COLS - col_index - 1;
             position.second = NUM_ROWS - row_index - 1;
             return true;
         }
         case GridTransformation::GRID_ROTATION_LEFT: {
-            printf("GameBot::_transform_position(): GRID_ROTATION_LEFT\n");
             position.first = NUM_COLS - col_index - 1;
             position.second = row_index;
             return true;
         }
         case GridTransformation::GRID_ROTATION_RIGHT: {
-            printf("GameBot::_transform_position(): GRID_ROTATION_RIGHT\n");
             position.first = col_index;
             position.second = NUM_ROWS - row_index - 1;
             return true;
         }
         case GridTransformation::GRID_REFLECTION_X: {
-            printf("GameBot::_transform_position(): GRID_REFLECTION_X\n");
             position.first = NUM_ROWS - row_index - 1;
             position.second = col_index;
             return true;
         }
         case GridTransformation::GRID_REFLECTION_Y: {
-            printf("GameBot::_transform_position(): GRID_REFLECTION_Y\n");
             position.first = row_index;
             position.second = NUM_COLS - col_index - 1;
             return true;
         }
         case GridTransformation::GRID_REFLECTION_DIAG: {
-            printf("GameBot::_transform_position(): GRID_REFLECTION_DIAG\n");
             position.first = NUM_COLS - row_index - 1;
             position.second = NUM_ROWS - col_index - 1;
             return true;
         }
         case GridTransformation::GRID_REFLECTION_DIAG_1: {
-            printf("GameBot::_transform_position(): GRID_REFLECTION_DIAG_1\n");
             position.first = col_index;
             position.second = row_index;
             return true;
         }
         case GridTransformation::GRID_REFLECTION_DIAG_2: {
-            printf("GameBot::_transform_position(): GRID_REFLECTION_DIAG_2\n");
             position.first = NUM_COLS - col_index - 1;
             position.second = NUM_ROWS - row_index - 1;
             return true;
         }
         case GridTransformation::GRID_EQUAL: {
-            printf("GameBot::_transform_position(): GRID_EQUAL\n");
             return true;
         }
         default:
@@ -210,20 +824,36 @@ bool GameBot::_transform_position(const Grid & grid, const Grid & match_box_grid
 }
 
 MatchBox * GameBot::_find_match_box(const Grid & grid) {
-    MatchBox * match_box = nullptr;
+    GridTransformation grid_transformation = GridTransformation::GRID_UNEQUAL;
+    return _find_match_box(grid, grid_transformation);
+}
+
+MatchBox * GameBot::_find_match_box(const Grid & grid, GridTransformation & grid_transformation) {
+    if (grid.first_player() != DEFAULT_FIRST_PLAYER_MOVE) {
+        return _find_match_box(_match_box_frame(grid), grid_transformation);
+    }
+    METRICS_SCOPED_TIMER(MetricTimer::GAME_BOT_FIND_MATCH_BOX);
     size_t rank = grid.rank();
     assert(rank < _match_boxes.size());
 
     for (MatchBox & current_match_box : _match_boxes.at(rank)) {
-        if (_check_grids_equal(current_match_box.get_grid(), grid)) {
-            match_box = &current_match_box;
-
-            return match_box;
+        grid_transformation = _get_grid_transformation(current_match_box.get_grid(), grid);
+        if (grid_transformation != GridTransformation::GRID_UNEQUAL) {
+            return &current_match_box;
         }
     }
+    grid_transformation = GridTransformation::GRID_UNEQUAL;
+    METRICS_COUNTER_ADD(MetricCounter::GAME_BOT_MATCH_BOX_MISSES, 1);
     return nullptr;
 }
 
+Grid GameBot::_match_box_frame(const Grid & grid) {
+    // Match boxes hold games started by DEFAULT_FIRST_PLAYER_MOVE. Swapping
+    // the symbols maps a game started by the other side onto them without
+    // moving any cell.
+    return grid.first_player() == DEFAULT_FIRST_PLAYER_MOVE ? grid : grid.swapped_players();
+}
+
 bool GameBot::_check_grids_equal(const Grid & first, const Grid & second) {
     if (_get_grid_transformation(first, second) != GridTransformation::GRID_UNEQUAL) {
         return true;
@@ -232,61 +862,7 @@ bool GameBot::_check_grids_equal(const Grid & first, const Grid & second) {
 }
 
 GridTransformation GameBot::_get_grid_transformation(const Grid & first, const Grid & second) {
-    if (first == second) {
-        return GridTransformation::GRID_EQUAL;
-    }
-    bool symmetric = true, rotation_180 = true, rotation_left = true, rotation_right = true, reflection_x = true, reflection_y = true;
-    bool reflection_diag = true, reflection_diag_1 = true, reflection_diag_2 = true;
-    for (size_t row = 0; row < NUM_ROWS && symmetric; ++row) {
-        for (size_t col = 0; col < NUM_COLS && symmetric; ++col) {
-            if (NUM_ROWS == NUM_COLS && first.value(row, col) != second.value(NUM_COLS - col - 1, NUM_ROWS - row - 1)) {
-                rotation_180 = false;
-            }
-            if (NUM_ROWS == NUM_COLS && first.value(row, col) != second.value(NUM_COLS - col - 1, row)) {
-                rotation_left = false;
-            }
-            if (NUM_ROWS == NUM_COLS && first.value(row, col) != second.value(col, NUM_ROWS - row - 1)) {
-                rotation_right = false;
-            }
-            if (first.value(row, col) != second.value(NUM_ROWS - row - 1, col)) {
-                reflection_x = false;
-            }
-            if (first.value(row, col) != second.value(row, NUM_COLS - col - 1)) {
-                reflection_y = false;
-            }
-            if (NUM_ROWS == NUM_COLS && first.value(row, col) != second.value(NUM_COLS - row - 1, NUM_ROWS - col - 1)) {
-                reflection_diag = false;
-            }
-            if (NUM_ROWS == NUM_COLS && first.value(row, col) != second.value(col, row)) {
-                reflection_diag_1 = false;
-            }
-            if (NUM_ROWS == NUM_COLS && first.value(row, col) != second.value(NUM_COLS - col - 1, NUM_ROWS - row - 1)) {
-                reflection_diag_2 = false;
-            }
-            symmetric = rotation_180 || rotation_left || rotation_right || reflection_x || reflection_y || 
-            reflection_diag || reflection_diag_1 || reflection_diag_2;
-        }
-    }
-
-    if (rotation_180) {
-        return GridTransformation::GRID_ROTATION_180;
-    } else if (rotation_left) {
-        return GridTransformation::GRID_ROTATION_LEFT;
-    } else if (rotation_right) {
-        return GridTransformation::GRID_ROTATION_RIGHT;
-    } else if (reflection_x) {
-        return GridTransformation::GRID_REFLECTION_X;
-    } else if (reflection_y) {
-        return GridTransformation::GRID_REFLECTION_Y;
-    } else if (reflection_diag) {
-        return GridTransformation::GRID_REFLECTION_DIAG;
-    } else if (reflection_diag_1) {
-        return GridTransformation::GRID_REFLECTION_DIAG_1;
-    } else if (reflection_diag_2) {
-        return GridTransformation::GRID_REFLECTION_DIAG_2;
-    }else {
-        return GridTransformation::GRID_UNEQUAL;
-    }
+    return find_grid_transformation(first, second);
 }
 
 bool GameBot::_check_grid_unique(const std::vector<Grid> & unique_grids, const Grid & grid) {
@@ -297,10 +873,66 @@ bool GameBot::_check_grid_unique(const std::vector<Grid> & unique_grids, const G
     }
     return true;
 }
-void GameBot::_punish_moves() {
-    for (size_t match_box_index = 0; match_box_index < _match_box_history.size(); ++match_box_index) {
-        MatchBox * match_box = _match_box_history.at(match_box_index);
-        MovePosition move_position = _move_position_history.at(match_box_index);
+void GameBot::_play_self_play_game(SeedDeltaBuffer & delta_buffer) {
+    Grid grid;
+    MatchBoxHistory cross_history, nought_history;
+    while (!grid.has_game_ended()) {
+        // Both sides play from the match boxes and both learn from the game.
+        MatchBoxHistory * move_history = grid.next_player() == Move::CROSS ? &cross_history : &nought_history;
+        MovePosition position;
+        bool valid_position = false;
+        get_next_moves(&grid, &move_history, &position, &valid_position, 1);
+        if (!valid_position) {
+            return;
+        }
+        grid.set_value(position.first, position.second);
+    }
+    finish_game(grid.game_state(), cross_history, delta_buffer, Move::CROSS);
+    finish_game(grid.game_state(), nought_history, delta_buffer, Move::NOUGHT);
+    delta_buffer.finish_game();
+}
+
+template <Move Side>
+void GameBot::_finish_game(GameState game_state, MatchBoxHistory & history) {
+    if (game_state == GameState::DRAW) {
+        _reward_drawn_moves(history);
+    } else if (game_state == MoveSide<Side>::WINS) {
+        _reward_moves(history);
+    } else if (game_state == MoveSide<Side>::LOSES) {
+        _punish_moves(history);
+    } else {
+        // Shouldn't be here
+        return;
+    }
+    history.clear();
+}
+
+template <Move Side>
+void GameBot::_finish_game(GameState game_state, MatchBoxHistory & history, SeedDeltaBuffer & delta_buffer) {
+    if (game_state != GameState::DRAW && game_state != MoveSide<Side>::WINS && game_state != MoveSide<Side>::LOSES) {
+        // Shouldn't be here
+        return;
+    }
+    for (size_t match_box_index = 0; match_box_index < history.size(); ++match_box_index) {
+        const MatchBox * match_box = history.match_box(match_box_index);
+        MovePosition move_position = history.move_position(match_box_index);
+        assert(match_box != nullptr);
+
+        if (game_state == GameState::DRAW) {
+            delta_buffer.reward(match_box->index(), move_position, MATCH_BOX_DRAW_REWARD);
+        } else if (game_state == MoveSide<Side>::WINS) {
+            delta_buffer.reward(match_box->index(), move_position, MATCH_BOX_WIN_REWARD);
+        } else {
+            delta_buffer.punish(match_box->index(), move_position, MATCH_BOX_LOSS_PENALTY);
+        }
+    }
+    history.clear();
+}
+
+void GameBot::_punish_moves(const MatchBoxHistory & history) {
+    for (size_t match_box_index = 0; match_box_index < history.size(); ++match_box_index) {
+        MatchBox * match_box = history.match_box(match_box_index);
+        MovePosition move_position = history.move_position(match_box_index);
         assert(match_box != nullptr);
 
         printf("GameBot::_punish_moves(): move_position = (%lu, %lu)\n", move_position.first, move_position.second);
@@ -308,10 +940,10 @@ void GameBot::_punish_moves() {
     }
 }
 
-void GameBot::_reward_moves() {
-    for (size_t match_box_index = 0; match_box_index < _match_box_history.size(); ++match_box_index) {
-        MatchBox * match_box = _match_box_history.at(match_box_index);
-        MovePosition move_position = _move_position_history.at(match_box_index);
+void GameBot::_reward_moves(const MatchBoxHistory & history) {
+    for (size_t match_box_index = 0; match_box_index < history.size(); ++match_box_index) {
+        MatchBox * match_box = history.match_box(match_box_index);
+        MovePosition move_position = history.move_position(match_box_index);
         assert(match_box != nullptr);
 
         printf("GameBot::_reward_moves(): move_position = (%lu, %lu)\n", move_position.first, move_position.second);
@@ -319,10 +951,10 @@ void GameBot::_reward_moves() {
     }
 }
 
-void GameBot::_reward_drawn_moves() {
-    for (size_t match_box_index = 0; match_box_index < _match_box_history.size(); ++match_box_index) {
-        MatchBox * match_box = _match_box_history.at(match_box_index);
-        MovePosition move_position = _move_position_history.at(match_box_index);
+void GameBot::_reward_drawn_moves(const MatchBoxHistory & history) {
+    for (size_t match_box_index = 0; match_box_index < history.size(); ++match_box_index) {
+        MatchBox * match_box = history.match_box(match_box_index);
+        MovePosition move_position = history.move_position(match_box_index);
         assert(match_box != nullptr);
 
         printf("GameBot::_reward_drawn_moves(): move_position = (%lu, %lu)\n", move_position.first, move_position.second);
@@ -2,7 +2,6 @@
 
 #include <cstdint>
 
-#include <QFont>
 #include <QGridLayout>
 #include <QObject>
 #include <QString>
@@ -10,65 +9,41 @@
 
 #include "constants.h"
 
-#define CELL_WIDTH 200
-#define CELL_HEIGHT 200
-
 GameWidget::GameWidget(QWidget *parent) :
     QWidget(parent)
 {
     QGridLayout * layout = new QGridLayout();
     this->setLayout(layout);
 
-    QFont font;
-    font.setBold(true);
-    font.setPointSize(72);
-    for (int8_t row = 0; row < NUM_ROWS; ++row) {
-        for (int8_t col = 0; col < NUM_COLS; ++col) {
-            _game_cells[row][col] = new GameCell(this, row, col);
-            _game_cells[row][col]->resize(CELL_WIDTH, CELL_HEIGHT);
-            _game_cells[row][col]->setFont(font);
-            _game_cells[row][col]->setAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
-            _game_cells[row][col]->setStyleSheet("background-color:white;");
-
-            QObject::connect(_game_cells[row][col], SIGNAL(clicked(int8_t, int8_t)),
-                             this, SLOT(_cell_clicked(int8_t, int8_t)));
-
-            layout->addWidget(_game_cells[row][col], row, col);
-        }
-    }
+    _board_widget = new BoardWidget(NUM_ROWS, NUM_COLS, this);
+    QObject::connect(_board_widget, SIGNAL(cell_clicked(int8_t, int8_t)),
+                     this, SLOT(_cell_clicked(int8_t, int8_t)));
+    layout->addWidget(_board_widget, 0, 0);
+
     _move_label = new QLabel(this);
     _move_label->setAlignment(Qt::AlignRight);
-    layout->addWidget(_move_label, NUM_ROWS, 0, 1, NUM_COLS);
+    layout->addWidget(_move_label, 1, 0);
 
     _status_label = new QLabel(this);
     _status_label->setAlignment(Qt::AlignRight);
-    layout->addWidget(_status_label, NUM_ROWS + 1, 0, 1, NUM_COLS);
+    layout->addWidget(_status_label, 2, 0);
 
     reset_game();
 }
 
 GameWidget::~GameWidget() {
-    for (int8_t row = 0; row < NUM_ROWS; ++row) {
-        for (int8_t col = 0; col < NUM_COLS; ++col) {
-            delete _game_cells[row][col];
-            _game_cells[row][col] = nullptr;
-        }
-    }
+
 }
 
 void GameWidget::reset_game() {
     printf("\n\n\n\n");
     printf("---------NEW GAME-----------\n");
-    for (int8_t row = 0; row < NUM_ROWS; ++row) {
-        for (int8_t col = 0; col < NUM_COLS; ++col) {
-            _game_cells[row][col]->setText("");
-            _game_cells[row][col]->setStyleSheet("background-color:white;");
-        }
-    }
+    _board_widget->clear();
     _game.reset();
     _update_status_string();
     _unfreeze_game();
-    if (PLAY_BOT == true && FIRST_PLAYER_MOVE == BOT_MOVE) {
+    PlayerRoles player_roles = _game.get_player_roles();
+    if (player_roles.play_bot == true && player_roles.first_player_move == player_roles.bot_move) {
         int8_t row_index = 0, col_index = 0;
         Move next_move = Move::EMPTY;
         bool success = false;
@@ -88,7 +63,7 @@ void GameWidget::_cell_clicked(int8_t row_index, int8_t col_index) {
     _update_status_string();
     _update_game_cells(success, row_index, col_index, next_move);
 
-    if(success == false || PLAY_BOT == false) {
+    if(success == false || _game.get_player_roles().play_bot == false) {
         return;
     }
     GameState game_state = _game.get_game_state();
@@ -113,9 +88,7 @@ void GameWidget::_update_game_cells(bool success, int8_t row_index, int8_t col_i
     assert(col_index >= 0 && col_index < NUM_COLS);
 
     if (success) {
-        const QString symbol = STR_MOVE_SYMBOL(move);
-        _game_cells[row_index][col_index]->setText(symbol);
-        _game_cells[row_index][col_index]->setEnabled(false);
+        _board_widget->set_cell(row_index, col_index, move);
     } else {
         // Do Nothing?
     }
@@ -150,24 +123,13 @@ void GameWidget::_update_status_string() {
     }
     }
 
-    std::vector<MovePosition> winning_moves = _game.get_winning_moves();
-    for (MovePosition position : winning_moves) {
-        _game_cells[position.first][position.second]->setStyleSheet("background-color:green;");
-    }
+    _board_widget->set_winning_cells(_game.get_winning_moves());
 }
 
 void GameWidget::_freeze_game() {
-    for (int8_t row = 0; row < NUM_ROWS; ++row) {
-        for (int8_t col = 0; col < NUM_COLS; ++col) {
-            _game_cells[row][col]->setEnabled(false);
-        }
-    }
+    _board_widget->setEnabled(false);
 }
 
 void GameWidget::_unfreeze_game() {
-    for (int8_t row = 0; row < NUM_ROWS; ++row) {
-        for (int8_t col = 0; col < NUM_COLS; ++col) {
-            _game_cells[row][col]->setEnabled(true);
-        }
-    }
+    _board_widget->setEnabled(true);
 }
\ No newline at end of file
@@ -5,8 +5,22 @@
 #include <vector>
 
 #include "constants.h"
+#include "metrics.h"
+
+static uint64_t _zobrist_key(int8_t row, int8_t col, Move move) {
+	// splitmix64 of the (cell, move) pair, so no table needs initialising.
+	uint64_t key = (static_cast<uint64_t>(row * NUM_COLS + col) * 3 + static_cast<uint64_t>(move)) + 0x9E3779B97F4A7C15ULL;
+	key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+	return key ^ (key >> 31);
+}
+
+Grid::Grid() : Grid(DEFAULT_FIRST_PLAYER_MOVE) {
+
+}
 
-Grid::Grid() {
+Grid::Grid(Move first_player_move) : _first_player(first_player_move) {
+	assert(first_player_move == Move::NOUGHT || first_player_move == Move::CROSS);
 	reset();
 }
 
@@ -27,6 +41,7 @@ void Grid::reset() {
 			_grid[row][col] = Move::EMPTY;
 		}
 	}
+	_hash = 0;
 }
 
 Move Grid::value(int8_t row, int8_t col) const {
@@ -48,16 +63,39 @@ bool Grid::set_value(int8_t row, int8_t col) {
 		return false;		
 	}
 	_grid[row][col] = next_player();
+	_hash ^= _zobrist_key(row, col, _grid[row][col]);
 	return true;
 }
 
 bool Grid::set_value(int8_t row, int8_t col, Move move) {
 	assert(row >= 0 && row < NUM_ROWS && col >= 0 && col < NUM_COLS);
 
+	if (_grid[row][col] != Move::EMPTY) {
+		_hash ^= _zobrist_key(row, col, _grid[row][col]);
+	}
 	_grid[row][col] = move;
+	if (move != Move::EMPTY) {
+		_hash ^= _zobrist_key(row, col, move);
+	}
 	return true;
 }
 
+void Grid::make_move(int8_t row, int8_t col, Move move) {
+	assert(row >= 0 && row < NUM_ROWS && col >= 0 && col < NUM_COLS);
+	assert(_grid[row][col] == Move::EMPTY);
+
+	_grid[row][col] = move;
+	_hash ^= _zobrist_key(row, col, move);
+}
+
+void Grid::unmake_move(int8_t row, int8_t col) {
+	assert(row >= 0 && row < NUM_ROWS && col >= 0 && col < NUM_COLS);
+	assert(_grid[row][col] != Move::EMPTY);
+
+	_hash ^= _zobrist_key(row, col, _grid[row][col]);
+	_grid[row][col] = Move::EMPTY;
+}
+
 std::vector<MovePosition> Grid::valid_move_positions() const {
 	std::vector<MovePosition> valid_positions;
 
@@ -71,6 +109,10 @@ std::vector<MovePosition> Grid::valid_move_positions() const {
 	return valid_positions;
 }
 
+Move Grid::first_player() const {
+	return _first_player;
+}
+
 Move Grid::next_player() const {
 	if (_has_game_ended()) {
 		// Game Ended
@@ -97,14 +139,10 @@ Move Grid::next_player() const {
 		// Game Ended
 		return Move::EMPTY;
 	}
-	if (num_crosses > num_noughts) {
-		return Move::NOUGHT;
-	} else if (num_crosses > num_noughts) {
-		return Move::CROSS;
-	} else {
-		return FIRST_PLAYER_MOVE;
+	if (num_crosses == num_noughts) {
+		return _first_player;
 	}
-	return Move::EMPTY;
+	return num_crosses > num_noughts ? Move::NOUGHT : Move::CROSS;
 }
 
 GameState Grid::game_state() const {
@@ -142,6 +180,34 @@ bool Grid::can_win_in_one_move(MovePosition & position) const {
 	return false;
 }
 
+bool Grid::is_winning_move(int8_t row, int8_t col, Move move) const {
+	assert(row >= 0 && row < NUM_ROWS && col >= 0 && col < NUM_COLS);
+
+	if (_grid[row][col] != Move::EMPTY || move == Move::EMPTY) {
+		return false;
+	}
+
+	// Only the lines through (row, col) can be completed by this move.
+	int8_t row_count = 0, col_count = 0, diag_count = 0, anti_diag_count = 0;
+	for (int8_t index = 0; index < NUM_COLS; ++index) {
+		row_count += (index == col || _grid[row][index] == move) ? 1 : 0;
+	}
+	for (int8_t index = 0; index < NUM_ROWS; ++index) {
+		col_count += (index == row || _grid[index][col] == move) ? 1 : 0;
+	}
+	if (row_count == NUM_COLS || col_count == NUM_ROWS) {
+		return true;
+	}
+	if (NUM_ROWS != NUM_COLS) {
+		return false;
+	}
+	for (int8_t index = 0; index < NUM_ROWS; ++index) {
+		diag_count += (row == col && (index == row || _grid[index][index] == move)) ? 1 : 0;
+		anti_diag_count += (row + col + 1 == NUM_COLS && (index == row || _grid[index][NUM_COLS - 1 - index] == move)) ? 1 : 0;
+	}
+	return diag_count == NUM_ROWS || anti_diag_count == NUM_ROWS;
+}
+
 std::vector<MovePosition> Grid::winning_moves() const {
 	std::vector<MovePosition> winning_moves;
 	switch (_game_state()) {
@@ -191,6 +257,7 @@ bool Grid::_has_game_ended() const {
 }
 
 GameState Grid::_game_state() const {
+	METRICS_SCOPED_TIMER(MetricTimer::GRID_GAME_STATE);
 	int16_t row_sums[NUM_ROWS];
 	int16_t col_sums[NUM_COLS];
 	int16_t diag_sums[NUM_DIAGS];
@@ -262,6 +329,22 @@ GameState Grid::_game_state() const {
 	return GameState::ONGOING;
 }
 
+uint64_t Grid::hash() const {
+	return _hash;
+}
+
+Grid Grid::swapped_players() const {
+	Grid swapped_grid(OPPONENT_MOVE(_first_player));
+	for (int8_t row = 0; row < NUM_ROWS; ++row) {
+		for (int8_t col = 0; col < NUM_COLS; ++col) {
+			if (_grid[row][col] != Move::EMPTY) {
+				swapped_grid.set_value(row, col, OPPONENT_MOVE(_grid[row][col]));
+			}
+		}
+	}
+	return swapped_grid;
+}
+
 void Grid::print_grid() const {
     for (int8_t row = 0; row < NUM_ROWS; ++row) {
         for (int8_t col = 0; col < NUM_COLS; ++col) {
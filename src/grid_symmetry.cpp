@@ -0,0 +1,289 @@
+#include "grid_symmetry.h"
+
+#include <cassert>
+#include <cstdint>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define GRID_SYMMETRY_SSSE3
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define GRID_SYMMETRY_NEON
+#endif
+
+#include "constants.h"
+#include "grid.h"
+
+#define GRID_VECTOR_SIZE (16)
+// Shuffle index that yields a zero byte, for pshufb and tbl alike.
+#define GRID_ZERO_BYTE (0x80)
+
+static_assert(NUM_ROWS * NUM_COLS <= GRID_VECTOR_SIZE, "a grid must fit in one 16-byte vector");
+// Cell weights of grid_index() as 16-bit lanes: the largest index must fit.
+static_assert(NUM_ROWS * NUM_COLS <= 9, "grid_index() of a packed grid must fit in 16 bits");
+
+const GridTransformation GRID_SYMMETRIES[NUM_GRID_SYMMETRIES] = {
+    GridTransformation::GRID_EQUAL,
+    GridTransformation::GRID_ROTATION_180,
+    GridTransformation::GRID_ROTATION_LEFT,
+    GridTransformation::GRID_ROTATION_RIGHT,
+    GridTransformation::GRID_REFLECTION_X,
+    GridTransformation::GRID_REFLECTION_Y,
+    GridTransformation::GRID_REFLECTION_DIAG,
+    GridTransformation::GRID_REFLECTION_DIAG_1,
+};
+
+bool grid_symmetry_is_valid(GridTransformation grid_transformation) {
+    switch (grid_transformation) {
+        case GridTransformation::GRID_EQUAL:
+        case GridTransformation::GRID_REFLECTION_X:
+        case GridTransformation::GRID_REFLECTION_Y:
+            return true;
+        case GridTransformation::GRID_ROTATION_180:
+        case GridTransformation::GRID_ROTATION_LEFT:
+        case GridTransformation::GRID_ROTATION_RIGHT:
+        case GridTransformation::GRID_REFLECTION_DIAG:
+        case GridTransformation::GRID_REFLECTION_DIAG_1:
+        case GridTransformation::GRID_REFLECTION_DIAG_2:
+            return NUM_ROWS == NUM_COLS;
+        case GridTransformation::GRID_UNEQUAL:
+        default:
+            return false;
+    }
+}
+
+MovePosition grid_symmetry_source(GridTransformation grid_transformation, size_t row, size_t col) {
+    assert(row < NUM_ROWS && col < NUM_COLS);
+
+    switch (grid_transformation) {
+        case GridTransformation::GRID_ROTATION_180:
+        case GridTransformation::GRID_REFLECTION_DIAG_2:
+            return std::make_pair(NUM_COLS - col - 1, NUM_ROWS - row - 1);
+        case GridTransformation::GRID_ROTATION_LEFT:
+            return std::make_pair(NUM_COLS - col - 1, row);
+        case GridTransformation::GRID_ROTATION_RIGHT:
+            return std::make_pair(col, NUM_ROWS - row - 1);
+        case GridTransformation::GRID_REFLECTION_X:
+            return std::make_pair(NUM_ROWS - row - 1, col);
+        case GridTransformation::GRID_REFLECTION_Y:
+            return std::make_pair(row, NUM_COLS - col - 1);
+        case GridTransformation::GRID_REFLECTION_DIAG:
+            return std::make_pair(NUM_COLS - row - 1, NUM_ROWS - col - 1);
+        case GridTransformation::GRID_REFLECTION_DIAG_1:
+            return std::make_pair(col, row);
+        case GridTransformation::GRID_EQUAL:
+        case GridTransformation::GRID_UNEQUAL:
+        default:
+            return std::make_pair(row, col);
+    }
+}
+
+// Byte shuffles of the packed grid, one per entry of GRID_SYMMETRIES: byte
+// i of the transformed grid is byte sources[s][i] of the original.
+struct GridShuffles {
+    alignas(GRID_VECTOR_SIZE) uint8_t sources[NUM_GRID_SYMMETRIES][GRID_VECTOR_SIZE];
+    alignas(GRID_VECTOR_SIZE) int16_t weights[GRID_VECTOR_SIZE];
+    uint32_t valid_symmetries;
+};
+
+static GridShuffles _compute_shuffles() {
+    GridShuffles shuffles = {};
+    for (size_t symmetry = 0; symmetry < NUM_GRID_SYMMETRIES; ++symmetry) {
+        for (size_t cell = 0; cell < GRID_VECTOR_SIZE; ++cell) {
+            shuffles.sources[symmetry][cell] = GRID_ZERO_BYTE;
+        }
+        if (!grid_symmetry_is_valid(GRID_SYMMETRIES[symmetry])) {
+            continue;
+        }
+        shuffles.valid_symmetries |= 1u << symmetry;
+        for (size_t row = 0; row < NUM_ROWS; ++row) {
+            for (size_t col = 0; col < NUM_COLS; ++col) {
+                MovePosition source = grid_symmetry_source(GRID_SYMMETRIES[symmetry], row, col);
+                shuffles.sources[symmetry][row * NUM_COLS + col] = static_cast<uint8_t>(source.first * NUM_COLS + source.second);
+            }
+        }
+    }
+    int16_t weight = 1;
+    for (size_t cell = 0; cell < NUM_ROWS * NUM_COLS; ++cell) {
+        shuffles.weights[cell] = weight;
+        weight = static_cast<int16_t>(weight * 3);
+    }
+    return shuffles;
+}
+
+static const GridShuffles _SHUFFLES = _compute_shuffles();
+
+// Cell (row, col) of grid in byte row * NUM_COLS + col, zero above.
+static void _pack_grid(const Grid & grid, uint8_t cells[GRID_VECTOR_SIZE]) {
+    for (size_t cell = 0; cell < GRID_VECTOR_SIZE; ++cell) {
+        cells[cell] = 0;
+    }
+    for (int8_t row = 0; row < NUM_ROWS; ++row) {
+        for (int8_t col = 0; col < NUM_COLS; ++col) {
+            cells[row * NUM_COLS + col] = static_cast<uint8_t>(grid.value(row, col));
+        }
+    }
+}
+
+// Bit s is set when first equals second transformed by GRID_SYMMETRIES[s].
+static uint32_t _matching_symmetries_scalar(const uint8_t first[GRID_VECTOR_SIZE], const uint8_t second[GRID_VECTOR_SIZE]) {
+    uint32_t matches = 0;
+    for (size_t symmetry = 0; symmetry < NUM_GRID_SYMMETRIES; ++symmetry) {
+        bool equal = true;
+        for (size_t cell = 0; cell < NUM_ROWS * NUM_COLS && equal; ++cell) {
+            equal = first[cell] == second[_SHUFFLES.sources[symmetry][cell]];
+        }
+        matches |= static_cast<uint32_t>(equal) << symmetry;
+    }
+    return matches & _SHUFFLES.valid_symmetries;
+}
+
+// grid_index() of the packed grid transformed by GRID_SYMMETRIES[symmetry].
+static uint64_t _transformed_index_scalar(const uint8_t cells[GRID_VECTOR_SIZE], size_t symmetry) {
+    uint64_t index = 0;
+    for (size_t cell = 0; cell < NUM_ROWS * NUM_COLS; ++cell) {
+        index += static_cast<uint64_t>(cells[_SHUFFLES.sources[symmetry][cell]]) * static_cast<uint64_t>(_SHUFFLES.weights[cell]);
+    }
+    return index;
+}
+
+#if defined(GRID_SYMMETRY_SSSE3)
+static bool _cpu_has_ssse3() {
+    static const bool has_ssse3 = __builtin_cpu_supports("ssse3");
+    return has_ssse3;
+}
+
+// Built for SSSE3 on their own, so the rest of the file still runs anywhere.
+__attribute__((target("ssse3")))
+static uint32_t _matching_symmetries_ssse3(const uint8_t first[GRID_VECTOR_SIZE], const uint8_t second[GRID_VECTOR_SIZE]) {
+    uint32_t matches = 0;
+    __m128i first_cells = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+    __m128i second_cells = _mm_loadu_si128(reinterpret_cast<const __m128i *>(second));
+    for (size_t symmetry = 0; symmetry < NUM_GRID_SYMMETRIES; ++symmetry) {
+        __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i *>(_SHUFFLES.sources[symmetry]));
+        __m128i transformed = _mm_shuffle_epi8(second_cells, shuffle);
+        matches |= static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(first_cells, transformed)) == 0xFFFF) << symmetry;
+    }
+    return matches & _SHUFFLES.valid_symmetries;
+}
+
+__attribute__((target("ssse3")))
+static uint64_t _transformed_index_ssse3(const uint8_t cells[GRID_VECTOR_SIZE], size_t symmetry) {
+    __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cells));
+    __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i *>(_SHUFFLES.sources[symmetry]));
+    __m128i transformed = _mm_shuffle_epi8(packed, shuffle);
+    __m128i zero = _mm_setzero_si128();
+    // Cells times powers of 3 in 16-bit lanes, summed pairwise into 32 bits.
+    __m128i sums = _mm_add_epi32(
+        _mm_madd_epi16(_mm_unpacklo_epi8(transformed, zero), _mm_load_si128(reinterpret_cast<const __m128i *>(_SHUFFLES.weights))),
+        _mm_madd_epi16(_mm_unpackhi_epi8(transformed, zero), _mm_load_si128(reinterpret_cast<const __m128i *>(_SHUFFLES.weights + 8))));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+    return static_cast<uint64_t>(_mm_cvtsi128_si32(sums));
+}
+#endif
+
+static uint32_t _matching_symmetries(const uint8_t first[GRID_VECTOR_SIZE], const uint8_t second[GRID_VECTOR_SIZE]) {
+#if defined(GRID_SYMMETRY_SSSE3)
+    if (_cpu_has_ssse3()) {
+        return _matching_symmetries_ssse3(first, second);
+    }
+#elif defined(GRID_SYMMETRY_NEON)
+    uint32_t matches = 0;
+    uint8x16_t first_cells = vld1q_u8(first);
+    uint8x16_t second_cells = vld1q_u8(second);
+    for (size_t symmetry = 0; symmetry < NUM_GRID_SYMMETRIES; ++symmetry) {
+        uint8x16_t transformed = vqtbl1q_u8(second_cells, vld1q_u8(_SHUFFLES.sources[symmetry]));
+        matches |= static_cast<uint32_t>(vminvq_u8(vceqq_u8(first_cells, transformed)) == 0xFF) << symmetry;
+    }
+    return matches & _SHUFFLES.valid_symmetries;
+#endif
+    return _matching_symmetries_scalar(first, second);
+}
+
+static uint64_t _transformed_index(const uint8_t cells[GRID_VECTOR_SIZE], size_t symmetry) {
+#if defined(GRID_SYMMETRY_SSSE3)
+    if (_cpu_has_ssse3()) {
+        return _transformed_index_ssse3(cells, symmetry);
+    }
+#elif defined(GRID_SYMMETRY_NEON)
+    uint8x16_t transformed = vqtbl1q_u8(vld1q_u8(cells), vld1q_u8(_SHUFFLES.sources[symmetry]));
+    // The index is below 3^9, so 16-bit lanes cannot overflow.
+    uint16x8_t low = vmulq_u16(vmovl_u8(vget_low_u8(transformed)), vreinterpretq_u16_s16(vld1q_s16(_SHUFFLES.weights)));
+    uint16x8_t high = vmulq_u16(vmovl_u8(vget_high_u8(transformed)), vreinterpretq_u16_s16(vld1q_s16(_SHUFFLES.weights + 8)));
+    return static_cast<uint64_t>(vaddvq_u16(vaddq_u16(low, high)));
+#endif
+    return _transformed_index_scalar(cells, symmetry);
+}
+
+GridTransformation find_grid_transformation(const Grid & first, const Grid & second) {
+    uint8_t first_cells[GRID_VECTOR_SIZE], second_cells[GRID_VECTOR_SIZE];
+    _pack_grid(first, first_cells);
+    _pack_grid(second, second_cells);
+    uint32_t matches = _matching_symmetries(first_cells, second_cells);
+    // Lowest bit first, as GRID_SYMMETRIES follows the priority order.
+    for (size_t symmetry = 0; symmetry < NUM_GRID_SYMMETRIES; ++symmetry) {
+        if ((matches >> symmetry) & 1) {
+            return GRID_SYMMETRIES[symmetry];
+        }
+    }
+    return GridTransformation::GRID_UNEQUAL;
+}
+
+Grid transform_grid(const Grid & grid, GridTransformation grid_transformation) {
+    assert(grid_symmetry_is_valid(grid_transformation));
+
+    Grid transformed_grid;
+    for (size_t row = 0; row < NUM_ROWS; ++row) {
+        for (size_t col = 0; col < NUM_COLS; ++col) {
+            MovePosition source = grid_symmetry_source(grid_transformation, row, col);
+            transformed_grid.set_value(row, col, grid.value(source.first, source.second));
+        }
+    }
+    return transformed_grid;
+}
+
+uint64_t grid_index(const Grid & grid) {
+    uint64_t index = 0;
+    for (int8_t row = NUM_ROWS - 1; row >= 0; --row) {
+        for (int8_t col = NUM_COLS - 1; col >= 0; --col) {
+            index = index * 3 + static_cast<uint64_t>(grid.value(row, col));
+        }
+    }
+    return index;
+}
+
+Grid grid_from_index(uint64_t index) {
+    Grid grid;
+    for (int8_t row = 0; row < NUM_ROWS; ++row) {
+        for (int8_t col = 0; col < NUM_COLS; ++col) {
+            grid.set_value(row, col, static_cast<Move>(index % 3));
+            index /= 3;
+        }
+    }
+    return grid;
+}
+
+uint64_t canonical_grid_index(const Grid & grid) {
+    GridTransformation grid_transformation = GridTransformation::GRID_EQUAL;
+    return canonical_grid_index(grid, grid_transformation);
+}
+
+uint64_t canonical_grid_index(const Grid & grid, GridTransformation & canonical_transformation) {
+    uint8_t cells[GRID_VECTOR_SIZE];
+    _pack_grid(grid, cells);
+    // GRID_EQUAL comes first, so ties keep the earliest symmetry as before.
+    uint64_t canonical_index = _transformed_index(cells, 0);
+    canonical_transformation = GRID_SYMMETRIES[0];
+    for (size_t symmetry = 1; symmetry < NUM_GRID_SYMMETRIES; ++symmetry) {
+        if (!((_SHUFFLES.valid_symmetries >> symmetry) & 1)) {
+            continue;
+        }
+        uint64_t index = _transformed_index(cells, symmetry);
+        if (index < canonical_index) {
+            canonical_index = index;
+            canonical_transformation = GRID_SYMMETRIES[symmetry];
+        }
+    }
+    return canonical_index;
+}
@@ -0,0 +1,293 @@
+#include "lazy_policy_store.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "match_box.h"
+
+#define LAZY_POLICY_EMPTY_KEY (UINT64_MAX)
+#define LAZY_POLICY_NO_BLOCK (0x7FFFFFFFu)
+#define LAZY_POLICY_NO_SPILL_RECORD (UINT32_MAX)
+// Top bit of Slot::block, set on every use and cleared by the clock hand.
+#define LAZY_POLICY_REFERENCED (0x80000000u)
+
+struct LazyPolicyStore::Slot {
+    uint64_t key;
+    uint32_t block;
+    uint32_t spill_record;
+};
+
+struct alignas(64) LazyPolicyStore::Shard {
+    std::mutex mutex;
+    std::vector<Slot> slots;
+    size_t size;
+    size_t clock_hand;
+};
+
+static uint64_t _hash(uint64_t key) {
+    // splitmix64 finaliser, as in SparseCellTable.
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+    return key ^ (key >> 31);
+}
+
+LazyPolicyStore::LazyPolicyStore(size_t num_cells, size_t memory_limit) :
+    _num_cells(num_cells),
+    _max_resident_blocks(std::min<size_t>(LAZY_POLICY_NO_BLOCK, std::max<size_t>(1, memory_limit / num_cells))),
+    _shards(new Shard[LAZY_POLICY_NUM_SHARDS]),
+    _clock_shard(0),
+    _num_chunks(0),
+    _num_resident_boxes(0),
+    _spill_file(-1),
+    _num_spill_records(0),
+    _num_boxes(0),
+    _num_spilled_boxes(0),
+    _num_evictions(0),
+    _num_reloads(0),
+    _num_slots(0)
+{
+    static_assert(sizeof(Slot) == 16, "slots are 16 bytes");
+    assert(num_cells > 0 && num_cells <= LAZY_POLICY_MAX_CELLS);
+    for (size_t shard_index = 0; shard_index < LAZY_POLICY_NUM_SHARDS; ++shard_index) {
+        Shard & shard = _shards[shard_index];
+        shard.slots.assign(size_t(1) << LAZY_POLICY_INITIAL_SHARD_CAPACITY_LOG2, Slot{LAZY_POLICY_EMPTY_KEY, LAZY_POLICY_NO_BLOCK, LAZY_POLICY_NO_SPILL_RECORD});
+        shard.size = 0;
+        shard.clock_hand = 0;
+        _num_slots += shard.slots.size();
+    }
+    // Sized once, so that _block() can read it without the block mutex.
+    _chunks.resize((_max_resident_blocks + LAZY_POLICY_BLOCKS_PER_CHUNK - 1) / LAZY_POLICY_BLOCKS_PER_CHUNK);
+}
+
+LazyPolicyStore::~LazyPolicyStore() {
+    if (_spill_file >= 0) {
+        close(_spill_file);
+    }
+}
+
+bool LazyPolicyStore::open_spill_file(const std::string & filename) {
+    assert(_num_boxes.load() == 0);
+    // Scratch space for this run only, so any old content is dropped.
+    int file_descriptor = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file_descriptor < 0) {
+        printf("LazyPolicyStore::open_spill_file(): Cannot open file = %s\n", filename.c_str());
+        return false;
+    }
+    if (_spill_file >= 0) {
+        close(_spill_file);
+    }
+    _spill_file = file_descriptor;
+    _num_spill_records.store(0);
+    return true;
+}
+
+size_t LazyPolicyStore::num_cells() const {
+    return _num_cells;
+}
+
+bool LazyPolicyStore::get_seeds(uint64_t key, uint64_t empty_cells, int8_t * seeds) {
+    Shard & shard = _shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const int8_t * box_seeds = _find_box(shard, key, empty_cells);
+    if (box_seeds == nullptr) {
+        return false;
+    }
+    memcpy(seeds, box_seeds, _num_cells);
+    return true;
+}
+
+bool LazyPolicyStore::apply_seed_delta(uint64_t key, uint64_t empty_cells, size_t cell, int32_t rewards, int32_t punishments) {
+    assert(cell < _num_cells);
+    assert(rewards >= 0 && punishments >= 0);
+    Shard & shard = _shard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    int8_t * box_seeds = _find_box(shard, key, empty_cells);
+    if (box_seeds == nullptr) {
+        return false;
+    }
+    box_seeds[cell] = apply_seed_delta_rule(box_seeds[cell], rewards, punishments);
+    return true;
+}
+
+LazyPolicyStatistics LazyPolicyStore::get_statistics() const {
+    LazyPolicyStatistics statistics;
+    statistics.num_boxes = _num_boxes.load();
+    statistics.num_resident_boxes = _num_resident_boxes.load();
+    statistics.num_spilled_boxes = _num_spilled_boxes.load();
+    statistics.num_evictions = _num_evictions.load();
+    statistics.num_reloads = _num_reloads.load();
+    statistics.resident_bytes = statistics.num_resident_boxes * _num_cells;
+    statistics.table_bytes = _num_slots.load() * sizeof(Slot);
+    return statistics;
+}
+
+LazyPolicyStore::Shard & LazyPolicyStore::_shard(uint64_t key) const {
+    // High bits pick the shard, low bits the slot within it.
+    return _shards[_hash(key) >> 58];
+}
+
+int8_t * LazyPolicyStore::_find_box(Shard & shard, uint64_t key, uint64_t empty_cells) {
+    size_t index = _find_or_insert(shard, key);
+    if (shard.slots[index].block == LAZY_POLICY_NO_BLOCK) {
+        // Evicting may touch other slots of this shard, but never moves them.
+        uint32_t block_index = _allocate_block(shard);
+        if (block_index == LAZY_POLICY_NO_BLOCK) {
+            return nullptr;
+        }
+        Slot & slot = shard.slots[index];
+        slot.block = block_index;
+        if (slot.spill_record != LAZY_POLICY_NO_SPILL_RECORD) {
+            if (!_reload(slot)) {
+                slot.block = LAZY_POLICY_NO_BLOCK;
+                std::lock_guard<std::mutex> lock(_block_mutex);
+                _free_blocks.push_back(block_index);
+                _num_resident_boxes.fetch_sub(1);
+                return nullptr;
+            }
+            _num_reloads.fetch_add(1, std::memory_order_relaxed);
+            _num_spilled_boxes.fetch_sub(1, std::memory_order_relaxed);
+        } else {
+            int8_t * seeds = _block(block_index);
+            for (size_t cell = 0; cell < _num_cells; ++cell) {
+                seeds[cell] = (empty_cells >> cell) & 1 ? MAX_NUM_SEEDS : 0;
+            }
+        }
+    }
+    Slot & slot = shard.slots[index];
+    slot.block |= LAZY_POLICY_REFERENCED;
+    return _block(slot.block & ~LAZY_POLICY_REFERENCED);
+}
+
+size_t LazyPolicyStore::_find_or_insert(Shard & shard, uint64_t key) {
+    assert(key != LAZY_POLICY_EMPTY_KEY);
+    size_t mask = shard.slots.size() - 1;
+    size_t index = _hash(key) & mask;
+    while (shard.slots[index].key != LAZY_POLICY_EMPTY_KEY && shard.slots[index].key != key) {
+        index = (index + 1) & mask;
+    }
+    if (shard.slots[index].key == key) {
+        return index;
+    }
+    if (2 * (shard.size + 1) > shard.slots.size()) {
+        _grow(shard);
+        return _find_or_insert(shard, key);
+    }
+    shard.slots[index].key = key;
+    ++shard.size;
+    _num_boxes.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+void LazyPolicyStore::_grow(Shard & shard) {
+    std::vector<Slot> old_slots(2 * shard.slots.size(), Slot{LAZY_POLICY_EMPTY_KEY, LAZY_POLICY_NO_BLOCK, LAZY_POLICY_NO_SPILL_RECORD});
+    old_slots.swap(shard.slots);
+    _num_slots.fetch_add(old_slots.size(), std::memory_order_relaxed);
+    size_t mask = shard.slots.size() - 1;
+    for (const Slot & slot : old_slots) {
+        if (slot.key != LAZY_POLICY_EMPTY_KEY) {
+            size_t index = _hash(slot.key) & mask;
+            while (shard.slots[index].key != LAZY_POLICY_EMPTY_KEY) {
+                index = (index + 1) & mask;
+            }
+            shard.slots[index] = slot;
+        }
+    }
+    shard.clock_hand = 0;
+}
+
+int8_t * LazyPolicyStore::_block(uint32_t block_index) const {
+    return _chunks[block_index / LAZY_POLICY_BLOCKS_PER_CHUNK].get() + (block_index % LAZY_POLICY_BLOCKS_PER_CHUNK) * _num_cells;
+}
+
+uint32_t LazyPolicyStore::_allocate_block(Shard & locked_shard) {
+    {
+        std::lock_guard<std::mutex> lock(_block_mutex);
+        if (_num_resident_boxes.load(std::memory_order_relaxed) < _max_resident_blocks) {
+            if (_free_blocks.empty()) {
+                _chunks[_num_chunks].reset(new int8_t[LAZY_POLICY_BLOCKS_PER_CHUNK * _num_cells]);
+                for (size_t block_offset = LAZY_POLICY_BLOCKS_PER_CHUNK; block_offset-- > 0;) {
+                    _free_blocks.push_back(static_cast<uint32_t>(_num_chunks * LAZY_POLICY_BLOCKS_PER_CHUNK + block_offset));
+                }
+                ++_num_chunks;
+            }
+            uint32_t block_index = _free_blocks.back();
+            _free_blocks.pop_back();
+            _num_resident_boxes.fetch_add(1, std::memory_order_relaxed);
+            return block_index;
+        }
+    }
+    // At the limit: take over the block of a cold box.
+    uint32_t block_index = _evict_one(locked_shard);
+    if (block_index == LAZY_POLICY_NO_BLOCK) {
+        printf("LazyPolicyStore::_allocate_block(): Memory limit of %lu boxes reached\n", _max_resident_blocks);
+    }
+    return block_index;
+}
+
+uint32_t LazyPolicyStore::_evict_one(Shard & locked_shard) {
+    if (_spill_file < 0) {
+        return LAZY_POLICY_NO_BLOCK;
+    }
+    // Shards held by other threads are skipped rather than waited for,
+    // since their owners may be evicting too.
+    for (size_t attempt = 0; attempt < 4 * LAZY_POLICY_NUM_SHARDS; ++attempt) {
+        Shard & shard = _shards[_clock_shard.fetch_add(1, std::memory_order_relaxed) % LAZY_POLICY_NUM_SHARDS];
+        std::unique_lock<std::mutex> lock(shard.mutex, std::defer_lock);
+        if (&shard != &locked_shard && !lock.try_lock()) {
+            continue;
+        }
+        // Two full turns: the first may only clear reference bits.
+        size_t mask = shard.slots.size() - 1;
+        for (size_t step = 0; step < 2 * shard.slots.size(); ++step) {
+            Slot & slot = shard.slots[shard.clock_hand];
+            shard.clock_hand = (shard.clock_hand + 1) & mask;
+            if (slot.key == LAZY_POLICY_EMPTY_KEY || slot.block == LAZY_POLICY_NO_BLOCK) {
+                continue;
+            }
+            if ((slot.block & LAZY_POLICY_REFERENCED) != 0) {
+                slot.block &= ~LAZY_POLICY_REFERENCED;
+                continue;
+            }
+            if (!_spill(slot)) {
+                return LAZY_POLICY_NO_BLOCK;
+            }
+            uint32_t block_index = slot.block;
+            slot.block = LAZY_POLICY_NO_BLOCK;
+            _num_evictions.fetch_add(1, std::memory_order_relaxed);
+            _num_spilled_boxes.fetch_add(1, std::memory_order_relaxed);
+            return block_index;
+        }
+    }
+    return LAZY_POLICY_NO_BLOCK;
+}
+
+bool LazyPolicyStore::_spill(Slot & slot) {
+    // A box keeps its record in the file once it has one.
+    if (slot.spill_record == LAZY_POLICY_NO_SPILL_RECORD) {
+        slot.spill_record = _num_spill_records.fetch_add(1, std::memory_order_relaxed);
+    }
+    off_t offset = static_cast<off_t>(slot.spill_record) * static_cast<off_t>(_num_cells);
+    if (pwrite(_spill_file, _block(slot.block), _num_cells, offset) != static_cast<ssize_t>(_num_cells)) {
+        printf("LazyPolicyStore::_spill(): Cannot write spill file\n");
+        return false;
+    }
+    return true;
+}
+
+bool LazyPolicyStore::_reload(const Slot & slot) {
+    off_t offset = static_cast<off_t>(slot.spill_record) * static_cast<off_t>(_num_cells);
+    if (pread(_spill_file, _block(slot.block), _num_cells, offset) != static_cast<ssize_t>(_num_cells)) {
+        printf("LazyPolicyStore::_reload(): Cannot read spill file\n");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,389 @@
+#include "lazy_smp_search.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "anytime_search.h"
+#include "constants.h"
+#include "grid.h"
+#include "qubic_board.h"
+#include "qubic_symmetry.h"
+#include "search_adapters.h"
+#include "task_scheduler.h"
+#include "transposition_table.h"
+
+// An open three-in-a-line is worth this many line score points.
+#define QUBIC_THREAT_WEIGHT (16)
+
+// Adapters that let the templated search below treat both boards alike,
+// besides the move adapters from search_adapters.h. A table frame is the
+// symmetry a position is stored under; the best move kept in an entry is
+// expressed in that frame.
+static int32_t _evaluate(const Grid & grid, Move player) {
+    return AnytimeSearch::evaluate(grid, player);
+}
+
+static uint64_t _table_key(const Grid & grid, QubicTransformation & table_frame) {
+    table_frame = QUBIC_TRANSFORMATION_EQUAL;
+    return grid.hash();
+}
+
+static uint8_t _to_table_frame(const Grid & grid, QubicTransformation table_frame, const MovePosition & position) {
+    (void) grid;
+    (void) table_frame;
+    if (position.first >= NUM_ROWS || position.second >= NUM_COLS) {
+        return TT_NO_CELL;
+    }
+    return static_cast<uint8_t>(position.first * NUM_COLS + position.second);
+}
+
+static MovePosition _from_table_frame(const Grid & grid, QubicTransformation table_frame, uint8_t cell) {
+    (void) grid;
+    (void) table_frame;
+    if (cell >= MAX_RANK) {
+        return MovePosition(NUM_ROWS, NUM_COLS);
+    }
+    return MovePosition(cell / NUM_COLS, cell % NUM_COLS);
+}
+
+static void search_make_move(QubicBoard & board, const QubicMove & move, Move player) {
+    assert(board.next_player() == player);
+    (void) player;
+    board.make_move(move);
+}
+
+static void search_unmake_move(QubicBoard & board, const QubicMove & move) {
+    board.unmake_move(move);
+}
+
+static size_t search_order_moves(const QubicBoard & board, Move player, QubicMove hint, QubicMove moves[QUBIC_NUM_CELLS]) {
+    // A move that completes a line ends the game, and when the opponent has
+    // an open three every move but a block loses at once, so only those are
+    // generated. Otherwise the hinted move comes first, then the cells on
+    // seven lines (corners and centre) before the cells on four.
+    uint64_t candidates = board.threat_cells(player);
+    if (candidates == 0) {
+        candidates = board.threat_cells(OPPONENT_MOVE(player));
+    }
+    bool forced = candidates != 0;
+    if (!forced) {
+        candidates = board.empty_cells();
+    }
+
+    size_t num_moves = 0;
+    if (hint.cell < QUBIC_NUM_CELLS && ((candidates >> hint.cell) & 1)) {
+        moves[num_moves++] = hint;
+        candidates &= ~(uint64_t(1) << hint.cell);
+    }
+    for (size_t pass = forced ? 1 : 0; pass < 2; ++pass) {
+        for (uint8_t cell = 0; cell < QUBIC_NUM_CELLS; ++cell) {
+            if (((candidates >> cell) & 1) == 0) {
+                continue;
+            }
+            size_t x = cell % QUBIC_SIZE, y = cell / QUBIC_SIZE % QUBIC_SIZE, z = cell / (QUBIC_SIZE * QUBIC_SIZE);
+            bool outer_x = x == 0 || x == QUBIC_SIZE - 1;
+            bool outer_y = y == 0 || y == QUBIC_SIZE - 1;
+            bool outer_z = z == 0 || z == QUBIC_SIZE - 1;
+            // Corners have every coordinate outer and centre cells none.
+            bool on_seven_lines = outer_x == outer_y && outer_y == outer_z;
+            if (pass == 1 || on_seven_lines) {
+                moves[num_moves++] = QubicMove{cell};
+                candidates &= ~(uint64_t(1) << cell);
+            }
+        }
+    }
+    return num_moves;
+}
+
+static int32_t _evaluate(const QubicBoard & board, Move player) {
+    Move opponent = OPPONENT_MOVE(player);
+    int32_t threats = static_cast<int32_t>(board.num_threats(player)) - static_cast<int32_t>(board.num_threats(opponent));
+    int32_t score = board.line_score(player) + QUBIC_THREAT_WEIGHT * threats;
+    return AnytimeSearch::clamp_heuristic_score(score);
+}
+
+static uint64_t _table_key(const QubicBoard & board, QubicTransformation & table_frame) {
+    return board.canonical_hash(table_frame);
+}
+
+static_assert(QUBIC_NUM_CELLS < TT_NO_CELL, "Qubic cells fit a transposition table cell");
+
+static uint8_t _to_table_frame(const QubicBoard & board, QubicTransformation table_frame, const QubicMove & move) {
+    (void) board;
+    return move.cell < QUBIC_NUM_CELLS ? static_cast<uint8_t>(QUBIC_SYMMETRY_TABLE.targets[table_frame][move.cell]) : TT_NO_CELL;
+}
+
+static QubicMove _from_table_frame(const QubicBoard & board, QubicTransformation table_frame, uint8_t cell) {
+    (void) board;
+    return cell < QUBIC_NUM_CELLS ? QubicMove{QUBIC_SYMMETRY_TABLE.sources[table_frame][cell]} : QUBIC_NO_MOVE;
+}
+
+LazySmpSearch::LazySmpSearch(size_t num_threads, size_t table_size_log2, TaskScheduler & scheduler) :
+    _num_threads(num_threads),
+    _scheduler(scheduler),
+    _transposition_table(table_size_log2),
+    _stop(false),
+    _score(0),
+    _max_rank(MAX_RANK)
+{
+    assert(_num_threads > 0);
+    _statistics.nodes_searched = 0;
+    _statistics.depth_reached = 0;
+    _statistics.solved = false;
+}
+
+bool LazySmpSearch::search(const Grid & grid, std::chrono::microseconds search_budget, MovePosition & best_position) {
+    return _search(grid, search_budget, MAX_RANK, MovePosition(NUM_ROWS, NUM_COLS), best_position);
+}
+
+bool LazySmpSearch::search(const QubicBoard & board, std::chrono::microseconds search_budget, QubicMove & best_move) {
+    return _search(board, search_budget, QUBIC_NUM_CELLS, QUBIC_NO_MOVE, best_move);
+}
+
+void LazySmpSearch::clear() {
+    _transposition_table.clear();
+}
+
+SearchStatistics LazySmpSearch::get_statistics() const {
+    return _statistics;
+}
+
+int32_t LazySmpSearch::get_score() const {
+    return _score;
+}
+
+template <typename Board, typename Position>
+bool LazySmpSearch::_search(const Board & board, std::chrono::microseconds search_budget, size_t max_rank, Position no_position, Position & best_position) {
+    _deadline = std::chrono::steady_clock::now() + search_budget;
+    _stop.store(false, std::memory_order_relaxed);
+    _statistics.nodes_searched = 0;
+    _statistics.depth_reached = 0;
+    _statistics.solved = false;
+    _score = 0;
+    _max_rank = max_rank;
+
+    best_position = no_position;
+    if (board.next_player() == Move::EMPTY || board.game_state() != GameState::ONGOING) {
+        return false;
+    }
+
+    std::vector<Position> best_positions(_num_threads, no_position);
+    std::vector<int32_t> best_scores(_num_threads, 0);
+    std::vector<uint64_t> nodes_searched(_num_threads, 0);
+    std::vector<size_t> depths_reached(_num_threads, 0);
+
+    // The calling thread is the main searcher. Helpers that only get a
+    // worker after it has finished return straight away.
+    TaskGroup helpers(_scheduler);
+    for (size_t thread_index = 1; thread_index < _num_threads; ++thread_index) {
+        helpers.run([this, &board, thread_index, no_position, &best_positions, &best_scores, &nodes_searched, &depths_reached]() {
+            _iterative_deepening(board, thread_index, no_position, best_positions[thread_index], best_scores[thread_index],
+                                 nodes_searched[thread_index], depths_reached[thread_index]);
+        });
+    }
+    _iterative_deepening(board, 0, no_position, best_positions[0], best_scores[0], nodes_searched[0], depths_reached[0]);
+    _stop.store(true, std::memory_order_relaxed);
+    helpers.wait();
+
+    // The main thread decides unless a helper completed a deeper iteration.
+    size_t best_thread = 0;
+    for (size_t thread_index = 1; thread_index < _num_threads; ++thread_index) {
+        if (depths_reached[thread_index] > depths_reached[best_thread]) {
+            best_thread = thread_index;
+        }
+    }
+    best_position = best_positions[best_thread];
+    _score = best_scores[best_thread];
+    _statistics.depth_reached = depths_reached[best_thread];
+    _statistics.solved = _statistics.depth_reached == _max_rank - board.rank()
+        || std::abs(_score) >= SEARCH_WIN_SCORE - static_cast<int32_t>(_max_rank);
+    for (uint64_t thread_nodes : nodes_searched) {
+        _statistics.nodes_searched += thread_nodes;
+    }
+    return best_position != no_position;
+}
+
+template <typename Board, typename Position>
+void LazySmpSearch::_iterative_deepening(const Board & board, size_t thread_index, Position no_position, Position & best_position, int32_t & best_score, uint64_t & nodes_searched, size_t & depth_reached) {
+    Board search_board = board;
+    Move player = board.next_player();
+    size_t max_depth = _max_rank - board.rank();
+    QubicTransformation table_frame = QUBIC_TRANSFORMATION_EQUAL;
+    uint64_t table_key = _table_key(search_board, table_frame);
+    // Counted locally, the per-thread slots share cache lines.
+    uint64_t thread_nodes_searched = 0;
+
+    // Odd helpers skip ahead by one ply.
+    for (size_t depth = 1 + (thread_index % 2); depth <= max_depth; ++depth) {
+        if (_should_stop(thread_nodes_searched)) {
+            break;
+        }
+        int32_t alpha = -SEARCH_INFINITY;
+        int32_t beta = SEARCH_INFINITY;
+        Position iteration_best_position = no_position;
+
+        TranspositionEntry entry;
+        Position hint = best_position;
+        if (_transposition_table.probe(table_key, entry) && entry.best_cell != TT_NO_CELL) {
+            hint = _from_table_frame(search_board, table_frame, entry.best_cell);
+        }
+        Position positions[QUBIC_NUM_CELLS];
+        size_t num_positions = search_order_moves(search_board, player, hint, positions);
+        bool aborted = false;
+        for (size_t position_index = 0; position_index < num_positions; ++position_index) {
+            const Position & position = positions[position_index];
+            search_make_move(search_board, position, player);
+            int32_t score = -_negamax(search_board, OPPONENT_MOVE(player), depth - 1, 1, -beta, -alpha, no_position, thread_nodes_searched);
+            search_unmake_move(search_board, position);
+
+            if (_stop.load(std::memory_order_relaxed)) {
+                aborted = true;
+                break;
+            }
+            if (score > alpha) {
+                alpha = score;
+                iteration_best_position = position;
+            }
+        }
+        if (aborted) {
+            break;
+        }
+
+        best_position = iteration_best_position;
+        best_score = alpha;
+        depth_reached = depth;
+
+        TranspositionEntry root_entry;
+        root_entry.score = _score_to_table(alpha, 0);
+        root_entry.depth = static_cast<uint8_t>(depth);
+        root_entry.bound = TranspositionBound::EXACT;
+        root_entry.best_cell = _to_table_frame(search_board, table_frame, best_position);
+        _transposition_table.store(table_key, root_entry);
+
+        if (std::abs(alpha) >= SEARCH_WIN_SCORE - static_cast<int32_t>(_max_rank)) {
+            break;
+        }
+    }
+    nodes_searched = thread_nodes_searched;
+    if (thread_index == 0) {
+        _stop.store(true, std::memory_order_relaxed);
+    }
+}
+
+template <typename Board, typename Position>
+int32_t LazySmpSearch::_negamax(Board & board, Move player, size_t depth, size_t ply, int32_t alpha, int32_t beta, Position no_position, uint64_t & nodes_searched) {
+    ++nodes_searched;
+    if (_should_stop(nodes_searched)) {
+        return 0;
+    }
+
+    switch (board.game_state()) {
+        case GameState::CROSS_WINS:
+        case GameState::NOUGHT_WINS:
+            return -(SEARCH_WIN_SCORE - static_cast<int32_t>(ply));
+        case GameState::DRAW:
+            return 0;
+        case GameState::ONGOING:
+        case GameState::INVALID:
+        default:
+            break;
+    }
+    if (depth == 0) {
+        return _evaluate(board, player);
+    }
+
+    int32_t original_alpha = alpha;
+    Position hint = no_position;
+    QubicTransformation table_frame = QUBIC_TRANSFORMATION_EQUAL;
+    uint64_t table_key = _table_key(board, table_frame);
+    TranspositionEntry entry;
+    if (_transposition_table.probe(table_key, entry)) {
+        hint = _from_table_frame(board, table_frame, entry.best_cell);
+        if (entry.depth >= depth) {
+            int32_t score = _score_from_table(entry.score, ply);
+            if (entry.bound == TranspositionBound::EXACT) {
+                return score;
+            } else if (entry.bound == TranspositionBound::LOWER) {
+                alpha = std::max(alpha, score);
+            } else if (entry.bound == TranspositionBound::UPPER) {
+                beta = std::min(beta, score);
+            }
+            if (alpha >= beta) {
+                return score;
+            }
+        }
+    }
+
+    int32_t best_score = -SEARCH_INFINITY;
+    Position best_position = no_position;
+    Position positions[QUBIC_NUM_CELLS];
+    size_t num_positions = search_order_moves(board, player, hint, positions);
+    for (size_t position_index = 0; position_index < num_positions; ++position_index) {
+        const Position & position = positions[position_index];
+        search_make_move(board, position, player);
+        int32_t score = -_negamax(board, OPPONENT_MOVE(player), depth - 1, ply + 1, -beta, -alpha, no_position, nodes_searched);
+        search_unmake_move(board, position);
+
+        if (_stop.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        if (score > best_score) {
+            best_score = score;
+            best_position = position;
+        }
+        alpha = std::max(alpha, score);
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    TranspositionEntry new_entry;
+    new_entry.score = _score_to_table(best_score, ply);
+    new_entry.depth = static_cast<uint8_t>(depth);
+    new_entry.best_cell = _to_table_frame(board, table_frame, best_position);
+    if (best_score <= original_alpha) {
+        new_entry.bound = TranspositionBound::UPPER;
+    } else if (best_score >= beta) {
+        new_entry.bound = TranspositionBound::LOWER;
+    } else {
+        new_entry.bound = TranspositionBound::EXACT;
+    }
+    _transposition_table.store(table_key, new_entry);
+    return best_score;
+}
+
+// Win scores depend on the distance from the root, the table keeps them
+// relative to the stored node instead.
+int32_t LazySmpSearch::_score_to_table(int32_t score, size_t ply) const {
+    if (score >= SEARCH_WIN_SCORE - static_cast<int32_t>(_max_rank)) {
+        return score + static_cast<int32_t>(ply);
+    } else if (score <= -SEARCH_WIN_SCORE + static_cast<int32_t>(_max_rank)) {
+        return score - static_cast<int32_t>(ply);
+    }
+    return score;
+}
+
+int32_t LazySmpSearch::_score_from_table(int32_t score, size_t ply) const {
+    if (score >= SEARCH_WIN_SCORE - static_cast<int32_t>(_max_rank)) {
+        return score - static_cast<int32_t>(ply);
+    } else if (score <= -SEARCH_WIN_SCORE + static_cast<int32_t>(_max_rank)) {
+        return score + static_cast<int32_t>(ply);
+    }
+    return score;
+}
+
+bool LazySmpSearch::_should_stop(uint64_t nodes_searched) {
+    if (_stop.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (nodes_searched % SEARCH_DEADLINE_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= _deadline) {
+        _stop.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
@@ -1,15 +1,28 @@
 #include "mainwindow.h"
 #include <QApplication>
 
+#include <chrono>
 #include <cstdio>
 
 #include "constants.h"
 #include "game.h"
+#include "metrics.h"
+#include "trace.h"
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+#ifdef ENABLE_METRICS
+    MetricsExporter metrics_exporter("metrics.prom", std::chrono::seconds(10));
+#endif
+#ifdef ENABLE_TRACING
+    Tracer::start("trace.json");
+#endif
     MainWindow w;
     w.show();
-    return a.exec();
+    int result = a.exec();
+#ifdef ENABLE_TRACING
+    Tracer::stop();
+#endif
+    return result;
 }
@@ -1,16 +1,23 @@
 #include "match_box.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
 #include <map>
 
-MatchBox::MatchBox() {
+MatchBox::MatchBox() :
+    _index(0)
+{
     std::srand(static_cast<unsigned int>(std::time(nullptr)));
 }
 
-MatchBox::MatchBox(const Grid grid) : _grid(grid) {
+MatchBox::MatchBox(const Grid grid) : MatchBox(grid, 0) {
+
+}
+
+MatchBox::MatchBox(const Grid grid, size_t index) : _grid(grid), _index(index) {
     for (size_t row = 0; row < NUM_ROWS; ++row) {
         for (size_t col = 0; col < NUM_COLS; ++col) {
             _remaining_seeds[row][col] = 0;
@@ -25,6 +32,7 @@ MatchBox::MatchBox(const Grid grid) : _grid(grid) {
 
 MatchBox::MatchBox(const MatchBox & other) {
     _grid = other._grid;
+    _index = other._index;
     for (size_t row = 0; row < NUM_ROWS; ++row) {
         for (size_t col = 0; col < NUM_COLS; ++col) {
             _remaining_seeds[row][col] = other._remaining_seeds[row][col];
@@ -34,6 +42,7 @@ MatchBox::MatchBox(const MatchBox & other) {
 
 void MatchBox::operator=(const MatchBox &other) {
     _grid = other._grid;
+    _index = other._index;
     for (size_t row = 0; row < NUM_ROWS; ++row) {
         for (size_t col = 0; col < NUM_COLS; ++col) {
             _remaining_seeds[row][col] = other._remaining_seeds[row][col];
@@ -46,25 +55,36 @@ MovePosition MatchBox::pick_random_move() {
     _grid.print_grid();
     _print_remaining_seeds();
 
+    MovePosition position = sample_move(static_cast<uint32_t>(std::rand()));
+    if (position.first < NUM_ROWS && position.second < NUM_COLS) {
+        printf("Matchbox::pick_random_move(): picked (%lu, %lu)\n", position.first, position.second);
+    }
+    return position;
+}
+
+MovePosition MatchBox::sample_move(uint32_t random_number) const {
+    return sample_seeds(get_seeds(), random_number);
+}
+
+MovePosition MatchBox::sample_seeds(const MatchBoxSeeds & seeds, uint32_t random_number) {
     int32_t total_remaining_seeds = 0;
     for (int8_t row = 0; row < NUM_ROWS; ++row) {
         for (int8_t col = 0; col < NUM_COLS; ++col) {
-            total_remaining_seeds += _remaining_seeds[row][col];
+            total_remaining_seeds += seeds.remaining_seeds[row][col];
         }
     }
     if (total_remaining_seeds <= 0) {
         return std::make_pair(NUM_ROWS, NUM_COLS);
     }
 
-    int16_t random_index = static_cast<int16_t>(std::rand() % total_remaining_seeds);
-    int16_t remaining_index = 0;
+    int32_t random_index = static_cast<int32_t>(random_number % static_cast<uint32_t>(total_remaining_seeds));
+    int32_t remaining_index = 0;
     for (int8_t row = 0; row < NUM_ROWS; ++row) {
         for (int8_t col = 0; col < NUM_COLS; ++col) {
-            if (remaining_index + _remaining_seeds[row][col] > random_index) {
-                printf("Matchbox::pick_random_move(): picked (%d, %d)\n", row, col);
+            if (remaining_index + seeds.remaining_seeds[row][col] > random_index) {
                 return std::make_pair(row, col);
             }
-            remaining_index += _remaining_seeds[row][col];
+            remaining_index += seeds.remaining_seeds[row][col];
         }
     }
     return std::make_pair(NUM_ROWS, NUM_COLS);
@@ -74,18 +94,46 @@ Grid MatchBox::get_grid() const {
     return _grid;
 }
 
+size_t MatchBox::index() const {
+    return _index;
+}
+
+MatchBoxSeeds MatchBox::get_seeds() const {
+    MatchBoxSeeds seeds;
+    for (size_t row = 0; row < NUM_ROWS; ++row) {
+        for (size_t col = 0; col < NUM_COLS; ++col) {
+            seeds.remaining_seeds[row][col] = _remaining_seeds[row][col];
+        }
+    }
+    return seeds;
+}
+
+void MatchBox::set_seeds(const MatchBoxSeeds & seeds) {
+    for (size_t row = 0; row < NUM_ROWS; ++row) {
+        for (size_t col = 0; col < NUM_COLS; ++col) {
+            assert(_grid.value(row, col) == Move::EMPTY || seeds.remaining_seeds[row][col] == 0);
+            _remaining_seeds[row][col] = seeds.remaining_seeds[row][col];
+        }
+    }
+}
+
+int8_t MatchBox::remaining_seeds(MovePosition move_position) const {
+    assert(move_position.first < NUM_ROWS && move_position.second < NUM_COLS);
+    return _remaining_seeds[move_position.first][move_position.second];
+}
+
 void MatchBox::reward_drawn_move(MovePosition move) {
     size_t row = move.first, col = move.second;
     assert(row < NUM_ROWS && col < NUM_COLS);
     assert (_grid.value(row, col) == Move::EMPTY);
-    _remaining_seeds[row][col] += 1;
+    _remaining_seeds[row][col] += MATCH_BOX_DRAW_REWARD;
 }
 
 void MatchBox::reward_move(MovePosition move) {
     size_t row = move.first, col = move.second;
     assert(row < NUM_ROWS && col < NUM_COLS);
     assert (_grid.value(row, col) == Move::EMPTY);
-    _remaining_seeds[row][col] += 3;
+    _remaining_seeds[row][col] += MATCH_BOX_WIN_REWARD;
 }
 
 void MatchBox::punish_move(MovePosition move) {
@@ -93,10 +141,18 @@ void MatchBox::punish_move(MovePosition move) {
     assert (row < NUM_ROWS && col < NUM_COLS);
     assert (_grid.value(row, col) == Move::EMPTY);
     if (_remaining_seeds[row][col] > 1) {
-        _remaining_seeds[row][col] -= 1;
+        _remaining_seeds[row][col] -= MATCH_BOX_LOSS_PENALTY;
     }
 }
 
+void MatchBox::apply_seed_delta(MovePosition move, int32_t rewards, int32_t punishments) {
+    size_t row = move.first, col = move.second;
+    assert (row < NUM_ROWS && col < NUM_COLS);
+    assert (_grid.value(row, col) == Move::EMPTY);
+    assert (rewards >= 0 && punishments >= 0);
+    _remaining_seeds[row][col] = apply_seed_delta_rule(_remaining_seeds[row][col], rewards, punishments);
+}
+
 void MatchBox::_print_remaining_seeds() const {
     for (int8_t row = 0; row < NUM_ROWS; ++row) {
         for (int8_t col = 0; col < NUM_COLS; ++col) {
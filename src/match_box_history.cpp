@@ -0,0 +1,43 @@
+#include "match_box_history.h"
+
+#include <cassert>
+#include <vector>
+
+#include "match_box.h"
+
+MatchBoxHistory::MatchBoxHistory() {
+    clear();
+}
+
+void MatchBoxHistory::clear() {
+    _match_boxes.clear();
+    _move_positions.clear();
+}
+
+void MatchBoxHistory::record_move(MatchBox * match_box, MovePosition move_position) {
+    assert(match_box != nullptr);
+    _match_boxes.push_back(match_box);
+    _move_positions.push_back(move_position);
+}
+
+void MatchBoxHistory::append(const MatchBoxHistory & other) {
+    _match_boxes.insert(_match_boxes.end(), other._match_boxes.begin(), other._match_boxes.end());
+    _move_positions.insert(_move_positions.end(), other._move_positions.begin(), other._move_positions.end());
+}
+
+size_t MatchBoxHistory::size() const {
+    assert(_match_boxes.size() == _move_positions.size());
+    return _match_boxes.size();
+}
+
+bool MatchBoxHistory::empty() const {
+    return _match_boxes.empty();
+}
+
+MatchBox * MatchBoxHistory::match_box(size_t index) const {
+    return _match_boxes.at(index);
+}
+
+MovePosition MatchBoxHistory::move_position(size_t index) const {
+    return _move_positions.at(index);
+}
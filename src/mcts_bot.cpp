@@ -0,0 +1,290 @@
+#include "mcts_bot.h"
+
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "constants.h"
+#include "game_bot.h"
+#include "grid.h"
+#include "task_scheduler.h"
+
+#define MCTS_MAX_PATH_LENGTH ((MAX_RANK) + 1)
+
+static uint64_t _next_random(uint64_t & random_state) {
+    // xorshift64*
+    random_state ^= random_state >> 12;
+    random_state ^= random_state << 25;
+    random_state ^= random_state >> 27;
+    return random_state * 0x2545F4914F6CDD1DULL;
+}
+
+static Move _winner(GameState game_state) {
+    switch (game_state) {
+        case GameState::CROSS_WINS:
+            return Move::CROSS;
+        case GameState::NOUGHT_WINS:
+            return Move::NOUGHT;
+        case GameState::ONGOING:
+        case GameState::DRAW:
+        case GameState::INVALID:
+        default:
+            return Move::EMPTY;
+    }
+}
+
+MctsNodeArena::MctsNodeArena(size_t capacity) :
+    _nodes(new MctsNode[capacity]),
+    _capacity(capacity),
+    _size(0)
+{
+
+}
+
+void MctsNodeArena::reset() {
+    _size.store(0, std::memory_order_relaxed);
+}
+
+MctsNode * MctsNodeArena::allocate(size_t num_nodes) {
+    size_t offset = _size.fetch_add(num_nodes, std::memory_order_relaxed);
+    if (offset + num_nodes > _capacity) {
+        return nullptr;
+    }
+    return &_nodes[offset];
+}
+
+size_t MctsNodeArena::size() const {
+    size_t size = _size.load(std::memory_order_relaxed);
+    return size < _capacity ? size : _capacity;
+}
+
+MctsConfig MctsBot::default_config() {
+    MctsConfig config;
+    config.num_threads = 1;
+    config.num_iterations = 20000;
+    config.parallelism = MctsParallelism::TREE;
+    config.exploration = 1.4f;
+    config.virtual_loss = 3;
+    config.arena_capacity = 1 << 18;
+    config.seed = 0x9E3779B97F4A7C15ULL;
+    return config;
+}
+
+MctsBot::MctsBot(const MctsConfig & config, TaskScheduler & scheduler) :
+    _config(config),
+    _scheduler(scheduler),
+    _prior_bot(nullptr),
+    _iterations(0)
+{
+    assert(_config.num_threads > 0);
+    size_t num_arenas = _config.parallelism == MctsParallelism::ROOT ? _config.num_threads : 1;
+    for (size_t arena_index = 0; arena_index < num_arenas; ++arena_index) {
+        _arenas.emplace_back(new MctsNodeArena(_config.arena_capacity));
+    }
+}
+
+void MctsBot::set_prior_bot(GameBot * prior_bot) {
+    _prior_bot = prior_bot;
+}
+
+bool MctsBot::get_next_move(const Grid & grid, MovePosition & position) {
+    position = std::make_pair(NUM_ROWS, NUM_COLS);
+    Move player = grid.next_player();
+    if (player == Move::EMPTY || grid.game_state() != GameState::ONGOING) {
+        return false;
+    }
+
+    _iterations.store(0, std::memory_order_relaxed);
+    std::vector<MctsNode *> roots;
+    for (std::unique_ptr<MctsNodeArena> & arena : _arenas) {
+        arena->reset();
+        MctsNode * root = arena->allocate(1);
+        assert(root != nullptr);
+        _initialise_node(root, -1, -1, OPPONENT_MOVE(player), 1.0f);
+        roots.push_back(root);
+    }
+
+    size_t num_threads = _config.num_threads;
+    TaskGroup group(_scheduler);
+    for (size_t thread_index = 0; thread_index < num_threads; ++thread_index) {
+        size_t tree_index = _config.parallelism == MctsParallelism::ROOT ? thread_index : 0;
+        size_t num_iterations = _config.num_iterations / num_threads + (thread_index < _config.num_iterations % num_threads ? 1 : 0);
+        uint64_t seed = _config.seed + 0x9E3779B97F4A7C15ULL * (thread_index + 1);
+        MctsNode * root = roots.at(tree_index);
+        MctsNodeArena * arena = _arenas.at(tree_index).get();
+        group.run([this, &grid, root, arena, num_iterations, seed]() {
+            _run_iterations(grid, root, *arena, num_iterations, seed);
+        });
+    }
+    group.wait();
+
+    // Root-parallel trees vote with their visit counts.
+    std::map<MovePosition, uint64_t> visits_by_position;
+    for (MctsNode * root : roots) {
+        MctsNode * children = root->children.load(std::memory_order_acquire);
+        if (children == nullptr) {
+            continue;
+        }
+        for (uint8_t child_index = 0; child_index < root->num_children; ++child_index) {
+            const MctsNode & child = children[child_index];
+            visits_by_position[std::make_pair(child.row, child.col)] += child.visits.load(std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t best_visits = 0;
+    for (const auto & entry : visits_by_position) {
+        if (entry.second > best_visits) {
+            best_visits = entry.second;
+            position = entry.first;
+        }
+    }
+    return best_visits > 0;
+}
+
+MctsStatistics MctsBot::get_statistics() const {
+    MctsStatistics statistics;
+    statistics.iterations = _iterations.load(std::memory_order_relaxed);
+    statistics.nodes_allocated = 0;
+    for (const std::unique_ptr<MctsNodeArena> & arena : _arenas) {
+        statistics.nodes_allocated += arena->size();
+    }
+    return statistics;
+}
+
+void MctsBot::_run_iterations(const Grid & root_grid, MctsNode * root, MctsNodeArena & arena, size_t num_iterations, uint64_t seed) {
+    uint64_t random_state = seed != 0 ? seed : 1;
+    MctsNode * path[MCTS_MAX_PATH_LENGTH + 1];
+
+    for (size_t iteration = 0; iteration < num_iterations; ++iteration) {
+        Grid grid = root_grid;
+        MctsNode * node = root;
+        Move player = OPPONENT_MOVE(root->player);
+        size_t path_length = 0;
+        path[path_length++] = root;
+
+        while (true) {
+            MctsNode * children = node->children.load(std::memory_order_acquire);
+            if (children == nullptr) {
+                if (grid.game_state() != GameState::ONGOING) {
+                    break;
+                }
+                // Leaves are expanded on their second visit.
+                if (node != root && node->visits.load(std::memory_order_relaxed) == 0) {
+                    break;
+                }
+                if (!_expand(grid, node, player, arena)) {
+                    break;
+                }
+            }
+            MctsNode * child = _select_child(node);
+            child->virtual_losses.fetch_add(_config.virtual_loss, std::memory_order_relaxed);
+            grid.make_move(child->row, child->col, child->player);
+            path[path_length++] = child;
+            node = child;
+            player = OPPONENT_MOVE(player);
+        }
+
+        Move winner = _rollout(grid, player, random_state);
+
+        for (size_t path_index = 0; path_index < path_length; ++path_index) {
+            MctsNode * path_node = path[path_index];
+            uint64_t points = winner == Move::EMPTY ? 1 : winner == path_node->player ? 2 : 0;
+            path_node->score.fetch_add(points, std::memory_order_relaxed);
+            path_node->visits.fetch_add(1, std::memory_order_relaxed);
+            if (path_index > 0) {
+                path_node->virtual_losses.fetch_sub(_config.virtual_loss, std::memory_order_relaxed);
+            }
+        }
+        _iterations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool MctsBot::_expand(const Grid & grid, MctsNode * node, Move player, MctsNodeArena & arena) {
+    bool expected = false;
+    if (!node->expanding.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        // Another worker is expanding this node; roll out from here instead
+        // of waiting for it.
+        return false;
+    }
+
+    std::vector<MovePosition> valid_positions = grid.valid_move_positions();
+    MctsNode * children = arena.allocate(valid_positions.size());
+    if (children == nullptr) {
+        return false;
+    }
+
+    float priors[NUM_ROWS][NUM_COLS];
+    bool use_priors = _prior_bot != nullptr && _prior_bot->get_move_priors(grid, priors);
+    for (size_t child_index = 0; child_index < valid_positions.size(); ++child_index) {
+        const MovePosition & position = valid_positions.at(child_index);
+        float prior = use_priors ? priors[position.first][position.second] : 1.0f / valid_positions.size();
+        _initialise_node(&children[child_index], static_cast<int8_t>(position.first), static_cast<int8_t>(position.second), player, prior);
+    }
+    node->num_children = static_cast<uint8_t>(valid_positions.size());
+    node->children.store(children, std::memory_order_release);
+    return true;
+}
+
+MctsNode * MctsBot::_select_child(MctsNode * node) const {
+    MctsNode * children = node->children.load(std::memory_order_acquire);
+    assert(children != nullptr);
+
+    uint32_t parent_visits = node->visits.load(std::memory_order_relaxed) + node->virtual_losses.load(std::memory_order_relaxed);
+    float exploration = _config.exploration * std::sqrt(static_cast<float>(parent_visits + 1));
+
+    MctsNode * best_child = &children[0];
+    float best_value = -1.0f;
+    for (uint8_t child_index = 0; child_index < node->num_children; ++child_index) {
+        MctsNode * child = &children[child_index];
+        // Virtual losses count as visits without score, which steers other
+        // workers away from the path currently being searched.
+        uint32_t visits = child->visits.load(std::memory_order_relaxed) + child->virtual_losses.load(std::memory_order_relaxed);
+        float mean_value = visits > 0 ? 0.5f * child->score.load(std::memory_order_relaxed) / visits : 0.5f;
+        float value = mean_value + exploration * child->prior / (1 + visits);
+        if (value > best_value) {
+            best_value = value;
+            best_child = child;
+        }
+    }
+    return best_child;
+}
+
+Move MctsBot::_rollout(Grid & grid, Move player, uint64_t & random_state) const {
+    MovePosition empty_positions[MAX_RANK];
+    size_t num_empty_positions = 0;
+    for (int8_t row = 0; row < NUM_ROWS; ++row) {
+        for (int8_t col = 0; col < NUM_COLS; ++col) {
+            if (grid.value(row, col) == Move::EMPTY) {
+                empty_positions[num_empty_positions++] = std::make_pair(row, col);
+            }
+        }
+    }
+
+    GameState game_state = grid.game_state();
+    while (game_state == GameState::ONGOING && num_empty_positions > 0) {
+        size_t index = _next_random(random_state) % num_empty_positions;
+        MovePosition position = empty_positions[index];
+        empty_positions[index] = empty_positions[--num_empty_positions];
+
+        grid.make_move(position.first, position.second, player);
+        game_state = grid.game_state();
+        player = OPPONENT_MOVE(player);
+    }
+    return _winner(game_state);
+}
+
+void MctsBot::_initialise_node(MctsNode * node, int8_t row, int8_t col, Move player, float prior) const {
+    node->children.store(nullptr, std::memory_order_relaxed);
+    node->expanding.store(false, std::memory_order_relaxed);
+    node->visits.store(0, std::memory_order_relaxed);
+    node->virtual_losses.store(0, std::memory_order_relaxed);
+    node->score.store(0, std::memory_order_relaxed);
+    node->prior = prior;
+    node->num_children = 0;
+    node->row = row;
+    node->col = col;
+    node->player = player;
+}
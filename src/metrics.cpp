@@ -0,0 +1,254 @@
+#include "metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define METRICS_PREFIX "tictactoe_"
+
+namespace {
+
+struct ThreadMetrics {
+    LatencyHistogram histograms[static_cast<size_t>(MetricTimer::NUM_TIMERS)];
+    std::atomic<uint64_t> counters[static_cast<size_t>(MetricCounter::NUM_COUNTERS)];
+};
+
+// Slots are registered once per thread and never freed, so readers can
+// walk them while their threads keep recording or have exited.
+std::mutex & _registry_mutex() {
+    static std::mutex registry_mutex;
+    return registry_mutex;
+}
+
+std::vector<ThreadMetrics *> & _registry() {
+    static std::vector<ThreadMetrics *> registry;
+    return registry;
+}
+
+ThreadMetrics & _thread_metrics() {
+    static thread_local ThreadMetrics * thread_metrics = []() {
+        ThreadMetrics * new_thread_metrics = new ThreadMetrics();
+        for (std::atomic<uint64_t> & counter : new_thread_metrics->counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> lock(_registry_mutex());
+        _registry().push_back(new_thread_metrics);
+        return new_thread_metrics;
+    }();
+    return *thread_metrics;
+}
+
+void _add_relaxed(std::atomic<uint64_t> & value, uint64_t increment) {
+    value.store(value.load(std::memory_order_relaxed) + increment, std::memory_order_relaxed);
+}
+
+}
+
+LatencyHistogram::LatencyHistogram() {
+    for (std::atomic<uint64_t> & bucket : _buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    _count.store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    _add_relaxed(_buckets[bucket_index(nanoseconds)], 1);
+    _add_relaxed(_count, 1);
+    _add_relaxed(_sum, nanoseconds);
+}
+
+void LatencyHistogram::add(const LatencyHistogram & other) {
+    // Only used on histograms private to the reader.
+    for (size_t index = 0; index < METRICS_NUM_BUCKETS; ++index) {
+        _add_relaxed(_buckets[index], other._buckets[index].load(std::memory_order_relaxed));
+    }
+    _add_relaxed(_count, other._count.load(std::memory_order_relaxed));
+    _add_relaxed(_sum, other._sum.load(std::memory_order_relaxed));
+}
+
+uint64_t LatencyHistogram::count() const {
+    return _count.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::sum() const {
+    return _sum.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count_at_most(uint64_t nanoseconds) const {
+    // Whole buckets only; one that also holds larger values is left out.
+    uint64_t count = 0;
+    for (size_t index = 0; index < METRICS_NUM_BUCKETS && bucket_upper_bound(index) <= nanoseconds; ++index) {
+        count += _buckets[index].load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const {
+    uint64_t total_count = count();
+    if (total_count == 0) {
+        return 0;
+    }
+    uint64_t target_count = static_cast<uint64_t>(percentile / 100.0 * total_count + 0.5);
+    target_count = std::max<uint64_t>(1, std::min(target_count, total_count));
+    uint64_t running_count = 0;
+    for (size_t index = 0; index < METRICS_NUM_BUCKETS; ++index) {
+        running_count += _buckets[index].load(std::memory_order_relaxed);
+        if (running_count >= target_count) {
+            return bucket_upper_bound(index);
+        }
+    }
+    return bucket_upper_bound(METRICS_NUM_BUCKETS - 1);
+}
+
+size_t LatencyHistogram::bucket_index(uint64_t nanoseconds) {
+    // Laid out on nanoseconds - 1 so that each bucket is (lower, upper];
+    // 0 shares the first bucket with 1.
+    if (nanoseconds > 0) {
+        --nanoseconds;
+    }
+    if (nanoseconds < METRICS_SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(nanoseconds);
+    }
+    uint64_t max_value = (1ULL << (METRICS_MAX_EXPONENT + 1)) - 1;
+    if (nanoseconds > max_value) {
+        nanoseconds = max_value;
+    }
+    size_t exponent = 63 - static_cast<size_t>(__builtin_clzll(nanoseconds));
+    size_t sub_bucket = static_cast<size_t>(nanoseconds >> (exponent - METRICS_SUB_BUCKET_BITS)) & (METRICS_SUB_BUCKET_COUNT - 1);
+    return (exponent - METRICS_SUB_BUCKET_BITS + 1) * METRICS_SUB_BUCKET_COUNT + sub_bucket;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t bucket_index) {
+    if (bucket_index < METRICS_SUB_BUCKET_COUNT) {
+        return bucket_index + 1;
+    }
+    size_t exponent = bucket_index / METRICS_SUB_BUCKET_COUNT + METRICS_SUB_BUCKET_BITS - 1;
+    size_t sub_bucket = bucket_index % METRICS_SUB_BUCKET_COUNT;
+    uint64_t bucket_width = 1ULL << (exponent - METRICS_SUB_BUCKET_BITS);
+    return (METRICS_SUB_BUCKET_COUNT + sub_bucket) * bucket_width + bucket_width;
+}
+
+void Metrics::record_time(MetricTimer timer, uint64_t nanoseconds) {
+    _thread_metrics().histograms[static_cast<size_t>(timer)].record(nanoseconds);
+}
+
+void Metrics::add_to_counter(MetricCounter counter, uint64_t value) {
+    _add_relaxed(_thread_metrics().counters[static_cast<size_t>(counter)], value);
+}
+
+void Metrics::get_histogram(MetricTimer timer, LatencyHistogram & histogram) {
+    std::lock_guard<std::mutex> lock(_registry_mutex());
+    for (const ThreadMetrics * thread_metrics : _registry()) {
+        histogram.add(thread_metrics->histograms[static_cast<size_t>(timer)]);
+    }
+}
+
+uint64_t Metrics::get_counter(MetricCounter counter) {
+    std::lock_guard<std::mutex> lock(_registry_mutex());
+    uint64_t value = 0;
+    for (const ThreadMetrics * thread_metrics : _registry()) {
+        value += thread_metrics->counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    }
+    return value;
+}
+
+bool Metrics::write_prometheus(const std::string & filename) {
+    // Written next to the target and renamed, so a scraper never reads a
+    // half-written file.
+    std::string temporary_filename = filename + ".tmp";
+    FILE * file = fopen(temporary_filename.c_str(), "w");
+    if (file == nullptr) {
+        printf("Metrics::write_prometheus(): Cannot open file = %s\n", temporary_filename.c_str());
+        return false;
+    }
+
+    for (size_t timer_index = 0; timer_index < static_cast<size_t>(MetricTimer::NUM_TIMERS); ++timer_index) {
+        MetricTimer timer = static_cast<MetricTimer>(timer_index);
+        std::unique_ptr<LatencyHistogram> histogram(new LatencyHistogram());
+        get_histogram(timer, *histogram);
+
+        const char * name = STR_METRIC_TIMER(timer);
+        fprintf(file, "# HELP " METRICS_PREFIX "%s_seconds Latency of %s.\n", name, name);
+        fprintf(file, "# TYPE " METRICS_PREFIX "%s_seconds histogram\n", name);
+        for (size_t exponent = METRICS_SUB_BUCKET_BITS + 1; exponent <= METRICS_MAX_EXPONENT; ++exponent) {
+            uint64_t bound = 1ULL << exponent;
+            fprintf(file, METRICS_PREFIX "%s_seconds_bucket{le=\"%.9g\"} %lu\n", name, bound * 1e-9, histogram->count_at_most(bound));
+        }
+        fprintf(file, METRICS_PREFIX "%s_seconds_bucket{le=\"+Inf\"} %lu\n", name, histogram->count());
+        fprintf(file, METRICS_PREFIX "%s_seconds_sum %.9f\n", name, histogram->sum() * 1e-9);
+        fprintf(file, METRICS_PREFIX "%s_seconds_count %lu\n", name, histogram->count());
+    }
+    for (size_t counter_index = 0; counter_index < static_cast<size_t>(MetricCounter::NUM_COUNTERS); ++counter_index) {
+        MetricCounter counter = static_cast<MetricCounter>(counter_index);
+        const char * name = STR_METRIC_COUNTER(counter);
+        fprintf(file, "# TYPE " METRICS_PREFIX "%s_total counter\n", name);
+        fprintf(file, METRICS_PREFIX "%s_total %lu\n", name, get_counter(counter));
+    }
+
+    bool success = fclose(file) == 0 && rename(temporary_filename.c_str(), filename.c_str()) == 0;
+    if (!success) {
+        printf("Metrics::write_prometheus(): Cannot write file = %s\n", filename.c_str());
+    }
+    return success;
+}
+
+void Metrics::print() {
+    for (size_t timer_index = 0; timer_index < static_cast<size_t>(MetricTimer::NUM_TIMERS); ++timer_index) {
+        MetricTimer timer = static_cast<MetricTimer>(timer_index);
+        std::unique_ptr<LatencyHistogram> histogram(new LatencyHistogram());
+        get_histogram(timer, *histogram);
+        printf("%-28s count = %10lu, p50 = %10lu ns, p99 = %10lu ns, p99.9 = %10lu ns\n", STR_METRIC_TIMER(timer),
+               histogram->count(), histogram->percentile(50.0), histogram->percentile(99.0), histogram->percentile(99.9));
+    }
+    for (size_t counter_index = 0; counter_index < static_cast<size_t>(MetricCounter::NUM_COUNTERS); ++counter_index) {
+        MetricCounter counter = static_cast<MetricCounter>(counter_index);
+        printf("%-28s %lu\n", STR_METRIC_COUNTER(counter), get_counter(counter));
+    }
+}
+
+ScopedMetricTimer::ScopedMetricTimer(MetricTimer timer) :
+    _timer(timer),
+    _start(std::chrono::steady_clock::now())
+{
+
+}
+
+ScopedMetricTimer::~ScopedMetricTimer() {
+    auto elapsed = std::chrono::steady_clock::now() - _start;
+    Metrics::record_time(_timer, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
+
+MetricsExporter::MetricsExporter(const std::string & filename, std::chrono::milliseconds interval) :
+    _filename(filename),
+    _interval(interval),
+    _stopping(false)
+{
+    _thread = std::thread(&MetricsExporter::_export_loop, this);
+}
+
+MetricsExporter::~MetricsExporter() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _stop_condition.notify_one();
+    _thread.join();
+    Metrics::write_prometheus(_filename);
+}
+
+void MetricsExporter::_export_loop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stop_condition.wait_for(lock, _interval, [this]() { return _stopping; })) {
+        lock.unlock();
+        Metrics::write_prometheus(_filename);
+        lock.lock();
+    }
+}
@@ -0,0 +1,46 @@
+#include "move_ordering.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "constants.h"
+#include "grid.h"
+
+size_t order_moves(const Grid & grid, Move player, MovePosition hint, MovePosition positions[MAX_RANK]) {
+    Move opponent = OPPONENT_MOVE(player);
+    int32_t priorities[MAX_RANK];
+    size_t num_positions = 0;
+
+    for (int8_t row = 0; row < NUM_ROWS; ++row) {
+        for (int8_t col = 0; col < NUM_COLS; ++col) {
+            if (grid.value(row, col) != Move::EMPTY) {
+                continue;
+            }
+            int32_t priority = 0;
+            if (hint.first == static_cast<size_t>(row) && hint.second == static_cast<size_t>(col)) {
+                priority = 1000;
+            } else if (grid.is_winning_move(row, col, player)) {
+                priority = 500;
+            } else if (grid.is_winning_move(row, col, opponent)) {
+                priority = 250;
+            } else {
+                // Cells closer to the centre lie on more lines.
+                int32_t row_distance = std::abs(2 * row - (NUM_ROWS - 1));
+                int32_t col_distance = std::abs(2 * col - (NUM_COLS - 1));
+                bool corner = row_distance == NUM_ROWS - 1 && col_distance == NUM_COLS - 1;
+                priority = 100 - row_distance - col_distance + (corner ? 2 : 0);
+            }
+
+            // Insertion sort, the list never has more than MAX_RANK entries.
+            size_t index = num_positions++;
+            while (index > 0 && priorities[index - 1] < priority) {
+                priorities[index] = priorities[index - 1];
+                positions[index] = positions[index - 1];
+                --index;
+            }
+            priorities[index] = priority;
+            positions[index] = std::make_pair(row, col);
+        }
+    }
+    return num_positions;
+}
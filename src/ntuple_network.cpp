@@ -0,0 +1,290 @@
+#include "ntuple_network.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define NTUPLE_HAVE_AVX2_PATH
+#endif
+
+#include "constants.h"
+#include "grid.h"
+#include "grid_symmetry.h"
+
+#define NTUPLE_MAGIC "TTTNTUP1"
+
+// Followed by the weights.
+struct NTupleHeader {
+    char magic[8];
+    uint32_t num_rows;
+    uint32_t num_cols;
+    uint64_t num_weights;
+};
+
+static const int32_t _POWERS_OF_THREE[NTUPLE_MAX_TUPLE_SIZE] = {1, 3, 9, 27};
+
+#ifdef NTUPLE_HAVE_AVX2_PATH
+static bool _cpu_has_avx2() {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+
+// Built for AVX2 on its own, so the rest of the file still runs anywhere.
+__attribute__((target("avx2")))
+static void _evaluate_lanes_avx2(const int32_t states[MAX_RANK][NTUPLE_BATCH_SIZE], const int32_t * tuple_cells, const int32_t * tuple_sizes,
+    const int32_t * tuple_offsets, size_t num_tuples, const float * weights, float sums[NTUPLE_BATCH_SIZE]) {
+    static_assert(NTUPLE_BATCH_SIZE == 8, "one AVX2 register of lanes");
+    __m256 sum = _mm256_setzero_ps();
+    for (size_t tuple = 0; tuple < num_tuples; ++tuple) {
+        const int32_t * cells = tuple_cells + tuple * NTUPLE_MAX_TUPLE_SIZE;
+        __m256i indices = _mm256_set1_epi32(tuple_offsets[tuple]);
+        for (int32_t cell = 0; cell < tuple_sizes[tuple]; ++cell) {
+            __m256i cell_states = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(states[cells[cell]]));
+            indices = _mm256_add_epi32(indices, _mm256_mullo_epi32(cell_states, _mm256_set1_epi32(_POWERS_OF_THREE[cell])));
+        }
+        sum = _mm256_add_ps(sum, _mm256_i32gather_ps(weights, indices, 4));
+    }
+    _mm256_storeu_ps(sums, sum);
+}
+#endif
+
+NTupleNetwork::NTupleNetwork() :
+    _learning_rate(NTUPLE_DEFAULT_LEARNING_RATE)
+{
+    // Rows, cut into windows when longer than a tuple.
+    size_t row_length = std::min<size_t>(NUM_COLS, NTUPLE_MAX_TUPLE_SIZE);
+    for (size_t row = 0; row < NUM_ROWS; ++row) {
+        for (size_t first_col = 0; first_col + row_length <= NUM_COLS; ++first_col) {
+            std::vector<MovePosition> cells;
+            for (size_t col = first_col; col < first_col + row_length; ++col) {
+                cells.push_back(MovePosition(row, col));
+            }
+            _add_tuple(cells);
+        }
+    }
+    for (size_t row = 0; row + 1 < NUM_ROWS; ++row) {
+        for (size_t col = 0; col + 1 < NUM_COLS; ++col) {
+            _add_tuple({MovePosition(row, col), MovePosition(row, col + 1), MovePosition(row + 1, col), MovePosition(row + 1, col + 1)});
+        }
+    }
+    std::vector<MovePosition> diagonal;
+    for (size_t index = 0; index < std::min<size_t>(std::min(NUM_ROWS, NUM_COLS), NTUPLE_MAX_TUPLE_SIZE); ++index) {
+        diagonal.push_back(MovePosition(index, index));
+    }
+    _add_tuple(diagonal);
+}
+
+size_t NTupleNetwork::num_tuples() const {
+    return _tuple_sizes.size();
+}
+
+size_t NTupleNetwork::num_weights() const {
+    return _weights.size();
+}
+
+void NTupleNetwork::set_learning_rate(float learning_rate) {
+    _learning_rate = learning_rate;
+}
+
+float NTupleNetwork::evaluate(const Grid & grid, Move player) const {
+    float value = 0.0f;
+    evaluate_batch(&grid, &player, &value, 1);
+    return value;
+}
+
+void NTupleNetwork::evaluate_batch(const Grid * grids, const Move * players, float * values, size_t num_grids) const {
+#ifdef NTUPLE_HAVE_AVX2_PATH
+    _evaluate_batch(grids, players, values, num_grids, _cpu_has_avx2());
+#else
+    _evaluate_batch(grids, players, values, num_grids, false);
+#endif
+}
+
+void NTupleNetwork::evaluate_batch_scalar(const Grid * grids, const Move * players, float * values, size_t num_grids) const {
+    _evaluate_batch(grids, players, values, num_grids, false);
+}
+
+bool NTupleNetwork::select_move(const Grid & grid, MovePosition & position) const {
+    // Greedy over the afterstates, all evaluated in one batch.
+    Move player = grid.next_player();
+    std::vector<MovePosition> positions = grid.valid_move_positions();
+    if (player == Move::EMPTY || positions.empty()) {
+        return false;
+    }
+    std::vector<Grid> afterstates(positions.size(), grid);
+    std::vector<Move> players(positions.size(), player);
+    std::vector<float> values(positions.size());
+    for (size_t position_index = 0; position_index < positions.size(); ++position_index) {
+        afterstates[position_index].make_move(positions[position_index].first, positions[position_index].second, player);
+    }
+    evaluate_batch(afterstates.data(), players.data(), values.data(), afterstates.size());
+
+    size_t best_index = 0;
+    for (size_t position_index = 0; position_index < positions.size(); ++position_index) {
+        // Finished games are scored exactly.
+        GameState game_state = afterstates[position_index].game_state();
+        if (game_state == GameState::DRAW) {
+            values[position_index] = 0.0f;
+        } else if (game_state != GameState::ONGOING) {
+            values[position_index] = 1.0f;
+        }
+        if (values[position_index] > values[best_index]) {
+            best_index = position_index;
+        }
+    }
+    position = positions[best_index];
+    return true;
+}
+
+void NTupleNetwork::train_game(const std::vector<Grid> & afterstates, Move player, float outcome) {
+    // Each afterstate moves toward the value of the next one the same
+    // player left, the last one toward the outcome.
+    std::lock_guard<std::mutex> lock(_train_mutex);
+    for (size_t afterstate_index = 0; afterstate_index < afterstates.size(); ++afterstate_index) {
+        float value = evaluate(afterstates[afterstate_index], player);
+        float target = afterstate_index + 1 < afterstates.size() ? evaluate(afterstates[afterstate_index + 1], player) : outcome;
+        _update(afterstates[afterstate_index], player, _learning_rate * (target - value) / static_cast<float>(num_tuples()));
+    }
+}
+
+bool NTupleNetwork::save(const std::string & filename) const {
+    NTupleHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, NTUPLE_MAGIC, sizeof(header.magic));
+    header.num_rows = NUM_ROWS;
+    header.num_cols = NUM_COLS;
+    header.num_weights = _weights.size();
+
+    FILE * file = fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        printf("NTupleNetwork::save(): Cannot open file = %s\n", filename.c_str());
+        return false;
+    }
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(_weights.data(), sizeof(float), _weights.size(), file) == _weights.size();
+    fclose(file);
+    if (!success) {
+        printf("NTupleNetwork::save(): Cannot write file = %s\n", filename.c_str());
+    }
+    return success;
+}
+
+bool NTupleNetwork::load(const std::string & filename) {
+    FILE * file = fopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+        printf("NTupleNetwork::load(): Cannot open file = %s\n", filename.c_str());
+        return false;
+    }
+    NTupleHeader header;
+    std::vector<float> weights(_weights.size());
+    bool success = fread(&header, sizeof(header), 1, file) == 1
+        && memcmp(header.magic, NTUPLE_MAGIC, sizeof(header.magic)) == 0
+        && header.num_rows == NUM_ROWS
+        && header.num_cols == NUM_COLS
+        && header.num_weights == weights.size()
+        && fread(weights.data(), sizeof(float), weights.size(), file) == weights.size();
+    fclose(file);
+    if (!success) {
+        printf("NTupleNetwork::load(): Invalid network file = %s\n", filename.c_str());
+        return false;
+    }
+    _weights.swap(weights);
+    return true;
+}
+
+void NTupleNetwork::_add_tuple(const std::vector<MovePosition> & cells) {
+    assert(!cells.empty() && cells.size() <= NTUPLE_MAX_TUPLE_SIZE);
+    // One lookup table, read by every distinct image of the tuple.
+    int32_t offset = static_cast<int32_t>(_weights.size());
+    _weights.resize(_weights.size() + static_cast<size_t>(_POWERS_OF_THREE[cells.size() - 1]) * 3, 0.0f);
+    std::set<std::vector<int32_t>> images;
+    for (GridTransformation grid_transformation : GRID_SYMMETRIES) {
+        if (!grid_symmetry_is_valid(grid_transformation)) {
+            continue;
+        }
+        std::vector<int32_t> image(NTUPLE_MAX_TUPLE_SIZE, 0);
+        for (size_t cell = 0; cell < cells.size(); ++cell) {
+            MovePosition source = grid_symmetry_source(grid_transformation, cells[cell].first, cells[cell].second);
+            image[cell] = static_cast<int32_t>(source.first * NUM_COLS + source.second);
+        }
+        if (!images.insert(image).second) {
+            continue;
+        }
+        _tuple_cells.insert(_tuple_cells.end(), image.begin(), image.end());
+        _tuple_sizes.push_back(static_cast<int32_t>(cells.size()));
+        _tuple_offsets.push_back(offset);
+    }
+}
+
+void NTupleNetwork::_encode(const Grid * grids, const Move * players, size_t num_grids, int32_t states[MAX_RANK][NTUPLE_BATCH_SIZE]) const {
+    assert(num_grids <= NTUPLE_BATCH_SIZE);
+    // 0 empty, 1 own, 2 opponent's; unused lanes read as an empty grid.
+    for (size_t row = 0; row < NUM_ROWS; ++row) {
+        for (size_t col = 0; col < NUM_COLS; ++col) {
+            for (size_t lane = 0; lane < NTUPLE_BATCH_SIZE; ++lane) {
+                int32_t state = 0;
+                if (lane < num_grids) {
+                    Move move = grids[lane].value(static_cast<int8_t>(row), static_cast<int8_t>(col));
+                    state = move == Move::EMPTY ? 0 : move == players[lane] ? 1 : 2;
+                }
+                states[row * NUM_COLS + col][lane] = state;
+            }
+        }
+    }
+}
+
+void NTupleNetwork::_evaluate_lanes(const int32_t states[MAX_RANK][NTUPLE_BATCH_SIZE], float sums[NTUPLE_BATCH_SIZE], bool use_simd) const {
+#ifdef NTUPLE_HAVE_AVX2_PATH
+    if (use_simd) {
+        _evaluate_lanes_avx2(states, _tuple_cells.data(), _tuple_sizes.data(), _tuple_offsets.data(), num_tuples(), _weights.data(), sums);
+        return;
+    }
+#else
+    (void) use_simd;
+#endif
+    std::fill(sums, sums + NTUPLE_BATCH_SIZE, 0.0f);
+    for (size_t tuple = 0; tuple < num_tuples(); ++tuple) {
+        const int32_t * cells = &_tuple_cells[tuple * NTUPLE_MAX_TUPLE_SIZE];
+        for (size_t lane = 0; lane < NTUPLE_BATCH_SIZE; ++lane) {
+            int32_t index = _tuple_offsets[tuple];
+            for (int32_t cell = 0; cell < _tuple_sizes[tuple]; ++cell) {
+                index += states[cells[cell]][lane] * _POWERS_OF_THREE[cell];
+            }
+            sums[lane] += _weights[index];
+        }
+    }
+}
+
+void NTupleNetwork::_evaluate_batch(const Grid * grids, const Move * players, float * values, size_t num_grids, bool use_simd) const {
+    int32_t states[MAX_RANK][NTUPLE_BATCH_SIZE];
+    float sums[NTUPLE_BATCH_SIZE];
+    for (size_t first = 0; first < num_grids; first += NTUPLE_BATCH_SIZE) {
+        size_t num_lanes = std::min<size_t>(NTUPLE_BATCH_SIZE, num_grids - first);
+        _encode(grids + first, players + first, num_lanes, states);
+        _evaluate_lanes(states, sums, use_simd);
+        for (size_t lane = 0; lane < num_lanes; ++lane) {
+            values[first + lane] = std::max(-1.0f, std::min(1.0f, sums[lane]));
+        }
+    }
+}
+
+void NTupleNetwork::_update(const Grid & grid, Move player, float delta) {
+    int32_t states[MAX_RANK][NTUPLE_BATCH_SIZE];
+    _encode(&grid, &player, 1, states);
+    for (size_t tuple = 0; tuple < num_tuples(); ++tuple) {
+        const int32_t * cells = &_tuple_cells[tuple * NTUPLE_MAX_TUPLE_SIZE];
+        int32_t index = _tuple_offsets[tuple];
+        for (int32_t cell = 0; cell < _tuple_sizes[tuple]; ++cell) {
+            index += states[cells[cell]][0] * _POWERS_OF_THREE[cell];
+        }
+        _weights[index] += delta;
+    }
+}
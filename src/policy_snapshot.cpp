@@ -0,0 +1,149 @@
+#include "policy_snapshot.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "match_box.h"
+#include "trace.h"
+
+// Epoch announced by a reader slot that is not in use.
+#define POLICY_STORE_IDLE_EPOCH (UINT64_MAX)
+
+PolicySnapshot::PolicySnapshot(uint64_t version, std::vector<MatchBoxSeeds> seeds) :
+    _version(version),
+    _seeds(std::move(seeds))
+{
+
+}
+
+uint64_t PolicySnapshot::version() const {
+    return _version;
+}
+
+size_t PolicySnapshot::size() const {
+    return _seeds.size();
+}
+
+const MatchBoxSeeds & PolicySnapshot::seeds(size_t index) const {
+    assert(index < _seeds.size());
+    return _seeds[index];
+}
+
+MovePosition PolicySnapshot::sample_move(size_t index, uint32_t random_number) const {
+    return MatchBox::sample_seeds(seeds(index), random_number);
+}
+
+PolicyStore::PolicyStore(PolicySnapshot * snapshot) :
+    _current(snapshot),
+    _epoch(1)
+{
+    assert(snapshot != nullptr);
+    for (ReaderSlot & reader_slot : _reader_slots) {
+        reader_slot.epoch.store(POLICY_STORE_IDLE_EPOCH, std::memory_order_relaxed);
+    }
+}
+
+PolicyStore::~PolicyStore() {
+    for (ReaderSlot & reader_slot : _reader_slots) {
+        assert(reader_slot.epoch.load(std::memory_order_relaxed) == POLICY_STORE_IDLE_EPOCH);
+        (void) reader_slot;
+    }
+    for (RetiredSnapshot & retired : _retired) {
+        delete retired.snapshot;
+    }
+    delete _current.load(std::memory_order_relaxed);
+}
+
+void PolicyStore::publish(PolicySnapshot * snapshot) {
+    TRACE_SCOPE("PolicyStore::publish");
+    assert(snapshot != nullptr);
+    std::lock_guard<std::mutex> lock(_writer_mutex);
+
+    PolicySnapshot * previous = _current.exchange(snapshot, std::memory_order_seq_cst);
+    // Readers that announced this epoch or an older one may still hold the
+    // previous snapshot; readers announcing a later epoch cannot.
+    uint64_t retire_epoch = _epoch.fetch_add(1, std::memory_order_seq_cst);
+    _retired.push_back(RetiredSnapshot{previous, retire_epoch});
+
+    _reclaim_retired();
+}
+
+size_t PolicyStore::reclaim() {
+    std::lock_guard<std::mutex> lock(_writer_mutex);
+    return _reclaim_retired();
+}
+
+size_t PolicyStore::_reclaim_retired() {
+    size_t num_reclaimed = 0;
+    uint64_t min_active_epoch = _min_active_epoch();
+    for (size_t retired_index = 0; retired_index < _retired.size();) {
+        if (_retired[retired_index].retire_epoch < min_active_epoch) {
+            delete _retired[retired_index].snapshot;
+            _retired[retired_index] = _retired.back();
+            _retired.pop_back();
+            ++num_reclaimed;
+        } else {
+            ++retired_index;
+        }
+    }
+    return num_reclaimed;
+}
+
+uint64_t PolicyStore::version() const {
+    return _current.load(std::memory_order_acquire)->version();
+}
+
+size_t PolicyStore::_pin(const PolicySnapshot * & snapshot) {
+    // Every reader claims its own slot; the scan starts at a per-thread
+    // offset so that readers rarely compete for the same one.
+    size_t first_slot = std::hash<std::thread::id>()(std::this_thread::get_id()) % POLICY_STORE_NUM_READER_SLOTS;
+    while (true) {
+        for (size_t offset = 0; offset < POLICY_STORE_NUM_READER_SLOTS; ++offset) {
+            size_t slot_index = (first_slot + offset) % POLICY_STORE_NUM_READER_SLOTS;
+            ReaderSlot & reader_slot = _reader_slots[slot_index];
+            uint64_t idle_epoch = POLICY_STORE_IDLE_EPOCH;
+            uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+            if (!reader_slot.epoch.compare_exchange_strong(idle_epoch, epoch, std::memory_order_seq_cst)) {
+                continue;
+            }
+            snapshot = _current.load(std::memory_order_seq_cst);
+            return slot_index;
+        }
+    }
+}
+
+void PolicyStore::_unpin(size_t slot_index) {
+    _reader_slots[slot_index].epoch.store(POLICY_STORE_IDLE_EPOCH, std::memory_order_release);
+}
+
+uint64_t PolicyStore::_min_active_epoch() const {
+    uint64_t min_active_epoch = POLICY_STORE_IDLE_EPOCH;
+    for (const ReaderSlot & reader_slot : _reader_slots) {
+        uint64_t epoch = reader_slot.epoch.load(std::memory_order_seq_cst);
+        if (epoch < min_active_epoch) {
+            min_active_epoch = epoch;
+        }
+    }
+    return min_active_epoch;
+}
+
+PolicyReadGuard::PolicyReadGuard(PolicyStore & store) :
+    _store(store),
+    _snapshot(nullptr),
+    _slot_index(store._pin(_snapshot))
+{
+
+}
+
+PolicyReadGuard::~PolicyReadGuard() {
+    _store._unpin(_slot_index);
+}
+
+const PolicySnapshot & PolicyReadGuard::snapshot() const {
+    return *_snapshot;
+}
@@ -0,0 +1,138 @@
+#include "ponderer.h"
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+Ponderer::Ponderer(GameBot & game_bot) :
+    _game_bot(game_bot),
+    _generation(0),
+    _has_work(false),
+    _busy(false),
+    _stopping(false),
+    _stop_search(false)
+{
+    _game_bot.set_search_stop_flag(&_stop_search);
+    _thread = std::thread(&Ponderer::_worker_loop, this);
+}
+
+Ponderer::~Ponderer() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_generation;
+        _stopping = true;
+        _stop_search.store(_busy);
+    }
+    _work_condition.notify_one();
+    _thread.join();
+    _game_bot.set_search_stop_flag(nullptr);
+}
+
+void Ponderer::start(const Grid & grid) {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        ++_generation;
+        _stop_and_wait_until_idle(lock);
+        _replies.clear();
+        _grid = grid;
+        _has_work = !grid.has_game_ended();
+    }
+    _work_condition.notify_one();
+}
+
+void Ponderer::cancel() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    ++_generation;
+    _has_work = false;
+    _stop_and_wait_until_idle(lock);
+    _replies.clear();
+}
+
+bool Ponderer::take_reply(const Grid & grid, MovePosition & position, MatchBoxHistory & history) {
+    // Stop first: the caller is about to use the GameBot.
+    std::unique_lock<std::mutex> lock(_mutex);
+    ++_generation;
+    _has_work = false;
+    _stop_and_wait_until_idle(lock);
+
+    bool found = false;
+    auto replies = _replies.find(grid.hash());
+    if (replies != _replies.end()) {
+        for (PonderedReply & reply : replies->second) {
+            if (reply.grid == grid && reply.valid_position) {
+                position = reply.position;
+                history.append(reply.history);
+                found = true;
+                break;
+            }
+        }
+    }
+    _replies.clear();
+    printf("Ponderer::take_reply(): %s\n", found ? "Serving pondered reply" : "No pondered reply");
+    return found;
+}
+
+size_t Ponderer::num_replies() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t num_replies = 0;
+    for (const auto & replies : _replies) {
+        num_replies += replies.second.size();
+    }
+    return num_replies;
+}
+
+void Ponderer::_worker_loop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _work_condition.wait(lock, [this]() { return _stopping || _has_work; });
+        if (_stopping) {
+            return;
+        }
+        _has_work = false;
+        _busy = true;
+        uint64_t generation = _generation;
+        Grid grid = _grid;
+
+        std::vector<MovePosition> human_moves = grid.valid_move_positions();
+        for (MovePosition human_move : human_moves) {
+            if (_generation != generation) {
+                break;
+            }
+            PonderedReply reply;
+            reply.grid = grid;
+            reply.grid.set_value(human_move.first, human_move.second);
+            reply.position = std::make_pair(NUM_ROWS, NUM_COLS);
+            reply.valid_position = false;
+            if (reply.grid.has_game_ended()) {
+                continue;
+            }
+
+            lock.unlock();
+            reply.valid_position = _game_bot.get_next_move(reply.grid, reply.position, reply.history);
+            lock.lock();
+
+            if (_generation == generation) {
+                _replies[reply.grid.hash()].push_back(reply);
+            }
+        }
+
+        // Lowered while still holding the lock, before anyone waiting for
+        // idle can search with the GameBot again.
+        _stop_search.store(false);
+        _busy = false;
+        _idle_condition.notify_all();
+    }
+}
+
+void Ponderer::_stop_and_wait_until_idle(std::unique_lock<std::mutex> & lock) {
+    // Only raised while the worker is busy; it lowers the flag again on
+    // going idle.
+    if (_busy) {
+        _stop_search.store(true);
+    }
+    _idle_condition.wait(lock, [this]() { return !_busy; });
+}
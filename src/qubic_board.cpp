@@ -0,0 +1,287 @@
+#include "qubic_board.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+
+#include "constants.h"
+#include "qubic_symmetry.h"
+
+#define QUBIC_ALL_CELLS (UINT64_MAX)
+
+struct QubicLines {
+    uint64_t masks[QUBIC_NUM_LINES];
+    uint8_t cell_lines[QUBIC_NUM_CELLS][QUBIC_MAX_LINES_PER_CELL];
+    uint8_t num_cell_lines[QUBIC_NUM_CELLS];
+};
+
+static constexpr QubicLines _compute_lines() {
+    QubicLines lines = {};
+    size_t num_lines = 0;
+    // The 13 directions whose first non-zero step is positive, from every
+    // cell where four steps stay inside the cube.
+    for (int dz = -1; dz <= 1; ++dz) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int first_step = dz != 0 ? dz : dy != 0 ? dy : dx;
+                if (first_step <= 0) {
+                    continue;
+                }
+                for (int z = 0; z < QUBIC_SIZE; ++z) {
+                    for (int y = 0; y < QUBIC_SIZE; ++y) {
+                        for (int x = 0; x < QUBIC_SIZE; ++x) {
+                            int last_x = x + dx * (QUBIC_SIZE - 1);
+                            int last_y = y + dy * (QUBIC_SIZE - 1);
+                            int last_z = z + dz * (QUBIC_SIZE - 1);
+                            if (last_x < 0 || last_x >= QUBIC_SIZE || last_y < 0 || last_y >= QUBIC_SIZE || last_z < 0 || last_z >= QUBIC_SIZE) {
+                                continue;
+                            }
+                            for (int step = 0; step < QUBIC_SIZE; ++step) {
+                                size_t cell = (x + dx * step) + QUBIC_SIZE * (y + dy * step) + QUBIC_SIZE * QUBIC_SIZE * (z + dz * step);
+                                lines.masks[num_lines] |= uint64_t(1) << cell;
+                                lines.cell_lines[cell][lines.num_cell_lines[cell]++] = static_cast<uint8_t>(num_lines);
+                            }
+                            ++num_lines;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return lines;
+}
+
+static constexpr QubicLines _LINES = _compute_lines();
+
+static_assert(_LINES.masks[QUBIC_NUM_LINES - 1] != 0, "the cube has fewer lines than QUBIC_NUM_LINES");
+
+struct QubicZobristKeys {
+    uint64_t keys[2][QUBIC_NUM_CELLS];
+};
+
+static constexpr QubicZobristKeys _compute_zobrist_keys() {
+    // splitmix64 of the (side, cell) pair, as for Grid.
+    QubicZobristKeys zobrist_keys = {};
+    for (size_t side = 0; side < 2; ++side) {
+        for (size_t cell = 0; cell < QUBIC_NUM_CELLS; ++cell) {
+            uint64_t key = (side * QUBIC_NUM_CELLS + cell) + 0x9E3779B97F4A7C15ULL;
+            key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+            zobrist_keys.keys[side][cell] = key ^ (key >> 31);
+        }
+    }
+    return zobrist_keys;
+}
+
+static constexpr QubicZobristKeys _ZOBRIST_KEYS = _compute_zobrist_keys();
+
+static size_t _side(Move move) {
+    assert(move == Move::CROSS || move == Move::NOUGHT);
+    return move == Move::CROSS ? 0 : 1;
+}
+
+// Contribution of one line to _line_score.
+static int32_t _line_value(int32_t crosses, int32_t noughts) {
+    if (noughts == 0) {
+        return crosses * crosses;
+    } else if (crosses == 0) {
+        return -noughts * noughts;
+    }
+    return 0;
+}
+
+uint64_t QubicBoard::line_mask(size_t line) {
+    assert(line < QUBIC_NUM_LINES);
+    return _LINES.masks[line];
+}
+
+QubicBoard::QubicBoard() :
+    QubicBoard(DEFAULT_FIRST_PLAYER_MOVE)
+{
+
+}
+
+QubicBoard::QubicBoard(Move first_player_move) :
+    _first_player(first_player_move)
+{
+    assert(first_player_move == Move::CROSS || first_player_move == Move::NOUGHT);
+    reset();
+}
+
+void QubicBoard::reset() {
+    for (size_t side = 0; side < 2; ++side) {
+        _cells[side] = 0;
+        _num_threats[side] = 0;
+        for (size_t line = 0; line < QUBIC_NUM_LINES; ++line) {
+            _line_counts[side][line] = 0;
+        }
+    }
+    for (uint64_t & hash : _hashes) {
+        hash = 0;
+    }
+    _line_score = 0;
+    _rank = 0;
+    _game_state = GameState::ONGOING;
+}
+
+Move QubicBoard::value(size_t cell) const {
+    assert(cell < QUBIC_NUM_CELLS);
+    if ((_cells[0] >> cell) & 1) {
+        return Move::CROSS;
+    } else if ((_cells[1] >> cell) & 1) {
+        return Move::NOUGHT;
+    }
+    return Move::EMPTY;
+}
+
+uint64_t QubicBoard::cells(Move move) const {
+    return _cells[_side(move)];
+}
+
+uint64_t QubicBoard::empty_cells() const {
+    return ~(_cells[0] | _cells[1]) & QUBIC_ALL_CELLS;
+}
+
+Move QubicBoard::first_player() const {
+    return _first_player;
+}
+
+Move QubicBoard::next_player() const {
+    return _rank % 2 == 0 ? _first_player : OPPONENT_MOVE(_first_player);
+}
+
+GameState QubicBoard::game_state() const {
+    return _game_state;
+}
+
+bool QubicBoard::has_game_ended() const {
+    return _game_state != GameState::ONGOING;
+}
+
+size_t QubicBoard::rank() const {
+    return _rank;
+}
+
+size_t QubicBoard::num_threats(Move move) const {
+    return _num_threats[_side(move)];
+}
+
+uint64_t QubicBoard::threat_cells(Move move) const {
+    // Empty cells that would complete a line of move.
+    size_t side = _side(move);
+    uint64_t cells = 0;
+    if (_num_threats[side] == 0) {
+        return cells;
+    }
+    for (size_t line = 0; line < QUBIC_NUM_LINES; ++line) {
+        if (_line_counts[side][line] == QUBIC_SIZE - 1 && _line_counts[1 - side][line] == 0) {
+            cells |= _LINES.masks[line];
+        }
+    }
+    return cells & empty_cells();
+}
+
+int32_t QubicBoard::line_score(Move move) const {
+    return move == Move::CROSS ? _line_score : -_line_score;
+}
+
+bool QubicBoard::is_legal_move(const QubicMove & move) const {
+    return !has_game_ended() && move.cell < QUBIC_NUM_CELLS && ((empty_cells() >> move.cell) & 1);
+}
+
+void QubicBoard::make_move(const QubicMove & move) {
+    assert(is_legal_move(move));
+    Move player = next_player();
+    size_t side = _side(player);
+    size_t other_side = 1 - side;
+    _cells[side] |= uint64_t(1) << move.cell;
+
+    for (size_t line_index = 0; line_index < _LINES.num_cell_lines[move.cell]; ++line_index) {
+        size_t line = _LINES.cell_lines[move.cell][line_index];
+        uint8_t & own = _line_counts[side][line];
+        uint8_t other = _line_counts[other_side][line];
+        int32_t old_value = _line_value(_line_counts[0][line], _line_counts[1][line]);
+        if (other == QUBIC_SIZE - 1 && own == 0) {
+            --_num_threats[other_side];
+        }
+        ++own;
+        if (other == 0 && own == QUBIC_SIZE - 1) {
+            ++_num_threats[side];
+        } else if (own == QUBIC_SIZE) {
+            --_num_threats[side];
+            _game_state = player == Move::CROSS ? GameState::CROSS_WINS : GameState::NOUGHT_WINS;
+        }
+        _line_score += _line_value(_line_counts[0][line], _line_counts[1][line]) - old_value;
+    }
+
+    for (size_t transformation = 0; transformation < NUM_QUBIC_SYMMETRIES; ++transformation) {
+        _hashes[transformation] ^= _ZOBRIST_KEYS.keys[side][QUBIC_SYMMETRY_TABLE.targets[transformation][move.cell]];
+    }
+    ++_rank;
+    if (_game_state == GameState::ONGOING && _rank == QUBIC_NUM_CELLS) {
+        _game_state = GameState::DRAW;
+    }
+}
+
+void QubicBoard::unmake_move(const QubicMove & move) {
+    assert(_rank > 0);
+    assert(move.cell < QUBIC_NUM_CELLS);
+    --_rank;
+    Move player = next_player();
+    size_t side = _side(player);
+    size_t other_side = 1 - side;
+    assert((_cells[side] >> move.cell) & 1);
+    _cells[side] &= ~(uint64_t(1) << move.cell);
+
+    for (size_t line_index = 0; line_index < _LINES.num_cell_lines[move.cell]; ++line_index) {
+        size_t line = _LINES.cell_lines[move.cell][line_index];
+        uint8_t & own = _line_counts[side][line];
+        uint8_t other = _line_counts[other_side][line];
+        int32_t old_value = _line_value(_line_counts[0][line], _line_counts[1][line]);
+        if (other == 0 && own == QUBIC_SIZE - 1) {
+            --_num_threats[side];
+        } else if (own == QUBIC_SIZE) {
+            ++_num_threats[side];
+        }
+        --own;
+        if (other == QUBIC_SIZE - 1 && own == 0) {
+            ++_num_threats[other_side];
+        }
+        _line_score += _line_value(_line_counts[0][line], _line_counts[1][line]) - old_value;
+    }
+
+    for (size_t transformation = 0; transformation < NUM_QUBIC_SYMMETRIES; ++transformation) {
+        _hashes[transformation] ^= _ZOBRIST_KEYS.keys[side][QUBIC_SYMMETRY_TABLE.targets[transformation][move.cell]];
+    }
+    _game_state = GameState::ONGOING;
+}
+
+uint64_t QubicBoard::hash() const {
+    return _hashes[QUBIC_TRANSFORMATION_EQUAL];
+}
+
+uint64_t QubicBoard::canonical_hash(QubicTransformation & qubic_transformation) const {
+    // Symmetric positions share the same 48 hashes, so the smallest one is a
+    // key for the whole class. qubic_transformation maps this position onto
+    // the image that key belongs to.
+    qubic_transformation = QUBIC_TRANSFORMATION_EQUAL;
+    for (QubicTransformation transformation = 1; transformation < NUM_QUBIC_SYMMETRIES; ++transformation) {
+        if (_hashes[transformation] < _hashes[qubic_transformation]) {
+            qubic_transformation = transformation;
+        }
+    }
+    return _hashes[qubic_transformation];
+}
+
+void QubicBoard::print_board() const {
+    for (size_t y = 0; y < QUBIC_SIZE; ++y) {
+        for (size_t z = 0; z < QUBIC_SIZE; ++z) {
+            for (size_t x = 0; x < QUBIC_SIZE; ++x) {
+                Move move = value(x + QUBIC_SIZE * y + QUBIC_SIZE * QUBIC_SIZE * z);
+                printf("%c ", move == Move::CROSS ? 'X' : move == Move::NOUGHT ? 'O' : '.');
+            }
+            printf(z + 1 < QUBIC_SIZE ? "  " : "\n");
+        }
+    }
+    printf("Next: %s, state: %s\n", STR_MOVE(next_player()), STR_GAME_STATE(_game_state));
+}
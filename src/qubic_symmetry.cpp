@@ -0,0 +1,82 @@
+#include "qubic_symmetry.h"
+
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+
+static constexpr uint8_t _AXIS_PERMUTATIONS[6][3] = {
+    {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0},
+};
+
+static constexpr QubicSymmetryTable _compute_symmetry_table() {
+    QubicSymmetryTable table = {};
+    for (size_t transformation = 0; transformation < NUM_QUBIC_SYMMETRIES; ++transformation) {
+        const uint8_t * axes = _AXIS_PERMUTATIONS[transformation / 8];
+        size_t reflections = transformation % 8;
+        for (size_t cell = 0; cell < QUBIC_NUM_CELLS; ++cell) {
+            size_t coordinates[3] = {cell % QUBIC_SIZE, cell / QUBIC_SIZE % QUBIC_SIZE, cell / (QUBIC_SIZE * QUBIC_SIZE)};
+            size_t target = 0;
+            for (size_t axis = 3; axis-- > 0;) {
+                size_t coordinate = coordinates[axes[axis]];
+                if ((reflections >> axis) & 1) {
+                    coordinate = QUBIC_SIZE - coordinate - 1;
+                }
+                target = target * QUBIC_SIZE + coordinate;
+            }
+            table.targets[transformation][cell] = static_cast<uint8_t>(target);
+            table.sources[transformation][target] = static_cast<uint8_t>(cell);
+        }
+    }
+    return table;
+}
+
+const QubicSymmetryTable QUBIC_SYMMETRY_TABLE = _compute_symmetry_table();
+
+uint64_t transform_qubic_cells(uint64_t cells, QubicTransformation qubic_transformation) {
+    assert(qubic_transformation < NUM_QUBIC_SYMMETRIES);
+    const uint8_t * targets = QUBIC_SYMMETRY_TABLE.targets[qubic_transformation];
+    uint64_t transformed_cells = 0;
+    for (; cells != 0; cells &= cells - 1) {
+        size_t cell = 0;
+        while (((cells >> cell) & 1) == 0) {
+            ++cell;
+        }
+        transformed_cells |= uint64_t(1) << targets[cell];
+    }
+    return transformed_cells;
+}
+
+QubicTransformation find_qubic_transformation(uint64_t crosses, uint64_t noughts, uint64_t other_crosses, uint64_t other_noughts) {
+    if (std::bitset<QUBIC_NUM_CELLS>(crosses).count() != std::bitset<QUBIC_NUM_CELLS>(other_crosses).count()
+        || std::bitset<QUBIC_NUM_CELLS>(noughts).count() != std::bitset<QUBIC_NUM_CELLS>(other_noughts).count()) {
+        return QUBIC_TRANSFORMATION_UNEQUAL;
+    }
+    for (QubicTransformation transformation = 0; transformation < NUM_QUBIC_SYMMETRIES; ++transformation) {
+        if (transform_qubic_cells(crosses, transformation) == other_crosses
+            && transform_qubic_cells(noughts, transformation) == other_noughts) {
+            return transformation;
+        }
+    }
+    return QUBIC_TRANSFORMATION_UNEQUAL;
+}
+
+QubicTransformation canonical_qubic_cells(uint64_t & crosses, uint64_t & noughts) {
+    uint64_t canonical_crosses = crosses;
+    uint64_t canonical_noughts = noughts;
+    QubicTransformation canonical_transformation = QUBIC_TRANSFORMATION_EQUAL;
+    for (QubicTransformation transformation = 1; transformation < NUM_QUBIC_SYMMETRIES; ++transformation) {
+        uint64_t transformed_crosses = transform_qubic_cells(crosses, transformation);
+        if (transformed_crosses > canonical_crosses) {
+            continue;
+        }
+        uint64_t transformed_noughts = transform_qubic_cells(noughts, transformation);
+        if (transformed_crosses < canonical_crosses || transformed_noughts < canonical_noughts) {
+            canonical_crosses = transformed_crosses;
+            canonical_noughts = transformed_noughts;
+            canonical_transformation = transformation;
+        }
+    }
+    crosses = canonical_crosses;
+    noughts = canonical_noughts;
+    return canonical_transformation;
+}
@@ -0,0 +1,51 @@
+#include "seed_delta_buffer.h"
+
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+
+SeedDeltaBuffer::SeedDeltaBuffer() {
+    clear();
+}
+
+void SeedDeltaBuffer::clear() {
+    _deltas.clear();
+    _num_games = 0;
+}
+
+void SeedDeltaBuffer::reward(size_t match_box_index, MovePosition move_position, uint16_t seeds) {
+    assert(move_position.first < NUM_ROWS && move_position.second < NUM_COLS);
+    uint16_t & rewards = _delta(match_box_index).rewards[move_position.first][move_position.second];
+    rewards = rewards > UINT16_MAX - seeds ? UINT16_MAX : rewards + seeds;
+}
+
+void SeedDeltaBuffer::punish(size_t match_box_index, MovePosition move_position, uint16_t seeds) {
+    assert(move_position.first < NUM_ROWS && move_position.second < NUM_COLS);
+    uint16_t & punishments = _delta(match_box_index).punishments[move_position.first][move_position.second];
+    punishments = punishments > UINT16_MAX - seeds ? UINT16_MAX : punishments + seeds;
+}
+
+void SeedDeltaBuffer::finish_game() {
+    ++_num_games;
+}
+
+size_t SeedDeltaBuffer::num_games() const {
+    return _num_games;
+}
+
+bool SeedDeltaBuffer::empty() const {
+    return _deltas.empty();
+}
+
+const SeedDelta * SeedDeltaBuffer::find(size_t match_box_index) const {
+    auto delta = _deltas.find(match_box_index);
+    return delta != _deltas.end() ? &delta->second : nullptr;
+}
+
+SeedDelta & SeedDeltaBuffer::_delta(size_t match_box_index) {
+    auto delta = _deltas.find(match_box_index);
+    if (delta == _deltas.end()) {
+        delta = _deltas.emplace(match_box_index, SeedDelta{}).first;
+    }
+    return delta->second;
+}
@@ -0,0 +1,482 @@
+#include "session_runtime.h"
+
+#include <cassert>
+#include <coroutine>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "constants.h"
+
+SessionFramePool & SessionFramePool::instance() {
+    static SessionFramePool frame_pool;
+    return frame_pool;
+}
+
+SessionFramePool::SessionFramePool() :
+    _free_blocks(nullptr),
+    _num_allocated(0),
+    _max_frame_size(0)
+{
+
+}
+
+void * SessionFramePool::allocate(size_t size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_num_allocated;
+    _max_frame_size = std::max(_max_frame_size, size);
+    if (size > SESSION_FRAME_BLOCK_SIZE) {
+        return ::operator new(size);
+    }
+    if (_free_blocks == nullptr) {
+        char * chunk = new char[SESSION_FRAME_BLOCK_SIZE * SESSION_FRAMES_PER_CHUNK];
+        _chunks.emplace_back(chunk);
+        for (size_t block_index = 0; block_index < SESSION_FRAMES_PER_CHUNK; ++block_index) {
+            FreeBlock * block = reinterpret_cast<FreeBlock *>(chunk + block_index * SESSION_FRAME_BLOCK_SIZE);
+            block->next = _free_blocks;
+            _free_blocks = block;
+        }
+    }
+    FreeBlock * block = _free_blocks;
+    _free_blocks = block->next;
+    return block;
+}
+
+void SessionFramePool::deallocate(void * frame, size_t size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    assert(_num_allocated > 0);
+    --_num_allocated;
+    if (size > SESSION_FRAME_BLOCK_SIZE) {
+        ::operator delete(frame);
+        return;
+    }
+    FreeBlock * block = static_cast<FreeBlock *>(frame);
+    block->next = _free_blocks;
+    _free_blocks = block;
+}
+
+size_t SessionFramePool::num_allocated() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _num_allocated;
+}
+
+size_t SessionFramePool::max_frame_size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _max_frame_size;
+}
+
+SessionTask SessionTask::promise_type::get_return_object() noexcept {
+    return SessionTask(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+std::suspend_always SessionTask::promise_type::initial_suspend() noexcept {
+    return {};
+}
+
+std::suspend_always SessionTask::promise_type::final_suspend() noexcept {
+    return {};
+}
+
+void SessionTask::promise_type::return_void() noexcept {
+
+}
+
+void SessionTask::promise_type::unhandled_exception() noexcept {
+    printf("SessionTask: Unhandled exception in a session\n");
+    std::abort();
+}
+
+void * SessionTask::promise_type::operator new(size_t size) {
+    return SessionFramePool::instance().allocate(size);
+}
+
+void SessionTask::promise_type::operator delete(void * frame, size_t size) {
+    SessionFramePool::instance().deallocate(frame, size);
+}
+
+SessionTask::SessionTask(std::coroutine_handle<promise_type> handle) :
+    _handle(handle)
+{
+
+}
+
+std::coroutine_handle<SessionTask::promise_type> SessionTask::handle() const {
+    return _handle;
+}
+
+// Lives in the coroutine frame of its session.
+struct SessionRuntime::Session {
+    uint64_t id;
+    PlayerRoles player_roles;
+    Grid grid;
+    MatchBoxHistory history;
+    // Cells in the order they were played, as row * NUM_COLS + col.
+    uint8_t cells[NUM_ROWS * NUM_COLS];
+    uint8_t num_moves;
+    bool has_client_move;
+    bool awaiting_client_move;
+    MovePosition client_move;
+    MovePosition bot_move;
+    // Where to continue once the client move, bot move or commit is in.
+    std::coroutine_handle<> waiting;
+
+    Session(uint64_t session_id, const PlayerRoles & roles) :
+        id(session_id),
+        player_roles(roles),
+        grid(roles.first_player_move),
+        num_moves(0),
+        has_client_move(false),
+        awaiting_client_move(false),
+        client_move(NUM_ROWS, NUM_COLS),
+        bot_move(NUM_ROWS, NUM_COLS)
+    {
+
+    }
+};
+
+struct SessionRuntime::EventLoop {
+    struct Entry {
+        Session * session;
+        std::coroutine_handle<> handle;
+    };
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<SessionEvent> events;
+    bool stopping = false;
+    // Only touched by the loop thread.
+    std::unordered_map<uint64_t, Entry> sessions;
+    std::thread thread;
+};
+
+struct SessionRuntime::ClientMoveAwaiter {
+    Session & session;
+
+    bool await_ready() const noexcept {
+        return session.has_client_move;
+    }
+    void await_suspend(std::coroutine_handle<> handle) noexcept {
+        session.waiting = handle;
+        session.awaiting_client_move = true;
+    }
+    MovePosition await_resume() noexcept {
+        session.has_client_move = false;
+        session.awaiting_client_move = false;
+        session.waiting = nullptr;
+        return session.client_move;
+    }
+};
+
+struct SessionRuntime::BotMoveAwaiter {
+    SessionRuntime & runtime;
+    Session & session;
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+        session.waiting = handle;
+        runtime._bot_move_tasks.run([runtime = &runtime, session = &session] {
+            const Grid * grid = &session->grid;
+            MatchBoxHistory * history = &session->history;
+            bool valid_position = false;
+            runtime->_game_bot.get_next_moves(grid, &history, &session->bot_move, &valid_position, 1);
+            if (!valid_position) {
+                // Empty match box: play the first free cell, unrecorded.
+                session->bot_move = session->grid.valid_move_positions().front();
+            }
+            runtime->_post(session->id, SessionEvent{SessionEventType::RESUME, session->id, session->player_roles, session->bot_move, session->waiting});
+        });
+    }
+    MovePosition await_resume() noexcept {
+        session.waiting = nullptr;
+        return session.bot_move;
+    }
+};
+
+struct SessionRuntime::LogCommitAwaiter {
+    SessionRuntime & runtime;
+    Session & session;
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+        session.waiting = handle;
+        {
+            std::lock_guard<std::mutex> lock(runtime._commit_mutex);
+            runtime._pending_commits.push_back(&session);
+        }
+        runtime._commit_condition.notify_one();
+    }
+    void await_resume() noexcept {
+        session.waiting = nullptr;
+    }
+};
+
+SessionRuntime::SessionRuntime(GameBot & game_bot, const std::string & log_filename, size_t num_event_loops, TaskScheduler & scheduler) :
+    _game_bot(game_bot),
+    _next_session_id(1),
+    _num_open_sessions(0),
+    _bot_move_tasks(scheduler),
+    _log_file(nullptr),
+    _stopping(false),
+    _num_committed_games(0)
+{
+    // Bot moves are sampled from snapshots while the committer updates the
+    // match boxes.
+    _game_bot.enable_policy_snapshots(SESSION_POLICY_PUBLISH_INTERVAL);
+
+    _log_file = fopen(log_filename.c_str(), "a");
+    if (_log_file == nullptr) {
+        printf("SessionRuntime::SessionRuntime(): Cannot open log file = %s\n", log_filename.c_str());
+    }
+
+    if (num_event_loops == 0) {
+        num_event_loops = 1;
+    }
+    for (size_t loop_index = 0; loop_index < num_event_loops; ++loop_index) {
+        _loops.emplace_back(new EventLoop());
+    }
+    for (std::unique_ptr<EventLoop> & loop : _loops) {
+        loop->thread = std::thread(&SessionRuntime::_event_loop, this, std::ref(*loop));
+    }
+    _committer_thread = std::thread(&SessionRuntime::_committer_loop, this);
+}
+
+SessionRuntime::~SessionRuntime() {
+    // Loops first, so that no session moves on while the bot moves and
+    // commits still in flight drain; what they post is never run.
+    for (std::unique_ptr<EventLoop> & loop : _loops) {
+        {
+            std::lock_guard<std::mutex> lock(loop->mutex);
+            loop->stopping = true;
+        }
+        loop->condition.notify_one();
+        loop->thread.join();
+    }
+    _bot_move_tasks.wait();
+    {
+        std::lock_guard<std::mutex> lock(_commit_mutex);
+        _stopping = true;
+    }
+    _commit_condition.notify_one();
+    _committer_thread.join();
+    if (_log_file != nullptr) {
+        fclose(_log_file);
+    }
+
+    // Every session left is suspended now.
+    for (std::unique_ptr<EventLoop> & loop : _loops) {
+        for (auto & entry : loop->sessions) {
+            entry.second.handle.destroy();
+        }
+        loop->sessions.clear();
+    }
+}
+
+bool SessionRuntime::is_open() const {
+    return _log_file != nullptr;
+}
+
+void SessionRuntime::set_callbacks(const SessionCallbacks & callbacks) {
+    // Before the first session: the loops read the callbacks unlocked.
+    assert(num_open_sessions() == 0);
+    _callbacks = callbacks;
+}
+
+uint64_t SessionRuntime::open_session(const PlayerRoles & player_roles) {
+    uint64_t session_id = _next_session_id.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(_sessions_mutex);
+        ++_num_open_sessions;
+    }
+    _post(session_id, SessionEvent{SessionEventType::OPEN, session_id, player_roles, MovePosition(NUM_ROWS, NUM_COLS), nullptr});
+    return session_id;
+}
+
+void SessionRuntime::submit_move(uint64_t session_id, MovePosition position) {
+    _post(session_id, SessionEvent{SessionEventType::CLIENT_MOVE, session_id, DEFAULT_PLAYER_ROLES, position, nullptr});
+}
+
+void SessionRuntime::wait_for_sessions() {
+    std::unique_lock<std::mutex> lock(_sessions_mutex);
+    _sessions_condition.wait(lock, [this] { return _num_open_sessions == 0; });
+}
+
+size_t SessionRuntime::num_open_sessions() const {
+    std::lock_guard<std::mutex> lock(_sessions_mutex);
+    return _num_open_sessions;
+}
+
+uint64_t SessionRuntime::num_committed_games() const {
+    return _num_committed_games.load(std::memory_order_relaxed);
+}
+
+size_t SessionRuntime::session_size() {
+    // The frame holds the whole Session; the loop adds one table node (next
+    // pointer and entry) and one bucket pointer.
+    return SessionFramePool::instance().max_frame_size() + sizeof(std::pair<const uint64_t, EventLoop::Entry>) + 2 * sizeof(void *);
+}
+
+SessionTask SessionRuntime::_run_session(uint64_t session_id, PlayerRoles player_roles) {
+    Session session(session_id, player_roles);
+    EventLoop & loop = *_loops[session_id % _loops.size()];
+    loop.sessions[session_id].session = &session;
+
+    while (!session.grid.has_game_ended()) {
+        Move player = session.grid.next_player();
+        MovePosition position;
+        if (player_roles.play_bot && player == player_roles.bot_move) {
+            position = co_await BotMoveAwaiter{*this, session};
+            if (_callbacks.bot_moved) {
+                _callbacks.bot_moved(session_id, position);
+            }
+        } else {
+            if (!session.has_client_move && _callbacks.move_requested) {
+                _callbacks.move_requested(session_id, session.grid);
+            }
+            position = co_await ClientMoveAwaiter{session};
+            if (position.first >= NUM_ROWS || position.second >= NUM_COLS || session.grid.value(position.first, position.second) != Move::EMPTY) {
+                printf("SessionRuntime::_run_session(): Session %lu: Illegal move (%lu, %lu)\n", session_id, position.first, position.second);
+                continue;
+            }
+        }
+        session.grid.make_move(position.first, position.second, player);
+        session.cells[session.num_moves++] = static_cast<uint8_t>(position.first * NUM_COLS + position.second);
+    }
+
+    if (player_roles.play_bot) {
+        co_await LogCommitAwaiter{*this, session};
+    }
+    if (_callbacks.game_finished) {
+        _callbacks.game_finished(session_id, session.grid.game_state());
+    }
+    loop.sessions.erase(session_id);
+}
+
+void SessionRuntime::_post(uint64_t session_id, const SessionEvent & event) {
+    EventLoop & loop = *_loops[session_id % _loops.size()];
+    bool was_empty = false;
+    {
+        std::lock_guard<std::mutex> lock(loop.mutex);
+        was_empty = loop.events.empty();
+        loop.events.push_back(event);
+    }
+    if (was_empty) {
+        loop.condition.notify_one();
+    }
+}
+
+void SessionRuntime::_event_loop(EventLoop & loop) {
+    std::vector<SessionEvent> events;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(loop.mutex);
+            loop.condition.wait(lock, [&loop] { return loop.stopping || !loop.events.empty(); });
+            if (loop.stopping) {
+                return;
+            }
+            events.swap(loop.events);
+        }
+        for (const SessionEvent & event : events) {
+            _handle_event(loop, event);
+        }
+        events.clear();
+    }
+}
+
+void SessionRuntime::_handle_event(EventLoop & loop, const SessionEvent & event) {
+    switch (event.type) {
+        case SessionEventType::OPEN: {
+            SessionTask task = _run_session(event.session_id, event.player_roles);
+            loop.sessions[event.session_id] = EventLoop::Entry{nullptr, task.handle()};
+            _resume(task.handle());
+            break;
+        }
+        case SessionEventType::CLIENT_MOVE: {
+            auto entry = loop.sessions.find(event.session_id);
+            if (entry == loop.sessions.end()) {
+                printf("SessionRuntime::_handle_event(): No open session = %lu\n", event.session_id);
+                break;
+            }
+            Session & session = *entry->second.session;
+            if (session.has_client_move) {
+                // Only one move may be queued ahead of its turn.
+                break;
+            }
+            session.client_move = event.position;
+            session.has_client_move = true;
+            if (session.awaiting_client_move) {
+                _resume(session.waiting);
+            }
+            break;
+        }
+        case SessionEventType::RESUME:
+            _resume(event.handle);
+            break;
+    }
+}
+
+void SessionRuntime::_resume(std::coroutine_handle<> handle) {
+    handle.resume();
+    if (handle.done()) {
+        handle.destroy();
+        {
+            std::lock_guard<std::mutex> lock(_sessions_mutex);
+            --_num_open_sessions;
+        }
+        _sessions_condition.notify_all();
+    }
+}
+
+void SessionRuntime::_committer_loop() {
+    std::vector<Session *> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_commit_mutex);
+            _commit_condition.wait(lock, [this] { return _stopping || !_pending_commits.empty(); });
+            if (_pending_commits.empty()) {
+                return;
+            }
+            batch.swap(_pending_commits);
+        }
+
+        // Group commit: every game that finished while the last batch was
+        // written goes out with a single flush.
+        for (Session * session : batch) {
+            _write_game(*session);
+        }
+        if (_log_file != nullptr) {
+            fflush(_log_file);
+        }
+        for (Session * session : batch) {
+            _game_bot.finish_game(session->grid.game_state(), session->history, session->player_roles.bot_move);
+            _num_committed_games.fetch_add(1, std::memory_order_relaxed);
+            _post(session->id, SessionEvent{SessionEventType::RESUME, session->id, session->player_roles, MovePosition(NUM_ROWS, NUM_COLS), session->waiting});
+        }
+        batch.clear();
+    }
+}
+
+void SessionRuntime::_write_game(const Session & session) {
+    if (_log_file == nullptr) {
+        return;
+    }
+    // Same layout as a GameLog_*.log file, one block per game.
+    GameState game_state = session.grid.game_state();
+    GameOutcome game_outcome = game_state == GameState::DRAW ? GameOutcome::DRAW :
+        (game_state == GameState::CROSS_WINS) == (session.player_roles.bot_move == Move::CROSS) ? GameOutcome::BOT_WINS : GameOutcome::PLAYER_WINS;
+    fprintf(_log_file, "FirstPlayer:\t%s\tBot:\t%s\n", STR_MOVE(session.player_roles.first_player_move), STR_MOVE(session.player_roles.bot_move));
+    fprintf(_log_file, "#Moves:\t%u\n", static_cast<unsigned>(session.num_moves));
+    Move player = session.player_roles.first_player_move;
+    for (size_t move_index = 0; move_index < session.num_moves; ++move_index) {
+        fprintf(_log_file, "%s\t%u\t%u\n", STR_MOVE(player), session.cells[move_index] / NUM_COLS, session.cells[move_index] % NUM_COLS);
+        player = OPPONENT_MOVE(player);
+    }
+    fprintf(_log_file, "%s\n", STR_GAME_OUTCOME(game_outcome));
+}
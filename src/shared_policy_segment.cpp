@@ -0,0 +1,223 @@
+#include "shared_policy_segment.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "constants.h"
+#include "match_box.h"
+
+#define SHARED_POLICY_MAGIC "TTTSHPL1"
+// The seeds start on their own cache line after the header.
+#define SHARED_POLICY_SEEDS_OFFSET (64)
+
+static_assert(std::atomic<int8_t>::is_always_lock_free, "shared seeds need lock-free byte atomics");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared counters need lock-free atomics");
+static_assert(sizeof(std::atomic<int8_t>) == 1, "shared seeds are one byte each");
+
+// Start of the segment, followed by the seeds.
+struct SharedPolicySegment::Header {
+    char magic[8];
+    uint32_t num_rows;
+    uint32_t num_cols;
+    uint64_t num_positions;
+    // Set last by the coordinator, once the seeds are filled in.
+    std::atomic<uint32_t> ready;
+    // Bumped by every merge of a trainer.
+    std::atomic<uint64_t> version;
+    std::atomic<uint64_t> num_games;
+    // version when the coordinator last wrote a checkpoint.
+    std::atomic<uint64_t> checkpoint_version;
+};
+
+static uint64_t _count_positions() {
+    uint64_t num_positions = 1;
+    for (size_t cell = 0; cell < MAX_RANK; ++cell) {
+        num_positions *= 3;
+    }
+    return num_positions;
+}
+
+static size_t _segment_size() {
+    return SHARED_POLICY_SEEDS_OFFSET + _count_positions() * MAX_RANK;
+}
+
+SharedPolicySegment::SharedPolicySegment() :
+    _mapping(nullptr),
+    _mapping_size(0),
+    _header(nullptr),
+    _seed_array(nullptr)
+{
+
+}
+
+SharedPolicySegment::~SharedPolicySegment() {
+    close();
+}
+
+bool SharedPolicySegment::remove(const std::string & name) {
+    if (shm_unlink(name.c_str()) != 0) {
+        printf("SharedPolicySegment::remove(): Cannot remove segment = %s\n", name.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SharedPolicySegment::create(const std::string & name) {
+    close();
+    int file_descriptor = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (file_descriptor < 0) {
+        printf("SharedPolicySegment::create(): Cannot create segment = %s\n", name.c_str());
+        return false;
+    }
+    if (ftruncate(file_descriptor, static_cast<off_t>(_segment_size())) != 0) {
+        printf("SharedPolicySegment::create(): Cannot size segment = %s\n", name.c_str());
+        ::close(file_descriptor);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    if (!_map(file_descriptor, true)) {
+        shm_unlink(name.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SharedPolicySegment::open(const std::string & name) {
+    close();
+    int file_descriptor = shm_open(name.c_str(), O_RDWR, 0600);
+    if (file_descriptor < 0) {
+        printf("SharedPolicySegment::open(): Cannot open segment = %s\n", name.c_str());
+        return false;
+    }
+    struct stat file_status;
+    if (fstat(file_descriptor, &file_status) != 0 || static_cast<size_t>(file_status.st_size) != _segment_size()) {
+        printf("SharedPolicySegment::open(): Segment %s does not hold a %dx%d policy.\n", name.c_str(), NUM_ROWS, NUM_COLS);
+        ::close(file_descriptor);
+        return false;
+    }
+    if (!_map(file_descriptor, false)) {
+        return false;
+    }
+    bool valid = _header->ready.load(std::memory_order_acquire) != 0
+        && memcmp(_header->magic, SHARED_POLICY_MAGIC, sizeof(_header->magic)) == 0
+        && _header->num_rows == NUM_ROWS
+        && _header->num_cols == NUM_COLS
+        && _header->num_positions == _count_positions();
+    if (!valid) {
+        printf("SharedPolicySegment::open(): Segment %s is not ready or not a %dx%d policy.\n", name.c_str(), NUM_ROWS, NUM_COLS);
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SharedPolicySegment::close() {
+    if (_mapping != nullptr) {
+        munmap(_mapping, _mapping_size);
+    }
+    _mapping = nullptr;
+    _mapping_size = 0;
+    _header = nullptr;
+    _seed_array = nullptr;
+}
+
+bool SharedPolicySegment::is_open() const {
+    return _mapping != nullptr;
+}
+
+void SharedPolicySegment::mark_ready() {
+    assert(is_open());
+    _header->ready.store(1, std::memory_order_release);
+}
+
+uint64_t SharedPolicySegment::num_positions() const {
+    return is_open() ? _header->num_positions : 0;
+}
+
+int8_t SharedPolicySegment::seeds(uint64_t position_index, size_t cell) const {
+    return _seeds(position_index, cell).load(std::memory_order_relaxed);
+}
+
+void SharedPolicySegment::set_seeds(uint64_t position_index, size_t cell, int8_t seeds) {
+    _seeds(position_index, cell).store(seeds, std::memory_order_relaxed);
+}
+
+void SharedPolicySegment::apply_seed_delta(uint64_t position_index, size_t cell, int32_t rewards, int32_t punishments) {
+    assert(rewards >= 0 && punishments >= 0);
+    // apply_seed_delta_rule() as one compare-and-swap so that concurrent
+    // trainers never lose each other's updates.
+    std::atomic<int8_t> & seeds = _seeds(position_index, cell);
+    int8_t old_seeds = seeds.load(std::memory_order_relaxed);
+    int8_t new_seeds;
+    do {
+        new_seeds = apply_seed_delta_rule(old_seeds, rewards, punishments);
+    } while (new_seeds != old_seeds && !seeds.compare_exchange_weak(old_seeds, new_seeds, std::memory_order_relaxed));
+}
+
+uint64_t SharedPolicySegment::version() const {
+    return _header->version.load(std::memory_order_acquire);
+}
+
+uint64_t SharedPolicySegment::num_games() const {
+    return _header->num_games.load(std::memory_order_relaxed);
+}
+
+uint64_t SharedPolicySegment::checkpoint_version() const {
+    return _header->checkpoint_version.load(std::memory_order_relaxed);
+}
+
+void SharedPolicySegment::finish_merge(uint64_t num_games) {
+    // Release: whoever sees the new version also sees the seeds before it.
+    _header->num_games.fetch_add(num_games, std::memory_order_relaxed);
+    _header->version.fetch_add(1, std::memory_order_release);
+}
+
+void SharedPolicySegment::set_checkpoint_version(uint64_t version) {
+    _header->checkpoint_version.store(version, std::memory_order_relaxed);
+}
+
+std::atomic<int8_t> & SharedPolicySegment::_seeds(uint64_t position_index, size_t cell) const {
+    assert(is_open());
+    assert(position_index < _header->num_positions && cell < MAX_RANK);
+    return _seed_array[position_index * MAX_RANK + cell];
+}
+
+bool SharedPolicySegment::_map(int file_descriptor, bool initialize) {
+    size_t mapping_size = _segment_size();
+    void * mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+    ::close(file_descriptor);
+    if (mapping == MAP_FAILED) {
+        printf("SharedPolicySegment::_map(): Cannot map segment\n");
+        return false;
+    }
+    _mapping = mapping;
+    _mapping_size = mapping_size;
+    _header = static_cast<Header *>(mapping);
+    static_assert(sizeof(Header) <= SHARED_POLICY_SEEDS_OFFSET, "the header runs into the seeds");
+    _seed_array = reinterpret_cast<std::atomic<int8_t> *>(static_cast<char *>(mapping) + SHARED_POLICY_SEEDS_OFFSET);
+
+    if (initialize) {
+        // A new segment is all zeros; construct the atomics in place and
+        // leave ready at zero until mark_ready().
+        new (_header) Header();
+        memcpy(_header->magic, SHARED_POLICY_MAGIC, sizeof(_header->magic));
+        _header->num_rows = NUM_ROWS;
+        _header->num_cols = NUM_COLS;
+        _header->num_positions = _count_positions();
+        for (uint64_t seed_index = 0; seed_index < _count_positions() * MAX_RANK; ++seed_index) {
+            new (&_seed_array[seed_index]) std::atomic<int8_t>(0);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,228 @@
+#include "sparse_board.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "constants.h"
+#include "sparse_cell_table.h"
+
+// Coordinates stay well inside int32_t so that the line scans cannot overflow.
+#define SPARSE_MAX_COORDINATE (INT32_MAX / 2)
+
+static const int32_t _DIRECTIONS[4][2] = {
+    {1, 0}, {0, 1}, {1, 1}, {1, -1},
+};
+
+static size_t _side(Move move) {
+    assert(move == Move::CROSS || move == Move::NOUGHT);
+    return move == Move::CROSS ? 0 : 1;
+}
+
+static uint64_t _zobrist_key(int32_t x, int32_t y, Move move) {
+    // splitmix64 of the (cell, move) pair, as for Grid.
+    uint64_t key = ((static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y)) * 3
+        + static_cast<uint64_t>(move) + 0x9E3779B97F4A7C15ULL;
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+    return key ^ (key >> 31);
+}
+
+// Contribution of one window to _line_score.
+static int32_t _window_value(int32_t crosses, int32_t noughts) {
+    if (noughts == 0) {
+        return crosses * crosses;
+    } else if (crosses == 0) {
+        return -noughts * noughts;
+    }
+    return 0;
+}
+
+SparseBoard::SparseBoard(size_t win_length, Move first_player_move) :
+    _win_length(win_length),
+    _first_player(first_player_move)
+{
+    assert(win_length >= 2 && win_length <= SPARSE_MAX_WIN_LENGTH);
+    assert(first_player_move == Move::CROSS || first_player_move == Move::NOUGHT);
+    reset();
+}
+
+void SparseBoard::reset() {
+    _stones.clear();
+    _neighbour_counts.clear();
+    _num_threats[0] = 0;
+    _num_threats[1] = 0;
+    _line_score = 0;
+    _hash = 0;
+    _rank = 0;
+    _game_state = GameState::ONGOING;
+}
+
+Move SparseBoard::value(int32_t x, int32_t y) const {
+    const Move * stone = _stones.find(x, y);
+    return stone != nullptr ? *stone : Move::EMPTY;
+}
+
+size_t SparseBoard::win_length() const {
+    return _win_length;
+}
+
+Move SparseBoard::first_player() const {
+    return _first_player;
+}
+
+Move SparseBoard::next_player() const {
+    return _rank % 2 == 0 ? _first_player : OPPONENT_MOVE(_first_player);
+}
+
+GameState SparseBoard::game_state() const {
+    return _game_state;
+}
+
+bool SparseBoard::has_game_ended() const {
+    return _game_state != GameState::ONGOING;
+}
+
+size_t SparseBoard::rank() const {
+    return _rank;
+}
+
+size_t SparseBoard::num_threats(Move move) const {
+    return _num_threats[_side(move)];
+}
+
+int32_t SparseBoard::line_score(Move move) const {
+    return move == Move::CROSS ? _line_score : -_line_score;
+}
+
+bool SparseBoard::is_legal_move(const SparseMove & move) const {
+    return !has_game_ended()
+        && std::abs(move.x) <= SPARSE_MAX_COORDINATE && std::abs(move.y) <= SPARSE_MAX_COORDINATE
+        && _stones.find(move.x, move.y) == nullptr;
+}
+
+void SparseBoard::generate_moves(std::vector<SparseMove> & moves) const {
+    moves.clear();
+    if (has_game_ended()) {
+        return;
+    }
+    if (_rank == 0) {
+        moves.push_back(SparseMove{0, 0});
+        return;
+    }
+    const SparseCellTable<Move> & stones = _stones;
+    _neighbour_counts.for_each([&moves, &stones](int32_t x, int32_t y, uint16_t) {
+        if (stones.find(x, y) == nullptr) {
+            moves.push_back(SparseMove{x, y});
+        }
+    });
+}
+
+void SparseBoard::make_move(const SparseMove & move) {
+    assert(is_legal_move(move));
+    Move player = next_player();
+    _update_lines(move, player, 1);
+    _stones.find_or_insert(move.x, move.y, player);
+    _update_candidates(move, 1);
+    _hash ^= _zobrist_key(move.x, move.y, player);
+    ++_rank;
+}
+
+void SparseBoard::unmake_move(const SparseMove & move) {
+    assert(_rank > 0);
+    --_rank;
+    Move player = next_player();
+    assert(value(move.x, move.y) == player);
+    _stones.erase(move.x, move.y);
+    _update_lines(move, player, -1);
+    _update_candidates(move, -1);
+    _hash ^= _zobrist_key(move.x, move.y, player);
+    _game_state = GameState::ONGOING;
+}
+
+uint64_t SparseBoard::hash() const {
+    return _hash;
+}
+
+void SparseBoard::print_board() const {
+    if (_rank == 0) {
+        printf("(empty)\n");
+        return;
+    }
+    int32_t min_x = INT32_MAX, max_x = INT32_MIN, min_y = INT32_MAX, max_y = INT32_MIN;
+    _stones.for_each([&](int32_t x, int32_t y, Move) {
+        min_x = std::min(min_x, x);
+        max_x = std::max(max_x, x);
+        min_y = std::min(min_y, y);
+        max_y = std::max(max_y, y);
+    });
+    printf("x %d..%d, y %d..%d\n", min_x, max_x, min_y, max_y);
+    for (int32_t y = max_y; y >= min_y; --y) {
+        for (int32_t x = min_x; x <= max_x; ++x) {
+            Move move = value(x, y);
+            printf("%c ", move == Move::CROSS ? 'X' : move == Move::NOUGHT ? 'O' : '.');
+        }
+        printf("\n");
+    }
+    printf("Next: %s, state: %s\n", STR_MOVE(next_player()), STR_GAME_STATE(_game_state));
+}
+
+void SparseBoard::_update_lines(const SparseMove & move, Move player, int32_t sign) {
+    // Called while the cell of move is empty. Every window of win_length
+    // cells through it is compared without and with the stone of player,
+    // and the difference is added (placing) or taken away (removing).
+    assert(value(move.x, move.y) == Move::EMPTY);
+    int32_t win_length = static_cast<int32_t>(_win_length);
+    size_t side = _side(player);
+    for (const auto & direction : _DIRECTIONS) {
+        // Stones on the 2 * win_length - 1 cells centred on move.
+        int32_t counts[2][2 * SPARSE_MAX_WIN_LENGTH] = {};
+        for (int32_t offset = -(win_length - 1); offset <= win_length - 1; ++offset) {
+            size_t index = static_cast<size_t>(offset + win_length - 1);
+            Move stone = offset == 0 ? Move::EMPTY : value(move.x + offset * direction[0], move.y + offset * direction[1]);
+            // Running totals: counts[side][index + 1] covers cells 0 .. index.
+            counts[0][index + 1] = counts[0][index] + (stone == Move::CROSS ? 1 : 0);
+            counts[1][index + 1] = counts[1][index] + (stone == Move::NOUGHT ? 1 : 0);
+        }
+        for (int32_t start = 0; start < win_length; ++start) {
+            int32_t without[2] = {
+                counts[0][start + win_length] - counts[0][start],
+                counts[1][start + win_length] - counts[1][start],
+            };
+            int32_t with[2] = {without[0], without[1]};
+            ++with[side];
+
+            _line_score += sign * (_window_value(with[0], with[1]) - _window_value(without[0], without[1]));
+            for (size_t threat_side = 0; threat_side < 2; ++threat_side) {
+                bool threat_without = without[threat_side] == win_length - 1 && without[1 - threat_side] == 0;
+                bool threat_with = with[threat_side] == win_length - 1 && with[1 - threat_side] == 0;
+                if (threat_with != threat_without) {
+                    bool added = threat_with == (sign > 0);
+                    _num_threats[threat_side] = added ? _num_threats[threat_side] + 1 : _num_threats[threat_side] - 1;
+                }
+            }
+            if (sign > 0 && with[side] == win_length) {
+                _game_state = player == Move::CROSS ? GameState::CROSS_WINS : GameState::NOUGHT_WINS;
+            }
+        }
+    }
+}
+
+void SparseBoard::_update_candidates(const SparseMove & move, int32_t sign) {
+    for (int32_t dy = -SPARSE_CANDIDATE_RADIUS; dy <= SPARSE_CANDIDATE_RADIUS; ++dy) {
+        for (int32_t dx = -SPARSE_CANDIDATE_RADIUS; dx <= SPARSE_CANDIDATE_RADIUS; ++dx) {
+            int32_t x = move.x + dx, y = move.y + dy;
+            if (sign > 0) {
+                ++_neighbour_counts.find_or_insert(x, y, 0);
+            } else {
+                uint16_t * count = _neighbour_counts.find(x, y);
+                assert(count != nullptr && *count > 0);
+                if (--*count == 0) {
+                    _neighbour_counts.erase(x, y);
+                }
+            }
+        }
+    }
+}
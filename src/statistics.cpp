@@ -1,6 +1,8 @@
 #include "statistics.h"
 
 #include <cassert>
+#include <cerrno>
+#include <cstdio>
 #include <ctime>
 #include <fstream>
 #include <sstream>
@@ -13,14 +15,33 @@
 #include <QStringList>
 
 #include "constants.h"
+#include "metrics.h"
+#include "trace.h"
+
+#define GAME_LOG_DIRECTORY_NAME "GameLog"
+// Columnar copy of the game logs, in the same directory.
+#define GAME_ARCHIVE_FILENAME "games.archive"
+// Finished games kept only in memory before the archive is written out
+// again. Saving rewrites the whole file, so it is batched; games lost to a
+// crash are still in their logs and make the next start rebuild.
+#define GAME_ARCHIVE_SAVE_INTERVAL (16)
+
+Statistics::Statistics() :
+	_num_unsaved_games(0)
+{
+	start_new_game(DEFAULT_PLAYER_ROLES);
+}
 
-Statistics::Statistics() {
-	start_new_game();
+Statistics::~Statistics() {
+	if (_num_unsaved_games > 0) {
+		_save_game_archive();
+	}
 }
 
-void Statistics::start_new_game() {
+void Statistics::start_new_game(const PlayerRoles & player_roles) {
 	moves.clear();
 	move_positions.clear();
+	_player_roles = player_roles;
 }
 
 void Statistics::log_move(Move move, MovePosition move_position) {
@@ -29,16 +50,18 @@ void Statistics::log_move(Move move, MovePosition move_position) {
 }
 
 void Statistics::game_finished(GameState game_state) {
-	GameOutcome game_outcome = _get_game_outcome_from_game_state(game_state);
+	GameOutcome game_outcome = _get_game_outcome_from_game_state(game_state, _player_roles.player_move);
 	_save_game_moves(game_outcome);
 }
 
-void Statistics::read_move_history(std::vector<std::vector<Move>> & move_history, std::vector<std::vector<MovePosition>> & move_position_history, std::vector<GameState> & game_state_history) {
+void Statistics::read_move_history(std::vector<std::vector<Move>> & move_history, std::vector<std::vector<MovePosition>> & move_position_history, std::vector<GameState> & game_state_history, std::vector<PlayerRoles> & player_roles_history) {
+	TRACE_SCOPE("Statistics::read_move_history");
 	move_history.clear();
 	move_position_history.clear();
 	game_state_history.clear();
+	player_roles_history.clear();
 
-	std::string game_log_directory_name = "GameLog";
+	std::string game_log_directory_name = GAME_LOG_DIRECTORY_NAME;
 
 	if (!QDir(game_log_directory_name.c_str()).exists()) {
 		printf("Statistics::read_move_history(): Cannot access directory = %s\n", game_log_directory_name.c_str());
@@ -49,35 +72,64 @@ void Statistics::read_move_history(std::vector<std::vector<Move>> & move_history
 	QStringList filter;
 	filter << "GameLog_*.log";
 
-	const QFileInfoList file_info_list = QDir(game_log_directory_name.c_str()).entryInfoList(filter);
-
-	foreach (const QFileInfo file_info, file_info_list) {
-		QString game_log_filename = file_info.absoluteFilePath();
-
-		std::vector<Move> moves;
-		std::vector<MovePosition> move_positions;
-		GameState game_state;
+	QFileInfoList file_info_list;
+	{
+		TRACE_SCOPE("Statistics::list_game_logs");
+		file_info_list = QDir(game_log_directory_name.c_str()).entryInfoList(filter);
+	}
 
-		_read_game_moves( game_log_filename.toStdString(), moves, move_positions, game_state);
+	// The archive is the replay source; the logs are only parsed again when
+	// it is missing or was built from a different set of them.
+	std::string game_archive_filename = game_log_directory_name + "/" + GAME_ARCHIVE_FILENAME;
+	if (!_game_archive.load(game_archive_filename) || _game_archive.num_source_files() != static_cast<size_t>(file_info_list.size())) {
+		TRACE_SCOPE("Statistics::rebuild_game_archive");
+		_game_archive.clear();
+		// Logs without moves are skipped below but still counted, so they
+		// do not trigger a rebuild on every start.
+		_game_archive.set_num_source_files(static_cast<size_t>(file_info_list.size()));
+		foreach (const QFileInfo file_info, file_info_list) {
+			QString game_log_filename = file_info.absoluteFilePath();
+
+			std::vector<Move> moves;
+			std::vector<MovePosition> move_positions;
+			GameState game_state;
+			PlayerRoles player_roles = DEFAULT_PLAYER_ROLES;
+
+			_read_game_moves( game_log_filename.toStdString(), moves, move_positions, game_state, player_roles);
+
+			assert(moves.size() == move_positions.size());
+			if (moves.size() == 0) {
+				printf("Warning, no moves reading from file '%s'\n", game_log_filename.toStdString().c_str());
+				fflush(stdout);
+				continue;
+			}
 
-		assert(moves.size() == move_positions.size());
-		if (moves.size() == 0) {
-			printf("Warning, no moves reading from file '%s'\n", game_log_filename.toStdString().c_str());
-			fflush(stdout);
-			continue;
+			GameOutcome game_outcome = _get_game_outcome_from_game_state(game_state, player_roles.player_move);
+			uint32_t timestamp = file_info.baseName().section('_', 1).toUInt();
+			_game_archive.append(move_positions, game_outcome, player_roles, timestamp);
 		}
+		_game_archive.save(game_archive_filename);
+		_num_unsaved_games = 0;
+	}
 
-		move_history.push_back(moves);
-		move_position_history.push_back(move_positions);
-		game_state_history.push_back(game_state);
+	for (size_t game_index = 0; game_index < _game_archive.num_games(); ++game_index) {
+		ArchivedGame game = _game_archive.get_game(game_index);
+		move_history.push_back(game.moves);
+		move_position_history.push_back(game.move_positions);
+		game_state_history.push_back(_get_game_state_from_game_outcome(game.game_outcome, game.player_roles.player_move));
+		player_roles_history.push_back(game.player_roles);
 	}
 }
 
-GameOutcome Statistics::_get_game_outcome_from_game_state(GameState game_state) {
+const GameArchive & Statistics::get_game_archive() const {
+	return _game_archive;
+}
+
+GameOutcome Statistics::_get_game_outcome_from_game_state(GameState game_state, Move player_move) {
 	GameOutcome game_outcome = GameOutcome::DRAW;
 	switch (game_state) {
 		case GameState::NOUGHT_WINS:
-			switch (PLAYER_MOVE) {
+			switch (player_move) {
 				case Move::CROSS:
 					game_outcome = GameOutcome::BOT_WINS;
 					break;
@@ -85,12 +137,12 @@ GameOutcome Statistics::_get_game_outcome_from_game_state(GameState game_state)
 					game_outcome = GameOutcome::PLAYER_WINS;
 					break;
 				default:
-					printf("Statistics::_get_game_outcome_from_game_state(): Invalid Player Move = %s\n", STR_MOVE(PLAYER_MOVE));
+					printf("Statistics::_get_game_outcome_from_game_state(): Invalid Player Move = %s\n", STR_MOVE(player_move));
 					assert(false);
 			}
 			break;
 		case GameState::CROSS_WINS:
-			switch (PLAYER_MOVE) {
+			switch (player_move) {
 				case Move::CROSS:
 					game_outcome = GameOutcome::PLAYER_WINS;
 					break;
@@ -98,7 +150,7 @@ GameOutcome Statistics::_get_game_outcome_from_game_state(GameState game_state)
 					game_outcome = GameOutcome::BOT_WINS;
 					break;
 				default:
-					printf("Statistics::_get_game_outcome_from_game_state(): Invalid Player Move = %s\n", STR_MOVE(PLAYER_MOVE));
+					printf("Statistics::_get_game_outcome_from_game_state(): Invalid Player Move = %s\n", STR_MOVE(player_move));
 					assert(false);
 			}
 			break;
@@ -114,11 +166,11 @@ GameOutcome Statistics::_get_game_outcome_from_game_state(GameState game_state)
 	return game_outcome;
 }
 
-GameState Statistics::_get_game_state_from_game_outcome(GameOutcome game_outcome) {
+GameState Statistics::_get_game_state_from_game_outcome(GameOutcome game_outcome, Move player_move) {
 	GameState game_state = GameState::INVALID;
 	switch (game_outcome) {
 		case GameOutcome::PLAYER_WINS:
-			switch (PLAYER_MOVE) {
+			switch (player_move) {
 				case Move::CROSS:
 					game_state = GameState::CROSS_WINS;
 					break;
@@ -126,12 +178,12 @@ GameState Statistics::_get_game_state_from_game_outcome(GameOutcome game_outcome
 					game_state = GameState::NOUGHT_WINS;
 					break;
 				default:
-					printf("Statistics::_get_game_state_from_game_outcome(): Invalid Player Move = %s\n", STR_MOVE(PLAYER_MOVE));
+					printf("Statistics::_get_game_state_from_game_outcome(): Invalid Player Move = %s\n", STR_MOVE(player_move));
 					assert(false);
 			}
 			break;
 		case GameOutcome::BOT_WINS:
-			switch (PLAYER_MOVE) {
+			switch (player_move) {
 				case Move::CROSS:
 					game_state = GameState::NOUGHT_WINS;
 					break;
@@ -139,7 +191,7 @@ GameState Statistics::_get_game_state_from_game_outcome(GameOutcome game_outcome
 					game_state = GameState::CROSS_WINS;
 					break;
 				default:
-					printf("Statistics::_get_game_state_from_game_outcome(): Invalid Player Move = %s\n", STR_MOVE(PLAYER_MOVE));
+					printf("Statistics::_get_game_state_from_game_outcome(): Invalid Player Move = %s\n", STR_MOVE(player_move));
 					assert(false);
 			}
 			break;
@@ -155,11 +207,12 @@ GameState Statistics::_get_game_state_from_game_outcome(GameOutcome game_outcome
 }
 
 void Statistics::_save_game_moves(GameOutcome game_outcome) {
-	if (PLAY_BOT == false) {
-		printf("Statistics::_save_game_moves(): PLAY_BOT = false. Not saving game log");
+	METRICS_SCOPED_TIMER(MetricTimer::STATISTICS_SAVE_GAME_MOVES);
+	if (_player_roles.play_bot == false) {
+		printf("Statistics::_save_game_moves(): play_bot = false. Not saving game log");
 		return;
 	}
-	std::string game_log_directory_name = "GameLog";
+	std::string game_log_directory_name = GAME_LOG_DIRECTORY_NAME;
 
 	if (!QDir(game_log_directory_name.c_str()).exists()) {
 		bool success = QDir().mkdir(game_log_directory_name.c_str());
@@ -169,29 +222,64 @@ void Statistics::_save_game_moves(GameOutcome game_outcome) {
 		}
 	}
 
-	std::time_t time = std::time(nullptr);
-	std::ostringstream oss_filename;
-	oss_filename << game_log_directory_name << "/GameLog_" << static_cast<uint32_t>(time) << ".log";
+	assert(moves.size() == move_positions.size());
 
-	std::string game_log_filename = oss_filename.str();
+	// Created exclusively, so that two games finished within the same second
+	// get GameLog_<time>.log and GameLog_<time>_1.log instead of sharing one.
+	std::time_t time = std::time(nullptr);
+	std::string game_log_filename;
+	FILE * game_log_file = nullptr;
+	for (size_t suffix = 0; game_log_file == nullptr; ++suffix) {
+		std::ostringstream oss_filename;
+		oss_filename << game_log_directory_name << "/GameLog_" << static_cast<uint32_t>(time);
+		if (suffix > 0) {
+			oss_filename << "_" << suffix;
+		}
+		oss_filename << ".log";
+		game_log_filename = oss_filename.str();
+		game_log_file = fopen(game_log_filename.c_str(), "wx");
+		if (game_log_file == nullptr && errno != EEXIST) {
+			printf("Statistics::_save_game_moves(): Cannot create game log file = %s\n", game_log_filename.c_str());
+			fflush(stdout);
+			return;
+		}
+	}
 	printf("Statistics::_save_game_moves(): Saving game log file : %s\n", game_log_filename.c_str());
 	fflush(stdout);
 
-	assert(moves.size() == move_positions.size());
-
-	std::ofstream fout_game_log(game_log_filename);
-	fout_game_log << "FirstPlayer:" << "\t" << STR_MOVE(FIRST_PLAYER_MOVE) << "\t" << "Bot:" << "\t" << STR_MOVE(BOT_MOVE) << std::endl;
-	fout_game_log << "#Moves:" << "\t" << moves.size() << std::endl;
+	fprintf(game_log_file, "FirstPlayer:\t%s\tBot:\t%s\n", STR_MOVE(_player_roles.first_player_move), STR_MOVE(_player_roles.bot_move));
+	fprintf(game_log_file, "#Moves:\t%lu\n", moves.size());
 	for (size_t move_index = 0; move_index < moves.size(); ++move_index) {
-		fout_game_log << STR_MOVE(moves.at(move_index)) << "\t" 
-		<< move_positions.at(move_index).first << "\t"
-		<< move_positions.at(move_index).second << std::endl;
+		fprintf(game_log_file, "%s\t%lu\t%lu\n", STR_MOVE(moves.at(move_index)),
+			move_positions.at(move_index).first, move_positions.at(move_index).second);
+	}
+	fprintf(game_log_file, "%s\n", STR_GAME_OUTCOME(game_outcome));
+	bool success = ferror(game_log_file) == 0;
+	success = fclose(game_log_file) == 0 && success;
+	if (!success) {
+		// Neither archived nor counted: the next start must not expect it.
+		printf("Statistics::_save_game_moves(): Cannot write game log file = %s\n", game_log_filename.c_str());
+		fflush(stdout);
+		remove(game_log_filename.c_str());
+		return;
+	}
+
+	_game_archive.append(move_positions, game_outcome, _player_roles, static_cast<uint32_t>(time));
+	_game_archive.set_num_source_files(_game_archive.num_source_files() + 1);
+	if (++_num_unsaved_games >= GAME_ARCHIVE_SAVE_INTERVAL) {
+		_save_game_archive();
 	}
-	fout_game_log << STR_GAME_OUTCOME(game_outcome) << std::endl;
-	fout_game_log.close();
 }
 
-void Statistics::_read_game_moves(std::string game_log_filename, std::vector<Move> & moves, std::vector<MovePosition> & move_positions, GameState & game_state) {
+void Statistics::_save_game_archive() {
+	TRACE_SCOPE("Statistics::_save_game_archive");
+	if (_game_archive.save(std::string(GAME_LOG_DIRECTORY_NAME) + "/" + GAME_ARCHIVE_FILENAME)) {
+		_num_unsaved_games = 0;
+	}
+}
+
+void Statistics::_read_game_moves(std::string game_log_filename, std::vector<Move> & moves, std::vector<MovePosition> & move_positions, GameState & game_state, PlayerRoles & player_roles) {
+	TRACE_SCOPE("Statistics::_read_game_moves");
 	moves.clear();
 	move_positions.clear();
 
@@ -202,6 +290,12 @@ void Statistics::_read_game_moves(std::string game_log_filename, std::vector<Mov
 	size_t num_moves = 0;
 
 	fin_game_log >> tag >> first_player_move >> tag >> bot_move;
+	if (STR_MOVE_TO_MOVE(first_player_move) != Move::EMPTY && STR_MOVE_TO_MOVE(bot_move) != Move::EMPTY) {
+		player_roles.first_player_move = STR_MOVE_TO_MOVE(first_player_move);
+		player_roles.bot_move = STR_MOVE_TO_MOVE(bot_move);
+		player_roles.player_move = OPPONENT_MOVE(player_roles.bot_move);
+		player_roles.play_bot = true;
+	}
 	fin_game_log >> tag >> num_moves;
 
 	for (size_t move_index = 0; move_index < num_moves; ++move_index) {
@@ -216,5 +310,5 @@ void Statistics::_read_game_moves(std::string game_log_filename, std::vector<Mov
 	fin_game_log >> game_outcome_string;
 	fin_game_log.close();
 
-	game_state = _get_game_state_from_game_outcome(STR_GAME_OUTCOME_TO_GAME_OUTCOME(game_outcome_string));
+	game_state = _get_game_state_from_game_outcome(STR_GAME_OUTCOME_TO_GAME_OUTCOME(game_outcome_string), player_roles.player_move);
 }
\ No newline at end of file
@@ -0,0 +1,388 @@
+#include "tablebase.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <vector>
+
+#include "constants.h"
+#include "grid.h"
+#include "grid_symmetry.h"
+#include "task_scheduler.h"
+
+#define TABLEBASE_MAGIC "TTTBASE1"
+#define TABLEBASE_GRAIN_SIZE (256)
+
+struct TablebaseHeader {
+    char magic[8];
+    uint32_t num_rows;
+    uint32_t num_cols;
+    uint64_t num_positions;
+    uint64_t results_offset;
+    uint64_t distances_offset;
+};
+
+static uint64_t _count_positions() {
+    uint64_t num_positions = 1;
+    for (size_t cell = 0; cell < MAX_RANK; ++cell) {
+        num_positions *= 3;
+    }
+    return num_positions;
+}
+
+// Works out whose turn it is from the mark counts. Returns false for grids
+// that cannot come up in a game.
+static bool _get_player_to_move(const Grid & grid, Move & player) {
+    Move first_player = grid.first_player();
+    Move second_player = OPPONENT_MOVE(first_player);
+    size_t num_first = 0, num_second = 0;
+    for (int8_t row = 0; row < NUM_ROWS; ++row) {
+        for (int8_t col = 0; col < NUM_COLS; ++col) {
+            Move move = grid.value(row, col);
+            if (move == first_player) {
+                ++num_first;
+            } else if (move == second_player) {
+                ++num_second;
+            }
+        }
+    }
+    if (num_first == num_second) {
+        player = first_player;
+    } else if (num_first == num_second + 1) {
+        player = second_player;
+    } else {
+        return false;
+    }
+
+    // Only the player who just moved can have completed a line.
+    switch (grid.game_state()) {
+        case GameState::CROSS_WINS:
+            return player != Move::CROSS;
+        case GameState::NOUGHT_WINS:
+            return player != Move::NOUGHT;
+        case GameState::ONGOING:
+        case GameState::DRAW:
+            return true;
+        case GameState::INVALID:
+        default:
+            return false;
+    }
+}
+
+Tablebase::Tablebase() :
+    _mapped_results(nullptr),
+    _mapped_distances(nullptr),
+    _mapping(nullptr),
+    _mapping_size(0),
+    _num_positions(0)
+{
+
+}
+
+Tablebase::~Tablebase() {
+    unload();
+}
+
+void Tablebase::generate(TaskScheduler & scheduler) {
+    unload();
+    _num_positions = _count_positions();
+    _results.assign(_num_positions, static_cast<uint8_t>(TablebaseResult::UNKNOWN));
+    _distances.assign(_num_positions, 0);
+
+    // Bucket the legal canonical positions by rank; each rank only depends
+    // on the rank after it. Every chunk of indices fills its own buckets,
+    // which are concatenated in chunk order afterwards.
+    auto start = std::chrono::steady_clock::now();
+    size_t num_chunks = std::max<size_t>(1, std::min<uint64_t>(_num_positions / TABLEBASE_GRAIN_SIZE, 64 * scheduler.num_workers()));
+    std::vector<std::vector<std::vector<uint64_t>>> chunk_levels(num_chunks, std::vector<std::vector<uint64_t>>(MAX_RANK + 1));
+    scheduler.parallel_for(0, num_chunks, 1, [&](size_t chunk_begin, size_t chunk_end) {
+        for (size_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+            uint64_t begin = _num_positions * chunk / num_chunks;
+            uint64_t end = _num_positions * (chunk + 1) / num_chunks;
+            for (uint64_t index = begin; index < end; ++index) {
+                Grid grid = grid_from_index(index);
+                Move player = Move::EMPTY;
+                if (!_get_player_to_move(grid, player) || canonical_grid_index(grid) != index) {
+                    continue;
+                }
+                chunk_levels[chunk][grid.rank()].push_back(index);
+            }
+        }
+    });
+    std::vector<std::vector<uint64_t>> levels(MAX_RANK + 1);
+    for (std::vector<std::vector<uint64_t>> & chunk_level : chunk_levels) {
+        for (size_t rank = 0; rank <= MAX_RANK; ++rank) {
+            levels[rank].insert(levels[rank].end(), chunk_level[rank].begin(), chunk_level[rank].end());
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    printf("Tablebase::generate(): Enumerated positions in %.3f s\n", std::chrono::duration<double>(end - start).count());
+
+    for (size_t level = 0; level <= MAX_RANK; ++level) {
+        size_t rank = MAX_RANK - level;
+        const std::vector<uint64_t> & positions = levels[rank];
+        start = std::chrono::steady_clock::now();
+        scheduler.parallel_for(0, positions.size(), TABLEBASE_GRAIN_SIZE, [&](size_t begin, size_t end) {
+            for (size_t position_index = begin; position_index < end; ++position_index) {
+                _solve_position(positions[position_index]);
+            }
+        });
+        end = std::chrono::steady_clock::now();
+        printf("Tablebase::generate(): Rank = %lu, positions = %lu, time = %.3f s\n", rank, positions.size(),
+               std::chrono::duration<double>(end - start).count());
+    }
+    fflush(stdout);
+}
+
+bool Tablebase::save(const std::string & filename, bool save_distances) const {
+    if (_num_positions == 0) {
+        printf("Tablebase::save(): Nothing to save.\n");
+        return false;
+    }
+
+    uint64_t results_size = (_num_positions + 3) / 4;
+    TablebaseHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TABLEBASE_MAGIC, sizeof(header.magic));
+    header.num_rows = NUM_ROWS;
+    header.num_cols = NUM_COLS;
+    header.num_positions = _num_positions;
+    header.results_offset = sizeof(header);
+    header.distances_offset = save_distances ? header.results_offset + results_size : 0;
+
+    std::vector<uint8_t> packed_results(results_size, 0);
+    std::vector<uint8_t> distances;
+    for (uint64_t index = 0; index < _num_positions; ++index) {
+        packed_results[index >> 2] |= static_cast<uint8_t>(static_cast<uint8_t>(_result(index)) << ((index & 3) * 2));
+        if (save_distances) {
+            distances.push_back(_distance(index));
+        }
+    }
+
+    FILE * file = fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        printf("Tablebase::save(): Cannot open file = %s\n", filename.c_str());
+        return false;
+    }
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(packed_results.data(), 1, packed_results.size(), file) == packed_results.size()
+        && fwrite(distances.data(), 1, distances.size(), file) == distances.size();
+    fclose(file);
+    if (!success) {
+        printf("Tablebase::save(): Cannot write file = %s\n", filename.c_str());
+    }
+    return success;
+}
+
+bool Tablebase::load(const std::string & filename) {
+    unload();
+
+    int file_descriptor = open(filename.c_str(), O_RDONLY);
+    if (file_descriptor < 0) {
+        printf("Tablebase::load(): Cannot open file = %s\n", filename.c_str());
+        return false;
+    }
+    struct stat file_status;
+    if (fstat(file_descriptor, &file_status) != 0 || static_cast<size_t>(file_status.st_size) < sizeof(TablebaseHeader)) {
+        printf("Tablebase::load(): File too small = %s\n", filename.c_str());
+        close(file_descriptor);
+        return false;
+    }
+    size_t mapping_size = static_cast<size_t>(file_status.st_size);
+    void * mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+    close(file_descriptor);
+    if (mapping == MAP_FAILED) {
+        printf("Tablebase::load(): Cannot map file = %s\n", filename.c_str());
+        return false;
+    }
+
+    const TablebaseHeader * header = static_cast<const TablebaseHeader *>(mapping);
+    uint64_t results_size = (header->num_positions + 3) / 4;
+    bool valid = memcmp(header->magic, TABLEBASE_MAGIC, sizeof(header->magic)) == 0
+        && header->num_rows == NUM_ROWS
+        && header->num_cols == NUM_COLS
+        && header->num_positions == _count_positions()
+        && header->results_offset + results_size <= mapping_size
+        && (header->distances_offset == 0 || header->distances_offset + header->num_positions <= mapping_size);
+    if (!valid) {
+        printf("Tablebase::load(): File %s does not hold a %dx%d tablebase.\n", filename.c_str(), NUM_ROWS, NUM_COLS);
+        munmap(mapping, mapping_size);
+        return false;
+    }
+
+    _mapping = mapping;
+    _mapping_size = mapping_size;
+    _num_positions = header->num_positions;
+    _mapped_results = static_cast<const uint8_t *>(mapping) + header->results_offset;
+    _mapped_distances = header->distances_offset != 0 ? static_cast<const uint8_t *>(mapping) + header->distances_offset : nullptr;
+    printf("Tablebase::load(): Loaded %lu positions from %s\n", _num_positions, filename.c_str());
+    return true;
+}
+
+void Tablebase::unload() {
+    if (_mapping != nullptr) {
+        munmap(_mapping, _mapping_size);
+    }
+    _mapping = nullptr;
+    _mapping_size = 0;
+    _mapped_results = nullptr;
+    _mapped_distances = nullptr;
+    _results.clear();
+    _distances.clear();
+    _num_positions = 0;
+}
+
+bool Tablebase::is_loaded() const {
+    return _num_positions > 0;
+}
+
+bool Tablebase::has_distances() const {
+    return _mapping != nullptr ? _mapped_distances != nullptr : !_distances.empty();
+}
+
+uint64_t Tablebase::num_positions() const {
+    return _num_positions;
+}
+
+bool Tablebase::probe(const Grid & grid, TablebaseResult & result, uint8_t & distance) const {
+    result = TablebaseResult::UNKNOWN;
+    distance = 0;
+    if (!is_loaded()) {
+        return false;
+    }
+    // The table holds games started by DEFAULT_FIRST_PLAYER_MOVE; swapping
+    // the symbols keeps the result for the side to move.
+    uint64_t index = grid.first_player() == DEFAULT_FIRST_PLAYER_MOVE ?
+        canonical_grid_index(grid) : canonical_grid_index(grid.swapped_players());
+    result = _result(index);
+    distance = _distance(index);
+    return result != TablebaseResult::UNKNOWN;
+}
+
+bool Tablebase::get_best_move(const Grid & grid, MovePosition & position) const {
+    position = std::make_pair(NUM_ROWS, NUM_COLS);
+    Move player = grid.next_player();
+    if (!is_loaded() || player == Move::EMPTY) {
+        return false;
+    }
+
+    // Win as fast as possible, otherwise draw, otherwise lose as slowly as
+    // possible.
+    int32_t best_score = -1;
+    Grid child = grid;
+    for (int8_t row = 0; row < NUM_ROWS; ++row) {
+        for (int8_t col = 0; col < NUM_COLS; ++col) {
+            if (child.value(row, col) != Move::EMPTY) {
+                continue;
+            }
+            child.make_move(row, col, player);
+            TablebaseResult child_result = TablebaseResult::UNKNOWN;
+            uint8_t child_distance = 0;
+            bool found = probe(child, child_result, child_distance);
+            child.unmake_move(row, col);
+            if (!found) {
+                return false;
+            }
+
+            int32_t score = 0;
+            if (child_result == TablebaseResult::LOSS) {
+                score = 2000 - child_distance;
+            } else if (child_result == TablebaseResult::DRAW) {
+                score = 1000;
+            } else {
+                score = child_distance;
+            }
+            if (score > best_score) {
+                best_score = score;
+                position = std::make_pair(row, col);
+            }
+        }
+    }
+    return best_score >= 0;
+}
+
+TablebaseResult Tablebase::_result(uint64_t index) const {
+    assert(index < _num_positions);
+    if (_mapped_results != nullptr) {
+        return static_cast<TablebaseResult>((_mapped_results[index >> 2] >> ((index & 3) * 2)) & 3);
+    }
+    return static_cast<TablebaseResult>(_results[index]);
+}
+
+uint8_t Tablebase::_distance(uint64_t index) const {
+    assert(index < _num_positions);
+    if (_mapping != nullptr) {
+        return _mapped_distances != nullptr ? _mapped_distances[index] : 0;
+    }
+    return _distances.empty() ? 0 : _distances[index];
+}
+
+void Tablebase::_solve_position(uint64_t index) {
+    Grid grid = grid_from_index(index);
+    Move player = Move::EMPTY;
+    bool legal = _get_player_to_move(grid, player);
+    assert(legal);
+    (void) legal;
+
+    switch (grid.game_state()) {
+        case GameState::CROSS_WINS:
+        case GameState::NOUGHT_WINS:
+            _results[index] = static_cast<uint8_t>(TablebaseResult::LOSS);
+            _distances[index] = 0;
+            return;
+        case GameState::DRAW:
+            _results[index] = static_cast<uint8_t>(TablebaseResult::DRAW);
+            _distances[index] = 0;
+            return;
+        case GameState::ONGOING:
+        case GameState::INVALID:
+        default:
+            break;
+    }
+
+    bool has_win = false, has_draw = false;
+    uint8_t win_distance = UINT8_MAX, draw_distance = 0, loss_distance = 0;
+    for (int8_t row = 0; row < NUM_ROWS; ++row) {
+        for (int8_t col = 0; col < NUM_COLS; ++col) {
+            if (grid.value(row, col) != Move::EMPTY) {
+                continue;
+            }
+            grid.make_move(row, col, player);
+            uint64_t child_index = canonical_grid_index(grid);
+            grid.unmake_move(row, col);
+
+            TablebaseResult child_result = static_cast<TablebaseResult>(_results[child_index]);
+            uint8_t child_distance = _distances[child_index];
+            assert(child_result != TablebaseResult::UNKNOWN);
+            if (child_result == TablebaseResult::LOSS) {
+                has_win = true;
+                win_distance = std::min<uint8_t>(win_distance, child_distance);
+            } else if (child_result == TablebaseResult::DRAW) {
+                has_draw = true;
+                draw_distance = std::max<uint8_t>(draw_distance, child_distance);
+            } else {
+                loss_distance = std::max<uint8_t>(loss_distance, child_distance);
+            }
+        }
+    }
+
+    if (has_win) {
+        _results[index] = static_cast<uint8_t>(TablebaseResult::WIN);
+        _distances[index] = static_cast<uint8_t>(win_distance + 1);
+    } else if (has_draw) {
+        _results[index] = static_cast<uint8_t>(TablebaseResult::DRAW);
+        _distances[index] = static_cast<uint8_t>(draw_distance + 1);
+    } else {
+        _results[index] = static_cast<uint8_t>(TablebaseResult::LOSS);
+        _distances[index] = static_cast<uint8_t>(loss_distance + 1);
+    }
+}
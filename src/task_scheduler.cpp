@@ -0,0 +1,262 @@
+#include "task_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#define SCHEDULER_SPINS_BEFORE_SLEEP (64)
+#define SCHEDULER_SLEEP_TIMEOUT_US (1000)
+
+static thread_local const TaskScheduler * _worker_scheduler = nullptr;
+static thread_local int64_t _worker_index = -1;
+
+static uint64_t _now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+TaskScheduler & TaskScheduler::instance() {
+    static TaskScheduler scheduler(std::max<size_t>(1, std::thread::hardware_concurrency()));
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler(size_t num_workers, bool pin_workers) :
+    _workers(new Worker[std::max<size_t>(1, num_workers)]),
+    _num_workers(std::max<size_t>(1, num_workers)),
+    _num_injected(0),
+    _num_sleeping(0),
+    _stopping(false)
+{
+    for (size_t worker_index = 0; worker_index < _num_workers; ++worker_index) {
+        Worker & worker = _workers[worker_index];
+        worker.tasks_executed.store(0, std::memory_order_relaxed);
+        worker.tasks_stolen.store(0, std::memory_order_relaxed);
+        worker.steal_attempts.store(0, std::memory_order_relaxed);
+        worker.busy_ns.store(0, std::memory_order_relaxed);
+        worker.idle_ns.store(0, std::memory_order_relaxed);
+    }
+    for (size_t worker_index = 0; worker_index < _num_workers; ++worker_index) {
+        _workers[worker_index].thread = std::thread(&TaskScheduler::_worker_loop, this, worker_index, pin_workers);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    _stopping.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(_sleep_mutex);
+        _sleep_condition.notify_all();
+    }
+    for (size_t worker_index = 0; worker_index < _num_workers; ++worker_index) {
+        _workers[worker_index].thread.join();
+    }
+}
+
+size_t TaskScheduler::num_workers() const {
+    return _num_workers;
+}
+
+void TaskScheduler::parallel_for(size_t begin, size_t end, size_t grain_size, const std::function<void(size_t, size_t)> & body) {
+    if (begin >= end) {
+        return;
+    }
+    grain_size = std::max<size_t>(1, grain_size);
+
+    // Split the range in halves, keeping the left half and spawning the
+    // right one, so thieves take large chunks from the top of the deque.
+    TaskGroup group(*this);
+    std::function<void(size_t, size_t)> split = [&](size_t range_begin, size_t range_end) {
+        while (range_end - range_begin > grain_size) {
+            size_t middle = range_begin + (range_end - range_begin) / 2;
+            group.run([&split, middle, range_end]() { split(middle, range_end); });
+            range_end = middle;
+        }
+        body(range_begin, range_end);
+    };
+    split(begin, end);
+    group.wait();
+}
+
+std::vector<WorkerStatistics> TaskScheduler::get_worker_statistics() const {
+    std::vector<WorkerStatistics> worker_statistics;
+    for (size_t worker_index = 0; worker_index < _num_workers; ++worker_index) {
+        const Worker & worker = _workers[worker_index];
+        WorkerStatistics statistics;
+        statistics.tasks_executed = worker.tasks_executed.load(std::memory_order_relaxed);
+        statistics.tasks_stolen = worker.tasks_stolen.load(std::memory_order_relaxed);
+        statistics.steal_attempts = worker.steal_attempts.load(std::memory_order_relaxed);
+        statistics.busy_ns = worker.busy_ns.load(std::memory_order_relaxed);
+        statistics.idle_ns = worker.idle_ns.load(std::memory_order_relaxed);
+        uint64_t total_ns = statistics.busy_ns + statistics.idle_ns;
+        statistics.utilization = total_ns > 0 ? static_cast<double>(statistics.busy_ns) / total_ns : 0.0;
+        worker_statistics.push_back(statistics);
+    }
+    return worker_statistics;
+}
+
+void TaskScheduler::print_worker_statistics() const {
+    std::vector<WorkerStatistics> worker_statistics = get_worker_statistics();
+    for (size_t worker_index = 0; worker_index < worker_statistics.size(); ++worker_index) {
+        const WorkerStatistics & statistics = worker_statistics.at(worker_index);
+        printf("TaskScheduler: worker = %lu, executed = %lu, stolen = %lu, steal_attempts = %lu, utilization = %.1f%%\n",
+               worker_index, statistics.tasks_executed, statistics.tasks_stolen, statistics.steal_attempts,
+               100.0 * statistics.utilization);
+    }
+    fflush(stdout);
+}
+
+void TaskScheduler::_submit(Task * task) {
+    int64_t worker_index = _current_worker_index();
+    if (worker_index >= 0) {
+        _workers[worker_index].deque.push(task);
+    } else {
+        std::lock_guard<std::mutex> lock(_injection_mutex);
+        _injection_queue.push_back(task);
+        _num_injected.fetch_add(1, std::memory_order_release);
+    }
+    if (_num_sleeping.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(_sleep_mutex);
+        _sleep_condition.notify_one();
+    }
+}
+
+bool TaskScheduler::_run_next_task(int64_t worker_index) {
+    Task * task = _find_task(worker_index);
+    if (task == nullptr) {
+        return false;
+    }
+    _execute(task, worker_index);
+    return true;
+}
+
+TaskScheduler::Task * TaskScheduler::_find_task(int64_t worker_index) {
+    if (worker_index >= 0) {
+        Task * task = _workers[worker_index].deque.pop();
+        if (task != nullptr) {
+            return task;
+        }
+    }
+    if (_num_injected.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(_injection_mutex);
+        if (!_injection_queue.empty()) {
+            Task * task = _injection_queue.front();
+            _injection_queue.pop_front();
+            _num_injected.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+
+    // Start from a different victim per thief to spread contention.
+    size_t first_victim = worker_index >= 0 ? static_cast<size_t>(worker_index) + 1 : 0;
+    for (size_t offset = 0; offset < _num_workers; ++offset) {
+        size_t victim = (first_victim + offset) % _num_workers;
+        if (static_cast<int64_t>(victim) == worker_index) {
+            continue;
+        }
+        if (worker_index >= 0) {
+            _workers[worker_index].steal_attempts.fetch_add(1, std::memory_order_relaxed);
+        }
+        Task * task = _workers[victim].deque.steal();
+        if (task != nullptr) {
+            if (worker_index >= 0) {
+                _workers[worker_index].tasks_stolen.fetch_add(1, std::memory_order_relaxed);
+            }
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+void TaskScheduler::_execute(Task * task, int64_t worker_index) {
+    uint64_t start_ns = _now_ns();
+    task->function();
+    TaskGroup * group = task->group;
+    delete task;
+    group->_num_pending.fetch_sub(1, std::memory_order_acq_rel);
+
+    if (worker_index >= 0) {
+        Worker & worker = _workers[worker_index];
+        worker.tasks_executed.fetch_add(1, std::memory_order_relaxed);
+        worker.busy_ns.fetch_add(_now_ns() - start_ns, std::memory_order_relaxed);
+    }
+}
+
+void TaskScheduler::_worker_loop(size_t worker_index, bool pin_worker) {
+    _worker_scheduler = this;
+    _worker_index = static_cast<int64_t>(worker_index);
+
+#ifdef __linux__
+    if (pin_worker) {
+        size_t num_cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(worker_index % num_cores, &cpu_set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0) {
+            printf("TaskScheduler::_worker_loop(): Cannot pin worker %lu\n", worker_index);
+        }
+    }
+#else
+    (void) pin_worker;
+#endif
+
+    Worker & worker = _workers[worker_index];
+    size_t num_spins = 0;
+    while (!_stopping.load(std::memory_order_acquire)) {
+        uint64_t idle_start_ns = _now_ns();
+        if (_run_next_task(static_cast<int64_t>(worker_index))) {
+            num_spins = 0;
+            continue;
+        }
+        if (++num_spins < SCHEDULER_SPINS_BEFORE_SLEEP) {
+            std::this_thread::yield();
+        } else {
+            // Timed wait, so a wake-up missed between the last failed
+            // search and going to sleep costs at most one timeout.
+            std::unique_lock<std::mutex> lock(_sleep_mutex);
+            _num_sleeping.fetch_add(1, std::memory_order_acq_rel);
+            _sleep_condition.wait_for(lock, std::chrono::microseconds(SCHEDULER_SLEEP_TIMEOUT_US));
+            _num_sleeping.fetch_sub(1, std::memory_order_acq_rel);
+        }
+        worker.idle_ns.fetch_add(_now_ns() - idle_start_ns, std::memory_order_relaxed);
+    }
+}
+
+int64_t TaskScheduler::_current_worker_index() const {
+    return _worker_scheduler == this ? _worker_index : -1;
+}
+
+TaskGroup::TaskGroup(TaskScheduler & scheduler) :
+    _scheduler(scheduler),
+    _num_pending(0)
+{
+
+}
+
+TaskGroup::~TaskGroup() {
+    wait();
+}
+
+void TaskGroup::run(std::function<void()> function) {
+    _num_pending.fetch_add(1, std::memory_order_acq_rel);
+    _scheduler._submit(new TaskScheduler::Task{std::move(function), this});
+}
+
+void TaskGroup::wait() {
+    int64_t worker_index = _scheduler._current_worker_index();
+    while (_num_pending.load(std::memory_order_acquire) > 0) {
+        if (!_scheduler._run_next_task(worker_index)) {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,220 @@
+#include "tournament.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "grid.h"
+
+// Games handed to one scheduler task.
+#define TOURNAMENT_GRAIN_SIZE (64)
+// The rating fit stops once no rating moves by more than this many Elo
+// points in an iteration, or after the iteration cap.
+#define TOURNAMENT_RATING_TOLERANCE (1e-6)
+#define TOURNAMENT_MAX_RATING_ITERATIONS (100000)
+// Two-sided 95% quantile of the normal distribution.
+#define TOURNAMENT_CONFIDENCE_Z (1.96)
+
+static uint64_t _splitmix64(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+Tournament::Tournament(uint64_t seed) :
+    _seed(seed)
+{
+
+}
+
+void Tournament::add_player(const std::string & name, GameBot * bot) {
+    assert(bot != nullptr);
+    _names.push_back(name);
+    _bots.push_back(bot);
+}
+
+size_t Tournament::num_players() const {
+    return _bots.size();
+}
+
+TournamentResult Tournament::run(size_t games_per_pair, TaskScheduler & scheduler) {
+    size_t num_players = _bots.size();
+    TournamentResult result;
+    result.names = _names;
+    result.wins.assign(num_players, std::vector<uint64_t>(num_players, 0));
+    result.draws.assign(num_players, std::vector<uint64_t>(num_players, 0));
+    result.losses.assign(num_players, std::vector<uint64_t>(num_players, 0));
+
+    std::vector<std::pair<size_t, size_t>> pairs;
+    for (size_t player = 0; player < num_players; ++player) {
+        for (size_t opponent = player + 1; opponent < num_players; ++opponent) {
+            pairs.push_back(std::make_pair(player, opponent));
+        }
+    }
+    result.num_games = pairs.size() * games_per_pair;
+
+    GameState first_player_wins = DEFAULT_FIRST_PLAYER_MOVE == Move::CROSS ? GameState::CROSS_WINS : GameState::NOUGHT_WINS;
+    std::mutex result_mutex;
+    auto start = std::chrono::steady_clock::now();
+    scheduler.parallel_for(0, result.num_games, TOURNAMENT_GRAIN_SIZE, [&](size_t begin, size_t end) {
+        // Tallied per task and added under the lock once.
+        std::vector<uint64_t> wins(num_players * num_players, 0);
+        std::vector<uint64_t> draws(num_players * num_players, 0);
+        for (size_t game_index = begin; game_index < end; ++game_index) {
+            const std::pair<size_t, size_t> & pair = pairs[game_index / games_per_pair];
+            bool player_first = (game_index % games_per_pair) % 2 == 0;
+            size_t first_player = player_first ? pair.first : pair.second;
+            size_t second_player = player_first ? pair.second : pair.first;
+
+            GameState game_state = _play_game(_bots[first_player], _bots[second_player], game_index);
+            if (game_state == GameState::DRAW) {
+                ++draws[pair.first * num_players + pair.second];
+            } else if (game_state == first_player_wins) {
+                ++wins[first_player * num_players + second_player];
+            } else {
+                ++wins[second_player * num_players + first_player];
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(result_mutex);
+        for (size_t player = 0; player < num_players; ++player) {
+            for (size_t opponent = 0; opponent < num_players; ++opponent) {
+                uint64_t num_wins = wins[player * num_players + opponent];
+                uint64_t num_draws = draws[player * num_players + opponent];
+                result.wins[player][opponent] += num_wins;
+                result.losses[opponent][player] += num_wins;
+                result.draws[player][opponent] += num_draws;
+                if (opponent != player) {
+                    result.draws[opponent][player] += num_draws;
+                }
+            }
+        }
+    });
+    auto end = std::chrono::steady_clock::now();
+
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.games_per_second = result.seconds > 0.0 ? result.num_games / result.seconds : 0.0;
+    _estimate_ratings(result);
+    return result;
+}
+
+void Tournament::print_result(const TournamentResult & result) {
+    size_t num_players = result.names.size();
+    printf("Wins/draws/losses of the row player:\n");
+    printf("%-20s", "");
+    for (size_t opponent = 0; opponent < num_players; ++opponent) {
+        printf(" %20s", result.names[opponent].c_str());
+    }
+    printf("\n");
+    for (size_t player = 0; player < num_players; ++player) {
+        printf("%-20s", result.names[player].c_str());
+        for (size_t opponent = 0; opponent < num_players; ++opponent) {
+            if (opponent == player) {
+                printf(" %20s", "-");
+                continue;
+            }
+            std::string cell = std::to_string(result.wins[player][opponent]) + "/"
+                + std::to_string(result.draws[player][opponent]) + "/"
+                + std::to_string(result.losses[player][opponent]);
+            printf(" %20s", cell.c_str());
+        }
+        printf("\n");
+    }
+
+    printf("\nElo (95%% confidence):\n");
+    for (size_t player = 0; player < num_players; ++player) {
+        printf("%-20s %8.1f +/- %.1f\n", result.names[player].c_str(), result.ratings[player], result.rating_errors[player]);
+    }
+    printf("\n%lu games in %.3f s, %.0f games/s\n", result.num_games, result.seconds, result.games_per_second);
+}
+
+GameState Tournament::_play_game(GameBot * first_bot, GameBot * second_bot, uint64_t game_index) const {
+    uint64_t random_state = _splitmix64(_seed ^ _splitmix64(game_index));
+    Grid grid;
+    while (!grid.has_game_ended()) {
+        Move player = grid.next_player();
+        GameBot * bot = player == grid.first_player() ? first_bot : second_bot;
+        random_state = _splitmix64(random_state);
+
+        MovePosition position;
+        if (!bot->get_seeded_move(grid, static_cast<uint32_t>(random_state >> 32), position)) {
+            // A bot without a move forfeits the game.
+            return player == Move::CROSS ? GameState::NOUGHT_WINS : GameState::CROSS_WINS;
+        }
+        grid.set_value(position.first, position.second);
+    }
+    return grid.game_state();
+}
+
+void Tournament::_estimate_ratings(TournamentResult & result) {
+    // Maximum likelihood fit of the logistic Elo model, draws counting as
+    // half a win. One extra draw per pair keeps perfect scores finite.
+    // Hunter's minorization-maximization iteration on the strengths
+    // gamma = 10^(rating / 400): every update raises the likelihood, so the
+    // fit converges from any start, which plain Newton steps do not.
+    const double elo_scale = 400.0 / std::log(10.0);
+    size_t num_players = result.names.size();
+    result.ratings.assign(num_players, 0.0);
+    result.rating_errors.assign(num_players, 0.0);
+
+    std::vector<double> strengths(num_players, 1.0);
+    for (size_t iteration = 0; iteration < TOURNAMENT_MAX_RATING_ITERATIONS; ++iteration) {
+        double max_change = 0.0;
+        for (size_t player = 0; player < num_players; ++player) {
+            double score = 0.0;
+            double denominator = 0.0;
+            for (size_t opponent = 0; opponent < num_players; ++opponent) {
+                if (opponent == player) {
+                    continue;
+                }
+                double num_games = result.wins[player][opponent] + result.draws[player][opponent] + result.losses[player][opponent] + 1.0;
+                score += result.wins[player][opponent] + 0.5 * result.draws[player][opponent] + 0.5;
+                denominator += num_games / (strengths[player] + strengths[opponent]);
+            }
+            if (denominator <= 0.0) {
+                continue;
+            }
+            // Updated in place, so later players already see this one's
+            // new strength.
+            double strength = score / denominator;
+            max_change = std::max(max_change, std::fabs(elo_scale * std::log(strength / strengths[player])));
+            strengths[player] = strength;
+        }
+
+        // The model only fixes rating differences; keep the geometric mean
+        // of the strengths at 1 so they neither drift nor underflow.
+        double mean_log_strength = 0.0;
+        for (double strength : strengths) {
+            mean_log_strength += std::log(strength);
+        }
+        mean_log_strength /= num_players > 0 ? num_players : 1;
+        for (double & strength : strengths) {
+            strength /= std::exp(mean_log_strength);
+        }
+        if (max_change < TOURNAMENT_RATING_TOLERANCE) {
+            break;
+        }
+    }
+    for (size_t player = 0; player < num_players; ++player) {
+        result.ratings[player] = elo_scale * std::log(strengths[player]);
+    }
+
+    for (size_t player = 0; player < num_players; ++player) {
+        double information = 0.0;
+        for (size_t opponent = 0; opponent < num_players; ++opponent) {
+            if (opponent == player) {
+                continue;
+            }
+            double num_games = result.wins[player][opponent] + result.draws[player][opponent] + result.losses[player][opponent] + 1.0;
+            double expected = 1.0 / (1.0 + std::pow(10.0, (result.ratings[opponent] - result.ratings[player]) / 400.0));
+            information += num_games * expected * (1.0 - expected);
+        }
+        result.rating_errors[player] = information > 0.0 ? TOURNAMENT_CONFIDENCE_Z * elo_scale / std::sqrt(information) : 0.0;
+    }
+}
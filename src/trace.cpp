@@ -0,0 +1,161 @@
+#include "trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Events a thread keeps before handing them to the writer.
+#define TRACE_BUFFER_EVENTS (4096)
+// stdio buffer of the trace file.
+#define TRACE_FILE_BUFFER_SIZE (1 << 20)
+
+namespace {
+
+struct TraceEvent {
+    const char * name;
+    char phase;
+    uint64_t timestamp_ns;
+};
+
+struct ThreadTraceBuffer;
+
+struct TraceWriter {
+    std::mutex mutex;
+    FILE * file = nullptr;
+    std::vector<char> file_buffer;
+    bool first_event = true;
+    std::chrono::steady_clock::time_point start_time;
+    std::vector<ThreadTraceBuffer *> thread_buffers;
+    uint32_t next_thread_id = 1;
+};
+
+std::atomic<bool> _enabled(false);
+
+TraceWriter & _writer() {
+    static TraceWriter writer;
+    return writer;
+}
+
+// Called with the writer mutex held.
+void _write_events(TraceWriter & writer, uint32_t thread_id, const std::vector<TraceEvent> & events) {
+    if (writer.file == nullptr) {
+        return;
+    }
+    for (const TraceEvent & event : events) {
+        fprintf(writer.file, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                writer.first_event ? "" : ",", event.name, event.phase, thread_id, event.timestamp_ns * 1e-3);
+        writer.first_event = false;
+    }
+}
+
+// The buffer's own mutex is only contended while stop() drains it. Lock
+// order is the writer mutex first, then the buffer mutex.
+struct ThreadTraceBuffer {
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    uint32_t thread_id;
+
+    ThreadTraceBuffer() {
+        events.reserve(TRACE_BUFFER_EVENTS);
+        TraceWriter & writer = _writer();
+        std::lock_guard<std::mutex> lock(writer.mutex);
+        thread_id = writer.next_thread_id++;
+        writer.thread_buffers.push_back(this);
+    }
+
+    ~ThreadTraceBuffer() {
+        TraceWriter & writer = _writer();
+        std::lock_guard<std::mutex> writer_lock(writer.mutex);
+        std::lock_guard<std::mutex> lock(mutex);
+        _write_events(writer, thread_id, events);
+        for (size_t index = 0; index < writer.thread_buffers.size(); ++index) {
+            if (writer.thread_buffers[index] == this) {
+                writer.thread_buffers.erase(writer.thread_buffers.begin() + index);
+                break;
+            }
+        }
+    }
+};
+
+ThreadTraceBuffer & _thread_buffer() {
+    static thread_local ThreadTraceBuffer thread_buffer;
+    return thread_buffer;
+}
+
+}
+
+bool Tracer::start(const std::string & filename) {
+    stop();
+    TraceWriter & writer = _writer();
+    std::lock_guard<std::mutex> lock(writer.mutex);
+    writer.file = fopen(filename.c_str(), "w");
+    if (writer.file == nullptr) {
+        printf("Tracer::start(): Cannot open file = %s\n", filename.c_str());
+        return false;
+    }
+    writer.file_buffer.resize(TRACE_FILE_BUFFER_SIZE);
+    setvbuf(writer.file, writer.file_buffer.data(), _IOFBF, writer.file_buffer.size());
+    fprintf(writer.file, "{\"traceEvents\":[");
+    writer.first_event = true;
+    writer.start_time = std::chrono::steady_clock::now();
+    _enabled.store(true, std::memory_order_release);
+    return true;
+}
+
+void Tracer::stop() {
+    if (!_enabled.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    TraceWriter & writer = _writer();
+    std::lock_guard<std::mutex> writer_lock(writer.mutex);
+    for (ThreadTraceBuffer * thread_buffer : writer.thread_buffers) {
+        std::lock_guard<std::mutex> lock(thread_buffer->mutex);
+        _write_events(writer, thread_buffer->thread_id, thread_buffer->events);
+        thread_buffer->events.clear();
+    }
+    fprintf(writer.file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(writer.file);
+    writer.file = nullptr;
+}
+
+bool Tracer::is_enabled() {
+    return _enabled.load(std::memory_order_acquire);
+}
+
+void Tracer::record(const char * name, char phase) {
+    if (!is_enabled()) {
+        return;
+    }
+    uint64_t timestamp_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - _writer().start_time).count());
+
+    ThreadTraceBuffer & thread_buffer = _thread_buffer();
+    std::vector<TraceEvent> full_events;
+    {
+        std::lock_guard<std::mutex> lock(thread_buffer.mutex);
+        thread_buffer.events.push_back(TraceEvent{name, phase, timestamp_ns});
+        if (thread_buffer.events.size() >= TRACE_BUFFER_EVENTS) {
+            full_events.swap(thread_buffer.events);
+            thread_buffer.events.reserve(TRACE_BUFFER_EVENTS);
+        }
+    }
+    if (!full_events.empty()) {
+        TraceWriter & writer = _writer();
+        std::lock_guard<std::mutex> writer_lock(writer.mutex);
+        _write_events(writer, thread_buffer.thread_id, full_events);
+    }
+}
+
+ScopedTraceEvent::ScopedTraceEvent(const char * name) :
+    _name(name)
+{
+    Tracer::record(_name, 'B');
+}
+
+ScopedTraceEvent::~ScopedTraceEvent() {
+    Tracer::record(_name, 'E');
+}
@@ -0,0 +1,59 @@
+#include "transposition_table.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+#include "constants.h"
+
+static uint64_t _pack_entry(const TranspositionEntry & entry) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(entry.score))
+        | (static_cast<uint64_t>(entry.depth) << 32)
+        | (static_cast<uint64_t>(entry.bound) << 40)
+        | (static_cast<uint64_t>(entry.best_cell) << 48);
+}
+
+static TranspositionEntry _unpack_entry(uint64_t data) {
+    TranspositionEntry entry;
+    entry.score = static_cast<int32_t>(static_cast<uint32_t>(data & 0xFFFFFFFFULL));
+    entry.depth = static_cast<uint8_t>((data >> 32) & 0xFF);
+    entry.bound = static_cast<TranspositionBound>((data >> 40) & 0xFF);
+    entry.best_cell = static_cast<uint8_t>((data >> 48) & 0xFF);
+    return entry;
+}
+
+TranspositionTable::TranspositionTable(size_t size_log2) :
+    _slots(new Slot[static_cast<size_t>(1) << size_log2]),
+    _mask((static_cast<size_t>(1) << size_log2) - 1)
+{
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (size_t index = 0; index <= _mask; ++index) {
+        _slots[index].key.store(0, std::memory_order_relaxed);
+        _slots[index].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool TranspositionTable::probe(uint64_t hash, TranspositionEntry & entry) const {
+    const Slot & slot = _slots[hash & _mask];
+    uint64_t key = slot.key.load(std::memory_order_relaxed);
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    if ((key ^ data) != hash || data == 0) {
+        return false;
+    }
+    entry = _unpack_entry(data);
+    return entry.bound != TranspositionBound::NONE;
+}
+
+void TranspositionTable::store(uint64_t hash, const TranspositionEntry & entry) {
+    Slot & slot = _slots[hash & _mask];
+    uint64_t data = _pack_entry(entry);
+    slot.key.store(hash ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+size_t TranspositionTable::size() const {
+    return _mask + 1;
+}
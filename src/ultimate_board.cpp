@@ -0,0 +1,231 @@
+#include "ultimate_board.h"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+
+#include "constants.h"
+#include "grid.h"
+
+#define ULTIMATE_NUM_SUB_BOARD_INDICES (19683)
+#define ULTIMATE_ALL_CELLS ((1 << MAX_RANK) - 1)
+
+static_assert(NUM_ROWS == 3 && NUM_COLS == 3, "UltimateBoard packs 3x3 sub-boards into uint16_t");
+
+static constexpr uint16_t _POWERS_OF_THREE[MAX_RANK] = {1, 3, 9, 27, 81, 243, 729, 2187, 6561};
+
+static constexpr uint8_t _LINES[NUM_ROWS + NUM_COLS + NUM_DIAGS][NUM_ROWS] = {
+    {0, 1, 2}, {3, 4, 5}, {6, 7, 8},
+    {0, 3, 6}, {1, 4, 7}, {2, 5, 8},
+    {0, 4, 8}, {2, 4, 6},
+};
+
+static constexpr std::array<GameState, ULTIMATE_NUM_SUB_BOARD_INDICES> _compute_sub_board_outcomes() {
+    std::array<GameState, ULTIMATE_NUM_SUB_BOARD_INDICES> outcomes = {};
+    for (uint32_t index = 0; index < ULTIMATE_NUM_SUB_BOARD_INDICES; ++index) {
+        uint8_t cells[MAX_RANK] = {};
+        bool full = true;
+        for (uint32_t cell = 0, remaining = index; cell < MAX_RANK; ++cell, remaining /= 3) {
+            cells[cell] = static_cast<uint8_t>(remaining % 3);
+            full = full && cells[cell] != static_cast<uint8_t>(Move::EMPTY);
+        }
+        GameState outcome = full ? GameState::DRAW : GameState::ONGOING;
+        for (const auto & line : _LINES) {
+            uint8_t move = cells[line[0]];
+            if (move != static_cast<uint8_t>(Move::EMPTY) && cells[line[1]] == move && cells[line[2]] == move) {
+                outcome = move == static_cast<uint8_t>(Move::CROSS) ? GameState::CROSS_WINS : GameState::NOUGHT_WINS;
+                break;
+            }
+        }
+        outcomes[index] = outcome;
+    }
+    return outcomes;
+}
+
+static constexpr std::array<GameState, ULTIMATE_NUM_SUB_BOARD_INDICES> _SUB_BOARD_OUTCOMES = _compute_sub_board_outcomes();
+
+GameState UltimateBoard::sub_board_outcome(uint32_t sub_board_index) {
+    assert(sub_board_index < ULTIMATE_NUM_SUB_BOARD_INDICES);
+    return _SUB_BOARD_OUTCOMES[sub_board_index];
+}
+
+UltimateBoard::UltimateBoard() :
+    UltimateBoard(DEFAULT_FIRST_PLAYER_MOVE)
+{
+
+}
+
+UltimateBoard::UltimateBoard(Move first_player_move) :
+    _first_player(first_player_move)
+{
+    assert(first_player_move == Move::CROSS || first_player_move == Move::NOUGHT);
+    reset();
+}
+
+void UltimateBoard::reset() {
+    for (size_t sub_board = 0; sub_board < ULTIMATE_NUM_SUB_BOARDS; ++sub_board) {
+        _sub_board_indices[sub_board] = 0;
+        _occupied[sub_board] = 0;
+    }
+    _meta_index = 0;
+    _closed = 0;
+    _forced_sub_boards[0] = ULTIMATE_ANY_SUB_BOARD;
+    _rank = 0;
+    _game_state = GameState::ONGOING;
+}
+
+Move UltimateBoard::value(size_t sub_board, size_t cell) const {
+    assert(sub_board < ULTIMATE_NUM_SUB_BOARDS && cell < MAX_RANK);
+    return static_cast<Move>(_sub_board_indices[sub_board] / _POWERS_OF_THREE[cell] % 3);
+}
+
+Move UltimateBoard::first_player() const {
+    return _first_player;
+}
+
+Move UltimateBoard::next_player() const {
+    return _rank % 2 == 0 ? _first_player : OPPONENT_MOVE(_first_player);
+}
+
+GameState UltimateBoard::game_state() const {
+    return _game_state;
+}
+
+bool UltimateBoard::has_game_ended() const {
+    return _game_state != GameState::ONGOING;
+}
+
+GameState UltimateBoard::sub_board_state(size_t sub_board) const {
+    assert(sub_board < ULTIMATE_NUM_SUB_BOARDS);
+    return _SUB_BOARD_OUTCOMES[_sub_board_indices[sub_board]];
+}
+
+Grid UltimateBoard::sub_grid(size_t sub_board) const {
+    Grid grid;
+    for (size_t cell = 0; cell < MAX_RANK; ++cell) {
+        grid.set_value(cell / NUM_COLS, cell % NUM_COLS, value(sub_board, cell));
+    }
+    return grid;
+}
+
+size_t UltimateBoard::forced_sub_board() const {
+    return _forced_sub_boards[_rank];
+}
+
+size_t UltimateBoard::rank() const {
+    return _rank;
+}
+
+bool UltimateBoard::is_legal_move(const UltimateMove & move) const {
+    if (has_game_ended() || move.sub_board >= ULTIMATE_NUM_SUB_BOARDS || move.cell >= MAX_RANK) {
+        return false;
+    }
+    size_t forced_sub_board = _forced_sub_boards[_rank];
+    if (forced_sub_board != ULTIMATE_ANY_SUB_BOARD && forced_sub_board != move.sub_board) {
+        return false;
+    }
+    return ((_closed >> move.sub_board) & 1) == 0 && ((_occupied[move.sub_board] >> move.cell) & 1) == 0;
+}
+
+size_t UltimateBoard::generate_moves(UltimateMove moves[ULTIMATE_MAX_RANK]) const {
+    if (has_game_ended()) {
+        return 0;
+    }
+    size_t num_moves = 0;
+    size_t forced_sub_board = _forced_sub_boards[_rank];
+    size_t first_sub_board = forced_sub_board == ULTIMATE_ANY_SUB_BOARD ? 0 : forced_sub_board;
+    size_t last_sub_board = forced_sub_board == ULTIMATE_ANY_SUB_BOARD ? ULTIMATE_NUM_SUB_BOARDS : forced_sub_board + 1;
+    for (size_t sub_board = first_sub_board; sub_board < last_sub_board; ++sub_board) {
+        if ((_closed >> sub_board) & 1) {
+            continue;
+        }
+        for (uint32_t empty = ~_occupied[sub_board] & ULTIMATE_ALL_CELLS; empty != 0; empty &= empty - 1) {
+            uint8_t cell = 0;
+            while (((empty >> cell) & 1) == 0) {
+                ++cell;
+            }
+            moves[num_moves++] = UltimateMove{static_cast<uint8_t>(sub_board), cell};
+        }
+    }
+    return num_moves;
+}
+
+void UltimateBoard::make_move(const UltimateMove & move) {
+    assert(is_legal_move(move));
+    Move player = next_player();
+    _sub_board_indices[move.sub_board] += _POWERS_OF_THREE[move.cell] * static_cast<uint16_t>(player);
+    _occupied[move.sub_board] |= 1 << move.cell;
+
+    GameState sub_board_state = _SUB_BOARD_OUTCOMES[_sub_board_indices[move.sub_board]];
+    if (sub_board_state != GameState::ONGOING) {
+        _closed |= 1 << move.sub_board;
+        if (sub_board_state != GameState::DRAW) {
+            _meta_index += _POWERS_OF_THREE[move.sub_board] * static_cast<uint16_t>(player);
+        }
+        // A full meta-board of drawn and won sub-boards with no line is a draw.
+        GameState meta_state = _SUB_BOARD_OUTCOMES[_meta_index];
+        if (meta_state == GameState::CROSS_WINS || meta_state == GameState::NOUGHT_WINS) {
+            _game_state = meta_state;
+        } else if (_closed == ULTIMATE_ALL_CELLS) {
+            _game_state = GameState::DRAW;
+        }
+    }
+
+    ++_rank;
+    _forced_sub_boards[_rank] = (_closed >> move.cell) & 1 ? ULTIMATE_ANY_SUB_BOARD : move.cell;
+}
+
+void UltimateBoard::unmake_move(const UltimateMove & move) {
+    assert(_rank > 0);
+    assert(move.sub_board < ULTIMATE_NUM_SUB_BOARDS && move.cell < MAX_RANK);
+    assert((_occupied[move.sub_board] >> move.cell) & 1);
+    --_rank;
+    Move player = next_player();
+
+    // The move was legal, so its sub-board and the game were open before it.
+    if ((_closed >> move.sub_board) & 1) {
+        if (_SUB_BOARD_OUTCOMES[_sub_board_indices[move.sub_board]] != GameState::DRAW) {
+            _meta_index -= _POWERS_OF_THREE[move.sub_board] * static_cast<uint16_t>(player);
+        }
+        _closed &= ~(1 << move.sub_board);
+    }
+    _sub_board_indices[move.sub_board] -= _POWERS_OF_THREE[move.cell] * static_cast<uint16_t>(player);
+    _occupied[move.sub_board] &= ~(1 << move.cell);
+    _game_state = GameState::ONGOING;
+}
+
+uint64_t UltimateBoard::perft(size_t depth) {
+    UltimateMove moves[ULTIMATE_MAX_RANK];
+    size_t num_moves = generate_moves(moves);
+    if (depth <= 1) {
+        // Bulk counting: the leaves themselves are never made.
+        return depth == 0 ? 1 : num_moves;
+    }
+    uint64_t num_positions = 0;
+    for (size_t move_index = 0; move_index < num_moves; ++move_index) {
+        make_move(moves[move_index]);
+        num_positions += perft(depth - 1);
+        unmake_move(moves[move_index]);
+    }
+    return num_positions;
+}
+
+void UltimateBoard::print_board() const {
+    for (size_t row = 0; row < NUM_ROWS * NUM_ROWS; ++row) {
+        if (row > 0 && row % NUM_ROWS == 0) {
+            printf("------+-------+------\n");
+        }
+        for (size_t col = 0; col < NUM_COLS * NUM_COLS; ++col) {
+            if (col > 0 && col % NUM_COLS == 0) {
+                printf("| ");
+            }
+            size_t sub_board = (row / NUM_ROWS) * NUM_COLS + col / NUM_COLS;
+            size_t cell = (row % NUM_ROWS) * NUM_COLS + col % NUM_COLS;
+            Move move = value(sub_board, cell);
+            printf("%c ", move == Move::CROSS ? 'X' : move == Move::NOUGHT ? 'O' : '.');
+        }
+        printf("\n");
+    }
+    printf("Next: %s, forced sub-board: %lu, state: %s\n", STR_MOVE(next_player()), forced_sub_board(), STR_GAME_STATE(_game_state));
+}
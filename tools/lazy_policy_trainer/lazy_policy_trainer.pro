@@ -0,0 +1,24 @@
+#-------------------------------------------------
+#
+# Match box self-play on 4x4x4 Qubic with a memory-capped LazyPolicyStore
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+CONFIG += console thread c++17
+CONFIG -= app_bundle
+
+TARGET = lazy_policy_trainer
+TEMPLATE = app
+
+OBJECTS_DIR = .obj
+
+SOURCES += \
+        main.cpp \
+        ../../src/lazy_policy_store.cpp \
+        ../../src/qubic_board.cpp \
+        ../../src/qubic_symmetry.cpp \
+        ../../src/task_scheduler.cpp
+
+INCLUDEPATH = ../../include
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+#include "constants.h"
+#include "lazy_policy_store.h"
+#include "match_box.h"
+#include "qubic_board.h"
+#include "qubic_symmetry.h"
+#include "task_scheduler.h"
+
+// Games handed to one worker task.
+#define TRAINER_GRAIN_SIZE (64)
+
+static void _print_usage(const char * program_name) {
+    printf("Usage: %s [--games <num_games>] [--rounds <num_rounds>] [--eval <num_games>] [--threads <num_threads>] [--memory <MiB>] [--spill <file>]\n", program_name);
+}
+
+static uint32_t _thread_random() {
+    static thread_local uint32_t random_state = static_cast<uint32_t>(
+        std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+// One move of a game, in the canonical frame of its position.
+struct TrainerMove {
+    uint64_t key;
+    uint64_t empty_cells;
+    uint8_t cell;
+    Move side;
+};
+
+// Samples a move from the box of the position, mapped back onto the board.
+static bool _policy_move(LazyPolicyStore & store, const QubicBoard & board, TrainerMove & trainer_move, QubicMove & move) {
+    QubicTransformation qubic_transformation = QUBIC_TRANSFORMATION_EQUAL;
+    // UINT64_MAX marks empty slots; sharing a box with its neighbour is harmless.
+    trainer_move.key = std::min<uint64_t>(board.canonical_hash(qubic_transformation), UINT64_MAX - 1);
+    trainer_move.empty_cells = transform_qubic_cells(board.empty_cells(), qubic_transformation);
+    trainer_move.side = board.next_player();
+    int8_t seeds[QUBIC_NUM_CELLS];
+    if (!store.get_seeds(trainer_move.key, trainer_move.empty_cells, seeds)) {
+        return false;
+    }
+    uint32_t num_seeds = 0;
+    for (size_t cell = 0; cell < QUBIC_NUM_CELLS; ++cell) {
+        num_seeds += static_cast<uint32_t>(std::max<int8_t>(seeds[cell], 0));
+    }
+    uint32_t seed = _thread_random() % num_seeds;
+    size_t cell = 0;
+    while (seed >= static_cast<uint32_t>(std::max<int8_t>(seeds[cell], 0))) {
+        seed -= static_cast<uint32_t>(std::max<int8_t>(seeds[cell], 0));
+        ++cell;
+    }
+    trainer_move.cell = static_cast<uint8_t>(cell);
+    move.cell = QUBIC_SYMMETRY_TABLE.sources[qubic_transformation][cell];
+    return true;
+}
+
+static QubicMove _random_move(const QubicBoard & board) {
+    uint64_t empty_cells = board.empty_cells();
+    size_t index = _thread_random() % static_cast<uint32_t>(__builtin_popcountll(empty_cells));
+    for (; index > 0; --index) {
+        empty_cells &= empty_cells - 1;
+    }
+    return QubicMove{static_cast<uint8_t>(__builtin_ctzll(empty_cells))};
+}
+
+static bool _play_self_play_game(LazyPolicyStore & store) {
+    QubicBoard board;
+    std::vector<TrainerMove> trainer_moves;
+    while (!board.has_game_ended()) {
+        TrainerMove trainer_move;
+        QubicMove move;
+        if (!_policy_move(store, board, trainer_move, move)) {
+            return false;
+        }
+        trainer_moves.push_back(trainer_move);
+        board.make_move(move);
+    }
+
+    GameState game_state = board.game_state();
+    Move winner = game_state == GameState::CROSS_WINS ? Move::CROSS : game_state == GameState::NOUGHT_WINS ? Move::NOUGHT : Move::EMPTY;
+    for (const TrainerMove & trainer_move : trainer_moves) {
+        int32_t rewards = 0, punishments = 0;
+        if (winner == Move::EMPTY) {
+            rewards = MATCH_BOX_DRAW_REWARD;
+        } else if (trainer_move.side == winner) {
+            rewards = MATCH_BOX_WIN_REWARD;
+        } else {
+            punishments = MATCH_BOX_LOSS_PENALTY;
+        }
+        if (!store.apply_seed_delta(trainer_move.key, trainer_move.empty_cells, trainer_move.cell, rewards, punishments)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The policy plays CROSS against uniformly random NOUGHT moves.
+static bool _play_evaluation_game(LazyPolicyStore & store, GameState & game_state) {
+    QubicBoard board;
+    while (!board.has_game_ended()) {
+        QubicMove move;
+        if (board.next_player() == Move::CROSS) {
+            TrainerMove trainer_move;
+            if (!_policy_move(store, board, trainer_move, move)) {
+                return false;
+            }
+        } else {
+            move = _random_move(board);
+        }
+        board.make_move(move);
+    }
+    game_state = board.game_state();
+    return true;
+}
+
+static void _print_statistics(const LazyPolicyStore & store) {
+    LazyPolicyStatistics statistics = store.get_statistics();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("  boxes %lu (table %.1f MiB), resident %lu (%.1f MiB), spilled %lu, evictions %lu, reloads %lu, peak RSS %.1f MiB\n",
+        statistics.num_boxes, statistics.table_bytes / 1048576.0, statistics.num_resident_boxes, statistics.resident_bytes / 1048576.0,
+        statistics.num_spilled_boxes, statistics.num_evictions, statistics.num_reloads, usage.ru_maxrss / 1024.0);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t num_games = 20000;
+    size_t num_rounds = 5;
+    size_t num_evaluation_games = 1000;
+    size_t num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    size_t memory_limit_mib = 16;
+    std::string spill_filename = "lazy_policy.spill";
+
+    for (int arg_index = 1; arg_index < argc; ++arg_index) {
+        bool has_value = arg_index + 1 < argc;
+        if (strcmp(argv[arg_index], "--games") == 0 && has_value) {
+            num_games = strtoull(argv[++arg_index], nullptr, 10);
+        } else if (strcmp(argv[arg_index], "--rounds") == 0 && has_value) {
+            num_rounds = strtoull(argv[++arg_index], nullptr, 10);
+        } else if (strcmp(argv[arg_index], "--eval") == 0 && has_value) {
+            num_evaluation_games = strtoull(argv[++arg_index], nullptr, 10);
+        } else if (strcmp(argv[arg_index], "--threads") == 0 && has_value && atoi(argv[arg_index + 1]) > 0) {
+            num_threads = static_cast<size_t>(atoi(argv[++arg_index]));
+        } else if (strcmp(argv[arg_index], "--memory") == 0 && has_value && atoi(argv[arg_index + 1]) > 0) {
+            memory_limit_mib = static_cast<size_t>(atoi(argv[++arg_index]));
+        } else if (strcmp(argv[arg_index], "--spill") == 0 && has_value) {
+            spill_filename = argv[++arg_index];
+        } else {
+            _print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    LazyPolicyStore store(QUBIC_NUM_CELLS, memory_limit_mib * 1048576);
+    if (!store.open_spill_file(spill_filename)) {
+        return 1;
+    }
+    TaskScheduler scheduler(num_threads);
+    printf("Qubic self-play: %lu rounds of %lu games, %lu threads, %lu MiB of seeds\n",
+        num_rounds, num_games, num_threads, memory_limit_mib);
+
+    for (size_t round = 0; round < num_rounds; ++round) {
+        std::atomic<bool> failed(false);
+        auto start_time = std::chrono::steady_clock::now();
+        scheduler.parallel_for(0, num_games, TRAINER_GRAIN_SIZE, [&](size_t begin, size_t end) {
+            for (size_t game_index = begin; game_index < end && !failed.load(std::memory_order_relaxed); ++game_index) {
+                if (!_play_self_play_game(store)) {
+                    failed.store(true);
+                }
+            }
+        });
+        if (failed.load()) {
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        printf("Round %lu: %lu games in %.3f s, %.0f games/sec\n", round + 1, num_games, seconds, num_games / seconds);
+        _print_statistics(store);
+    }
+
+    size_t num_wins = 0, num_losses = 0, num_draws = 0;
+    for (size_t game_index = 0; game_index < num_evaluation_games; ++game_index) {
+        GameState game_state = GameState::ONGOING;
+        if (!_play_evaluation_game(store, game_state)) {
+            return 1;
+        }
+        num_wins += game_state == GameState::CROSS_WINS ? 1 : 0;
+        num_losses += game_state == GameState::NOUGHT_WINS ? 1 : 0;
+        num_draws += game_state == GameState::DRAW ? 1 : 0;
+    }
+    printf("Policy as CROSS against random moves: wins %lu, losses %lu, draws %lu\n", num_wins, num_losses, num_draws);
+    _print_statistics(store);
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "constants.h"
+#include "game_bot.h"
+#include "grid.h"
+#include "ntuple_network.h"
+#include "task_scheduler.h"
+
+static void _print_usage(const char * program_name) {
+    printf("Usage: %s [--games <num_games>] [--eval <num_games>] [--threads <num_threads>] [--rate <learning rate>] [--save <network file>] [--load <network file>]\n", program_name);
+}
+
+static uint32_t _random() {
+    static uint32_t random_state = 2463534242u;
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+static MovePosition _random_move(const Grid & grid) {
+    std::vector<MovePosition> positions = grid.valid_move_positions();
+    return positions.at(_random() % positions.size());
+}
+
+// Greedy network moves for network_move, random ones for the other side.
+static GameState _play_against_random(const NTupleNetwork & network, Move first_player_move, Move network_move) {
+    Grid grid(first_player_move);
+    while (!grid.has_game_ended()) {
+        MovePosition position;
+        if (grid.next_player() != network_move || !network.select_move(grid, position)) {
+            position = _random_move(grid);
+        }
+        grid.set_value(static_cast<int8_t>(position.first), static_cast<int8_t>(position.second));
+    }
+    return grid.game_state();
+}
+
+static void _evaluate_against_random(const NTupleNetwork & network, size_t num_games) {
+    for (Move network_move : {Move::CROSS, Move::NOUGHT}) {
+        size_t num_wins = 0, num_losses = 0, num_draws = 0;
+        for (size_t game_index = 0; game_index < num_games; ++game_index) {
+            Move first_player_move = game_index % 2 == 0 ? Move::CROSS : Move::NOUGHT;
+            GameState game_state = _play_against_random(network, first_player_move, network_move);
+            if (game_state == GameState::DRAW) {
+                ++num_draws;
+            } else if ((game_state == GameState::CROSS_WINS) == (network_move == Move::CROSS)) {
+                ++num_wins;
+            } else {
+                ++num_losses;
+            }
+        }
+        printf("Network as %s against random moves: wins %lu, losses %lu, draws %lu\n", STR_MOVE(network_move), num_wins, num_losses, num_draws);
+    }
+}
+
+// Positions/sec of evaluate_batch() and of the scalar loops on random
+// mid-game grids, and the largest difference between the two.
+static void _benchmark_evaluation(const NTupleNetwork & network) {
+    std::vector<Grid> grids;
+    std::vector<Move> players;
+    while (grids.size() < 4096) {
+        Grid grid;
+        size_t num_moves = _random() % MAX_RANK;
+        for (size_t move_index = 0; move_index < num_moves && !grid.has_game_ended(); ++move_index) {
+            MovePosition position = _random_move(grid);
+            grid.set_value(static_cast<int8_t>(position.first), static_cast<int8_t>(position.second));
+        }
+        grids.push_back(grid);
+        players.push_back(_random() % 2 == 0 ? Move::CROSS : Move::NOUGHT);
+    }
+    std::vector<float> values(grids.size()), scalar_values(grids.size());
+
+    const size_t num_repeats = 200;
+    auto start_time = std::chrono::steady_clock::now();
+    for (size_t repeat = 0; repeat < num_repeats; ++repeat) {
+        network.evaluate_batch(grids.data(), players.data(), values.data(), grids.size());
+    }
+    double batch_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    start_time = std::chrono::steady_clock::now();
+    for (size_t repeat = 0; repeat < num_repeats; ++repeat) {
+        network.evaluate_batch_scalar(grids.data(), players.data(), scalar_values.data(), grids.size());
+    }
+    double scalar_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    float max_difference = 0.0f;
+    for (size_t grid_index = 0; grid_index < grids.size(); ++grid_index) {
+        max_difference = std::max(max_difference, std::fabs(values[grid_index] - scalar_values[grid_index]));
+    }
+    double num_evaluations = static_cast<double>(grids.size() * num_repeats);
+    printf("evaluate_batch(): %.1f M positions/sec, scalar: %.1f M positions/sec, max difference %g\n",
+        num_evaluations / batch_seconds / 1e6, num_evaluations / scalar_seconds / 1e6, max_difference);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t num_games = 200000;
+    size_t num_evaluation_games = 2000;
+    size_t num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    float learning_rate = NTUPLE_DEFAULT_LEARNING_RATE;
+    std::string save_filename, load_filename;
+
+    for (int arg_index = 1; arg_index < argc; ++arg_index) {
+        bool has_value = arg_index + 1 < argc;
+        if (strcmp(argv[arg_index], "--games") == 0 && has_value) {
+            num_games = strtoull(argv[++arg_index], nullptr, 10);
+        } else if (strcmp(argv[arg_index], "--eval") == 0 && has_value) {
+            num_evaluation_games = strtoull(argv[++arg_index], nullptr, 10);
+        } else if (strcmp(argv[arg_index], "--threads") == 0 && has_value && atoi(argv[arg_index + 1]) > 0) {
+            num_threads = static_cast<size_t>(atoi(argv[++arg_index]));
+        } else if (strcmp(argv[arg_index], "--rate") == 0 && has_value && atof(argv[arg_index + 1]) > 0) {
+            learning_rate = static_cast<float>(atof(argv[++arg_index]));
+        } else if (strcmp(argv[arg_index], "--save") == 0 && has_value) {
+            save_filename = argv[++arg_index];
+        } else if (strcmp(argv[arg_index], "--load") == 0 && has_value) {
+            load_filename = argv[++arg_index];
+        } else {
+            _print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    NTupleNetwork network;
+    network.set_learning_rate(learning_rate);
+    if (!load_filename.empty() && !network.load(load_filename)) {
+        return 1;
+    }
+    printf("%lu tuples, %lu weights\n", network.num_tuples(), network.num_weights());
+    _evaluate_against_random(network, num_evaluation_games);
+
+    // The match boxes play both sides; every finished game also trains the
+    // network through finish_game().
+    if (num_games > 0) {
+        GameBot game_bot;
+        game_bot.attach_ntuple_network(&network);
+        TaskScheduler scheduler(num_threads);
+        auto start_time = std::chrono::steady_clock::now();
+        game_bot.train_self_play(num_games, scheduler);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        game_bot.attach_ntuple_network(nullptr);
+        printf("Trained on %lu self-play games in %.3f s, %.0f games/sec\n", num_games, seconds, num_games / seconds);
+        _evaluate_against_random(network, num_evaluation_games);
+    }
+
+    _benchmark_evaluation(network);
+    if (!save_filename.empty() && !network.save(save_filename)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "game_bot.h"
+#include "task_scheduler.h"
+
+static void _print_usage(const char * program_name) {
+    printf("Usage: %s <output header> [--policy <policy file>] [--train <num_games>] [--threads <num_threads>] [--moves-only]\n", program_name);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        _print_usage(argv[0]);
+        return 1;
+    }
+
+    std::string header_filename = argv[1];
+    std::string policy_filename;
+    size_t num_training_games = 0;
+    size_t num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    bool export_seeds = true;
+    for (int arg_index = 2; arg_index < argc; ++arg_index) {
+        bool has_value = arg_index + 1 < argc;
+        if (strcmp(argv[arg_index], "--policy") == 0 && has_value) {
+            policy_filename = argv[++arg_index];
+        } else if (strcmp(argv[arg_index], "--train") == 0 && has_value) {
+            num_training_games = static_cast<size_t>(strtoull(argv[++arg_index], nullptr, 10));
+        } else if (strcmp(argv[arg_index], "--threads") == 0 && has_value && atoi(argv[arg_index + 1]) > 0) {
+            num_threads = static_cast<size_t>(atoi(argv[++arg_index]));
+        } else if (strcmp(argv[arg_index], "--moves-only") == 0) {
+            export_seeds = false;
+        } else {
+            _print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    GameBot game_bot;
+    if (!policy_filename.empty() && !game_bot.load_policy(policy_filename)) {
+        return 1;
+    }
+    if (num_training_games > 0) {
+        TaskScheduler scheduler(num_threads);
+        game_bot.train_self_play(num_training_games, scheduler);
+    }
+    if (!game_bot.export_policy_header(header_filename, export_seeds)) {
+        return 1;
+    }
+    printf("Wrote %s\n", header_filename.c_str());
+    return 0;
+}
@@ -0,0 +1,492 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "constants.h"
+#include "game_bot.h"
+#include "grid.h"
+#include "grid_symmetry.h"
+#include "tablebase.h"
+#include "task_scheduler.h"
+
+// Input is read and handed to the workers in blocks of this many bytes.
+#define ANALYZER_BLOCK_SIZE (1 << 20)
+// Blocks read but not yet written, per worker.
+#define ANALYZER_BLOCKS_IN_FLIGHT_PER_WORKER (4)
+// Binary records: grid_index() in the low 15 bits, the top bit set when the
+// game was started by the player other than DEFAULT_FIRST_PLAYER_MOVE.
+#define ANALYZER_RECORD_SIZE (2)
+#define ANALYZER_OTHER_FIRST_PLAYER_BIT (0x8000u)
+
+static_assert(MAX_RANK <= 9, "binary records hold a 3x3 grid_index()");
+
+static void _print_usage(const char * program_name) {
+    printf("Usage: %s [--binary] [--threads <num_threads>] [--policy <policy file>] [--tablebase <file> | --solve] [--output <file>] [<input file> | -]\n", program_name);
+    printf("       %s --generate <num_positions> [--binary] [--output <file>]\n", program_name);
+    printf("Text input has one position per line: %d cells of '.', 'X' or 'O', row by row,\n", MAX_RANK);
+    printf("optionally followed by the first player; otherwise it is inferred from the mark counts.\n");
+}
+
+// One output line per distinct position, built the first time the position
+// is seen and shared by every later occurrence. The whole 3x3 space is
+// 2 * 3^9 keys, so the table is fixed and needs no locking beyond a state
+// byte per entry.
+class AnalysisCache
+{
+public:
+    AnalysisCache(GameBot & game_bot, const Tablebase & tablebase) :
+        _game_bot(game_bot),
+        _tablebase(tablebase),
+        _num_grid_indices(_count_grid_indices()),
+        _lines(2 * _num_grid_indices),
+        _states(new std::atomic<uint8_t>[2 * _num_grid_indices]),
+        _num_analyzed(0)
+    {
+        for (size_t key = 0; key < 2 * _num_grid_indices; ++key) {
+            _states[key].store(EMPTY, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t num_grid_indices() const {
+        return _num_grid_indices;
+    }
+
+    uint64_t num_analyzed() const {
+        return _num_analyzed.load();
+    }
+
+    const std::string & line(uint64_t grid_index, bool other_first_player) {
+        uint64_t key = grid_index * 2 + (other_first_player ? 1 : 0);
+        uint8_t state = _states[key].load(std::memory_order_acquire);
+        if (state == READY) {
+            return _lines[key];
+        }
+        uint8_t expected = EMPTY;
+        if (state == EMPTY && _states[key].compare_exchange_strong(expected, BUSY, std::memory_order_acquire)) {
+            _lines[key] = _analyze(grid_index, other_first_player);
+            _num_analyzed.fetch_add(1, std::memory_order_relaxed);
+            _states[key].store(READY, std::memory_order_release);
+            return _lines[key];
+        }
+        while (_states[key].load(std::memory_order_acquire) != READY) {
+            std::this_thread::yield();
+        }
+        return _lines[key];
+    }
+private:
+    enum : uint8_t { EMPTY = 0, BUSY = 1, READY = 2 };
+
+    static uint64_t _count_grid_indices() {
+        uint64_t num_grid_indices = 1;
+        for (size_t cell = 0; cell < MAX_RANK; ++cell) {
+            num_grid_indices *= 3;
+        }
+        return num_grid_indices;
+    }
+
+    std::string _analyze(uint64_t grid_index, bool other_first_player) {
+        Move first_player_move = other_first_player ? OPPONENT_MOVE(DEFAULT_FIRST_PLAYER_MOVE) : DEFAULT_FIRST_PLAYER_MOVE;
+        Grid grid(first_player_move);
+        Grid cells = grid_from_index(grid_index);
+        size_t num_first = 0, num_second = 0;
+        std::string line;
+        for (int8_t row = 0; row < NUM_ROWS; ++row) {
+            for (int8_t col = 0; col < NUM_COLS; ++col) {
+                Move move = cells.value(row, col);
+                grid.set_value(row, col, move);
+                line += STR_MOVE_SYMBOL(move);
+                num_first += move == first_player_move ? 1 : 0;
+                num_second += move == OPPONENT_MOVE(first_player_move) ? 1 : 0;
+            }
+        }
+        line += ' ';
+        line += STR_MOVE_SYMBOL(first_player_move);
+
+        GameState game_state = grid.game_state();
+        if ((num_first != num_second && num_first != num_second + 1) || game_state == GameState::INVALID) {
+            return line + " invalid\n";
+        }
+        if (game_state != GameState::ONGOING) {
+            return line + " ended=" + STR_GAME_STATE(game_state) + "\n";
+        }
+
+        char buffer[64];
+        float priors[NUM_ROWS][NUM_COLS];
+        bool has_policy = _game_bot.get_move_priors(grid, priors);
+        MovePosition best_position(NUM_ROWS, NUM_COLS);
+        TablebaseResult result = TablebaseResult::UNKNOWN;
+        uint8_t distance = 0;
+        bool solved = _tablebase.probe(grid, result, distance) && _tablebase.get_best_move(grid, best_position);
+        if (!solved && has_policy) {
+            // Without the solver the most likely policy move is the best.
+            float best_prior = -1.0f;
+            for (size_t row = 0; row < NUM_ROWS; ++row) {
+                for (size_t col = 0; col < NUM_COLS; ++col) {
+                    if (priors[row][col] > best_prior) {
+                        best_prior = priors[row][col];
+                        best_position = MovePosition(row, col);
+                    }
+                }
+            }
+        }
+        if (best_position.first < NUM_ROWS) {
+            snprintf(buffer, sizeof(buffer), " best=%lu,%lu", best_position.first, best_position.second);
+            line += buffer;
+        } else {
+            line += " best=-";
+        }
+        line += " policy=";
+        for (size_t cell = 0; cell < MAX_RANK; ++cell) {
+            if (!has_policy) {
+                line += '-';
+                break;
+            }
+            snprintf(buffer, sizeof(buffer), cell == 0 ? "%.3f" : ",%.3f", priors[cell / NUM_COLS][cell % NUM_COLS]);
+            line += buffer;
+        }
+        if (solved) {
+            snprintf(buffer, sizeof(buffer), " value=%s distance=%u", STR_TABLEBASE_RESULT(result), distance);
+            line += buffer;
+        }
+        return line + "\n";
+    }
+
+    GameBot & _game_bot;
+    const Tablebase & _tablebase;
+    uint64_t _num_grid_indices;
+    std::vector<std::string> _lines;
+    std::unique_ptr<std::atomic<uint8_t>[]> _states;
+    std::atomic<uint64_t> _num_analyzed;
+};
+
+// Hands finished blocks to the writer thread in input order, however the
+// workers finish them, and holds the reader back while too many are out.
+class ReorderBuffer
+{
+public:
+    ReorderBuffer(FILE * output, size_t max_in_flight) :
+        _output(output),
+        _max_in_flight(max_in_flight),
+        _num_submitted(0),
+        _num_written(0),
+        _closed(false),
+        _writer([this]() { _write_blocks(); })
+    {
+
+    }
+
+    ~ReorderBuffer() {
+        close();
+    }
+
+    uint64_t next_sequence() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this]() { return _num_submitted - _num_written < _max_in_flight; });
+        return _num_submitted++;
+    }
+
+    void finish(uint64_t sequence, std::string && text) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _finished[sequence] = std::move(text);
+        _condition.notify_all();
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _closed = true;
+            _condition.notify_all();
+        }
+        if (_writer.joinable()) {
+            _writer.join();
+        }
+        fflush(_output);
+    }
+private:
+    void _write_blocks() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true) {
+            _condition.wait(lock, [this]() {
+                return _finished.count(_num_written) > 0 || (_closed && _num_written == _num_submitted);
+            });
+            if (_finished.count(_num_written) == 0) {
+                return;
+            }
+            std::string text = std::move(_finished[_num_written]);
+            _finished.erase(_num_written);
+            // Written without the lock, so workers keep finishing blocks.
+            lock.unlock();
+            fwrite(text.data(), 1, text.size(), _output);
+            lock.lock();
+            ++_num_written;
+            _condition.notify_all();
+        }
+    }
+
+    FILE * _output;
+    size_t _max_in_flight;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::map<uint64_t, std::string> _finished;
+    uint64_t _num_submitted;
+    uint64_t _num_written;
+    bool _closed;
+    std::thread _writer;
+};
+
+static bool _parse_text_line(const char * begin, const char * end, uint64_t & grid_index, bool & other_first_player) {
+    if (end - begin < MAX_RANK) {
+        return false;
+    }
+    size_t num_crosses = 0, num_noughts = 0;
+    grid_index = 0;
+    for (size_t cell = MAX_RANK; cell-- > 0;) {
+        char symbol = begin[cell];
+        Move move = symbol == 'X' ? Move::CROSS : symbol == 'O' ? Move::NOUGHT : Move::EMPTY;
+        if (move == Move::EMPTY && symbol != '.') {
+            return false;
+        }
+        num_crosses += move == Move::CROSS ? 1 : 0;
+        num_noughts += move == Move::NOUGHT ? 1 : 0;
+        grid_index = grid_index * 3 + static_cast<uint64_t>(move);
+    }
+    const char * rest = begin + MAX_RANK;
+    while (rest < end && (*rest == ' ' || *rest == '\t')) {
+        ++rest;
+    }
+    Move first_player_move = DEFAULT_FIRST_PLAYER_MOVE;
+    if (rest < end && (*rest == 'X' || *rest == 'O')) {
+        first_player_move = *rest == 'X' ? Move::CROSS : Move::NOUGHT;
+        ++rest;
+    } else if (num_crosses != num_noughts) {
+        first_player_move = num_crosses > num_noughts ? Move::CROSS : Move::NOUGHT;
+    }
+    while (rest < end && (*rest == ' ' || *rest == '\t')) {
+        ++rest;
+    }
+    other_first_player = first_player_move != DEFAULT_FIRST_PLAYER_MOVE;
+    return rest == end;
+}
+
+static size_t _analyze_text_block(AnalysisCache & cache, const std::vector<char> & block, std::string & text) {
+    size_t num_positions = 0;
+    const char * line_begin = block.data();
+    const char * block_end = block.data() + block.size();
+    while (line_begin < block_end) {
+        const char * line_end = static_cast<const char *>(memchr(line_begin, '\n', block_end - line_begin));
+        const char * next_line = line_end == nullptr ? block_end : line_end + 1;
+        line_end = line_end == nullptr ? block_end : line_end;
+        if (line_end > line_begin && line_end[-1] == '\r') {
+            --line_end;
+        }
+        if (line_end > line_begin) {
+            uint64_t grid_index = 0;
+            bool other_first_player = false;
+            if (_parse_text_line(line_begin, line_end, grid_index, other_first_player)) {
+                text += cache.line(grid_index, other_first_player);
+            } else {
+                text.append(line_begin, line_end);
+                text += " unparsed\n";
+            }
+            ++num_positions;
+        }
+        line_begin = next_line;
+    }
+    return num_positions;
+}
+
+static size_t _analyze_binary_block(AnalysisCache & cache, const std::vector<char> & block, std::string & text) {
+    size_t num_positions = block.size() / ANALYZER_RECORD_SIZE;
+    for (size_t record = 0; record < num_positions; ++record) {
+        const unsigned char * bytes = reinterpret_cast<const unsigned char *>(block.data()) + record * ANALYZER_RECORD_SIZE;
+        uint32_t value = bytes[0] | (static_cast<uint32_t>(bytes[1]) << 8);
+        uint64_t grid_index = value & ~ANALYZER_OTHER_FIRST_PLAYER_BIT;
+        if (grid_index >= cache.num_grid_indices()) {
+            text += "unparsed\n";
+            continue;
+        }
+        text += cache.line(grid_index, (value & ANALYZER_OTHER_FIRST_PLAYER_BIT) != 0);
+    }
+    return num_positions;
+}
+
+static int _generate(uint64_t num_positions, bool binary, FILE * output) {
+    // Random legal positions: a random number of random moves.
+    uint32_t random_state = 2463534242u;
+    std::string text;
+    for (uint64_t position_index = 0; position_index < num_positions; ++position_index) {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 17;
+        random_state ^= random_state << 5;
+        Move first_player_move = random_state & 1 ? Move::CROSS : Move::NOUGHT;
+        Grid grid(first_player_move);
+        size_t num_moves = (random_state >> 1) % MAX_RANK;
+        for (size_t move_index = 0; move_index < num_moves && !grid.has_game_ended(); ++move_index) {
+            std::vector<MovePosition> positions = grid.valid_move_positions();
+            random_state ^= random_state << 13;
+            random_state ^= random_state >> 17;
+            random_state ^= random_state << 5;
+            MovePosition position = positions[random_state % positions.size()];
+            grid.set_value(static_cast<int8_t>(position.first), static_cast<int8_t>(position.second));
+        }
+        bool other_first_player = first_player_move != DEFAULT_FIRST_PLAYER_MOVE;
+        if (binary) {
+            uint32_t value = static_cast<uint32_t>(grid_index(grid)) | (other_first_player ? ANALYZER_OTHER_FIRST_PLAYER_BIT : 0);
+            text += static_cast<char>(value & 0xFF);
+            text += static_cast<char>(value >> 8);
+        } else {
+            for (int8_t row = 0; row < NUM_ROWS; ++row) {
+                for (int8_t col = 0; col < NUM_COLS; ++col) {
+                    text += STR_MOVE_SYMBOL(grid.value(row, col));
+                }
+            }
+            text += ' ';
+            text += STR_MOVE_SYMBOL(first_player_move);
+            text += '\n';
+        }
+        if (text.size() >= ANALYZER_BLOCK_SIZE) {
+            fwrite(text.data(), 1, text.size(), output);
+            text.clear();
+        }
+    }
+    fwrite(text.data(), 1, text.size(), output);
+    return fflush(output) == 0 ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    bool binary = false;
+    bool solve = false;
+    uint64_t num_generated_positions = 0;
+    size_t num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::string policy_filename, tablebase_filename, input_filename = "-", output_filename;
+
+    for (int arg_index = 1; arg_index < argc; ++arg_index) {
+        bool has_value = arg_index + 1 < argc;
+        if (strcmp(argv[arg_index], "--binary") == 0) {
+            binary = true;
+        } else if (strcmp(argv[arg_index], "--solve") == 0) {
+            solve = true;
+        } else if (strcmp(argv[arg_index], "--generate") == 0 && has_value) {
+            num_generated_positions = strtoull(argv[++arg_index], nullptr, 10);
+        } else if (strcmp(argv[arg_index], "--threads") == 0 && has_value && atoi(argv[arg_index + 1]) > 0) {
+            num_threads = static_cast<size_t>(atoi(argv[++arg_index]));
+        } else if (strcmp(argv[arg_index], "--policy") == 0 && has_value) {
+            policy_filename = argv[++arg_index];
+        } else if (strcmp(argv[arg_index], "--tablebase") == 0 && has_value) {
+            tablebase_filename = argv[++arg_index];
+        } else if (strcmp(argv[arg_index], "--output") == 0 && has_value) {
+            output_filename = argv[++arg_index];
+        } else if (argv[arg_index][0] != '-' || strcmp(argv[arg_index], "-") == 0) {
+            input_filename = argv[arg_index];
+        } else {
+            _print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Results go to stdout, so progress and timings go to stderr.
+    FILE * output = output_filename.empty() ? stdout : fopen(output_filename.c_str(), "wb");
+    if (output == nullptr) {
+        fprintf(stderr, "Cannot open output file = %s\n", output_filename.c_str());
+        return 1;
+    }
+    if (num_generated_positions > 0) {
+        int status = _generate(num_generated_positions, binary, output);
+        if (output != stdout) {
+            fclose(output);
+        }
+        return status;
+    }
+    FILE * input = input_filename == "-" ? stdin : fopen(input_filename.c_str(), "rb");
+    if (input == nullptr) {
+        fprintf(stderr, "Cannot open input file = %s\n", input_filename.c_str());
+        return 1;
+    }
+
+    // GameBot and Tablebase report on stdout, which may be the results.
+    fflush(stdout);
+    int stdout_descriptor = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+    TaskScheduler scheduler(num_threads);
+    GameBot game_bot;
+    if (!policy_filename.empty() && !game_bot.load_policy(policy_filename)) {
+        return 1;
+    }
+    Tablebase tablebase;
+    if (!tablebase_filename.empty() && !tablebase.load(tablebase_filename)) {
+        return 1;
+    } else if (tablebase_filename.empty() && solve) {
+        tablebase.generate(scheduler);
+    }
+    fflush(stdout);
+    dup2(stdout_descriptor, STDOUT_FILENO);
+    close(stdout_descriptor);
+
+    AnalysisCache cache(game_bot, tablebase);
+    std::atomic<uint64_t> num_positions(0);
+    auto start_time = std::chrono::steady_clock::now();
+    {
+        ReorderBuffer reorder_buffer(output, ANALYZER_BLOCKS_IN_FLIGHT_PER_WORKER * num_threads);
+        TaskGroup task_group(scheduler);
+        // Text blocks end on a line break; the tail of a read moves on to the
+        // next block. Binary blocks end on a whole record.
+        std::vector<char> carry;
+        std::vector<char> buffer(ANALYZER_BLOCK_SIZE);
+        while (true) {
+            size_t num_read = fread(buffer.data(), 1, buffer.size(), input);
+            bool at_end = num_read < buffer.size();
+            std::shared_ptr<std::vector<char>> block = std::make_shared<std::vector<char>>(std::move(carry));
+            block->insert(block->end(), buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(num_read));
+            carry.clear();
+            if (!at_end) {
+                size_t block_size = block->size();
+                if (binary) {
+                    block_size -= block_size % ANALYZER_RECORD_SIZE;
+                } else {
+                    while (block_size > 0 && (*block)[block_size - 1] != '\n') {
+                        --block_size;
+                    }
+                }
+                carry.assign(block->begin() + static_cast<std::ptrdiff_t>(block_size), block->end());
+                block->resize(block_size);
+            }
+            if (!block->empty()) {
+                uint64_t sequence = reorder_buffer.next_sequence();
+                task_group.run([&cache, &reorder_buffer, &num_positions, block, sequence, binary]() {
+                    std::string text;
+                    text.reserve(block->size() * 8);
+                    size_t num_block_positions = binary ? _analyze_binary_block(cache, *block, text) : _analyze_text_block(cache, *block, text);
+                    num_positions.fetch_add(num_block_positions, std::memory_order_relaxed);
+                    reorder_buffer.finish(sequence, std::move(text));
+                });
+            }
+            if (at_end) {
+                break;
+            }
+        }
+        task_group.wait();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    if (input != stdin) {
+        fclose(input);
+    }
+    if (output != stdout) {
+        fclose(output);
+    }
+    fprintf(stderr, "Analyzed %lu positions (%lu distinct) in %.3f s, %.2f M positions/sec, %lu threads\n",
+        num_positions.load(), cache.num_analyzed(), seconds, num_positions.load() / seconds / 1e6, num_threads);
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "constants.h"
+#include "grid.h"
+#include "lazy_smp_search.h"
+#include "qubic_board.h"
+#include "task_scheduler.h"
+
+#define TABLE_SIZE_LOG2 (20)
+#define SEARCH_BUDGET_SECONDS (60)
+
+static void _print_move(const MovePosition & position) {
+    printf("(%lu, %lu)", position.first, position.second);
+}
+
+static void _print_move(const QubicMove & move) {
+    printf("(%d)", move.cell);
+}
+
+static void _print_position(const Grid & grid) {
+    grid.print_grid();
+}
+
+static void _print_position(const QubicBoard & board) {
+    board.print_board();
+}
+
+template <typename Board, typename Position>
+static void _run_benchmark(const Board & board) {
+    _print_position(board);
+
+    size_t max_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    size_t num_runs = 10;
+
+    printf("%8s %14s %10s %14s %12s %s\n", "threads", "nodes", "depth", "nodes/sec", "solve_ms", "move");
+    for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        // The calling thread searches too, so it needs one worker less.
+        TaskScheduler scheduler(num_threads > 1 ? num_threads - 1 : 1);
+        LazySmpSearch search(num_threads, TABLE_SIZE_LOG2, scheduler);
+        uint64_t total_nodes = 0;
+        double total_seconds = 0.0;
+        Position best_position;
+        SearchStatistics statistics;
+
+        for (size_t run = 0; run < num_runs; ++run) {
+            search.clear();
+            auto start = std::chrono::steady_clock::now();
+            search.search(board, std::chrono::seconds(SEARCH_BUDGET_SECONDS), best_position);
+            auto end = std::chrono::steady_clock::now();
+
+            statistics = search.get_statistics();
+            total_nodes += statistics.nodes_searched;
+            total_seconds += std::chrono::duration<double>(end - start).count();
+        }
+        printf("%8lu %14lu %10lu %14.0f %12.3f ", num_threads, total_nodes / num_runs,
+               statistics.depth_reached, total_nodes / total_seconds, 1000.0 * total_seconds / num_runs);
+        _print_move(best_position);
+        printf("%s\n", statistics.solved ? "" : " unsolved");
+        fflush(stdout);
+    }
+}
+
+// Solves the empty board (and any prefix given on the command line as
+// row/col pairs) with 1, 2, 4, ... threads and reports nodes/sec and the
+// time it takes to solve the position. With --qubic the prefix is a list of
+// 4x4x4 cells x + 4 * y + 16 * z instead.
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "--qubic") == 0) {
+        QubicBoard board;
+        for (int arg_index = 2; arg_index < argc; ++arg_index) {
+            QubicMove move = {static_cast<uint8_t>(std::atoi(argv[arg_index]))};
+            if (!board.is_legal_move(move)) {
+                printf("search_benchmark: Invalid move (%s)\n", argv[arg_index]);
+                return 1;
+            }
+            board.make_move(move);
+        }
+        _run_benchmark<QubicBoard, QubicMove>(board);
+        return 0;
+    }
+
+    Grid grid;
+    for (int arg_index = 1; arg_index + 1 < argc; arg_index += 2) {
+        int8_t row = static_cast<int8_t>(std::atoi(argv[arg_index]));
+        int8_t col = static_cast<int8_t>(std::atoi(argv[arg_index + 1]));
+        if (row < 0 || row >= NUM_ROWS || col < 0 || col >= NUM_COLS || !grid.set_value(row, col)) {
+            printf("search_benchmark: Invalid move (%d, %d)\n", row, col);
+            return 1;
+        }
+    }
+    _run_benchmark<Grid, MovePosition>(grid);
+    return 0;
+}
@@ -0,0 +1,29 @@
+#-------------------------------------------------
+#
+# Nodes/sec and time-to-solve of LazySmpSearch by thread count, on Grid or Qubic
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+CONFIG += console thread c++17
+CONFIG -= app_bundle
+
+TARGET = search_benchmark
+TEMPLATE = app
+
+OBJECTS_DIR = .obj
+
+SOURCES += \
+        main.cpp \
+        ../../src/anytime_search.cpp \
+        ../../src/grid.cpp \
+        ../../src/lazy_smp_search.cpp \
+        ../../src/move_ordering.cpp \
+        ../../src/qubic_board.cpp \
+        ../../src/qubic_symmetry.cpp \
+        ../../src/task_scheduler.cpp \
+        ../../src/transposition_table.cpp \
+        ../../src/ultimate_board.cpp
+
+INCLUDEPATH = ../../include
@@ -0,0 +1,123 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "constants.h"
+#include "game_bot.h"
+#include "grid.h"
+#include "session_runtime.h"
+#include "task_scheduler.h"
+
+static void _print_usage(const char * program_name) {
+    printf("Usage: %s [--games <num_games>] [--sessions <concurrent sessions>] [--loops <event loops>] [--threads <num_threads>] [--policy <policy file>] [--log <log file>]\n", program_name);
+}
+
+// Simulated clients answer on the loop thread with a random free cell.
+static MovePosition _random_move(const Grid & grid) {
+    static thread_local uint32_t random_state = 2463534242u;
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    std::vector<MovePosition> positions = grid.valid_move_positions();
+    return positions.at(random_state % positions.size());
+}
+
+static PlayerRoles _player_roles(uint64_t game_index) {
+    // Clients and bot take turns at each side and at moving first.
+    Move first_player_move = game_index % 2 == 0 ? Move::CROSS : Move::NOUGHT;
+    Move bot_move = (game_index / 2) % 2 == 0 ? Move::CROSS : Move::NOUGHT;
+    return PlayerRoles{first_player_move, OPPONENT_MOVE(bot_move), bot_move, true};
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t num_games = 100000;
+    uint64_t num_sessions = 1000;
+    size_t num_loops = SESSION_DEFAULT_NUM_EVENT_LOOPS;
+    size_t num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::string policy_filename;
+    std::string log_filename = "sessions.log";
+
+    for (int arg_index = 1; arg_index < argc; ++arg_index) {
+        bool has_value = arg_index + 1 < argc;
+        if (strcmp(argv[arg_index], "--games") == 0 && has_value) {
+            num_games = strtoull(argv[++arg_index], nullptr, 10);
+        } else if (strcmp(argv[arg_index], "--sessions") == 0 && has_value && atoi(argv[arg_index + 1]) > 0) {
+            num_sessions = strtoull(argv[++arg_index], nullptr, 10);
+        } else if (strcmp(argv[arg_index], "--loops") == 0 && has_value && atoi(argv[arg_index + 1]) > 0) {
+            num_loops = static_cast<size_t>(atoi(argv[++arg_index]));
+        } else if (strcmp(argv[arg_index], "--threads") == 0 && has_value && atoi(argv[arg_index + 1]) > 0) {
+            num_threads = static_cast<size_t>(atoi(argv[++arg_index]));
+        } else if (strcmp(argv[arg_index], "--policy") == 0 && has_value) {
+            policy_filename = argv[++arg_index];
+        } else if (strcmp(argv[arg_index], "--log") == 0 && has_value) {
+            log_filename = argv[++arg_index];
+        } else {
+            _print_usage(argv[0]);
+            return 1;
+        }
+    }
+    num_sessions = std::min(num_sessions, num_games);
+
+    GameBot game_bot;
+    if (!policy_filename.empty() && !game_bot.load_policy(policy_filename)) {
+        return 1;
+    }
+
+    TaskScheduler scheduler(num_threads);
+    std::atomic<uint64_t> num_started(0);
+    uint64_t results[3] = {0, 0, 0};
+    {
+        SessionRuntime runtime(game_bot, log_filename, num_loops, scheduler);
+        if (!runtime.is_open()) {
+            return 1;
+        }
+
+        // Each finished session is replaced by a new one until num_games
+        // have been started, so num_sessions games are in play at any time.
+        std::atomic<uint64_t> num_bot_wins(0), num_client_wins(0), num_draws(0);
+        SessionCallbacks callbacks;
+        callbacks.move_requested = [&runtime](uint64_t session_id, const Grid & grid) {
+            runtime.submit_move(session_id, _random_move(grid));
+        };
+        callbacks.game_finished = [&](uint64_t session_id, GameState game_state) {
+            (void) session_id;
+            if (game_state == GameState::DRAW) {
+                num_draws.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                // Game indices and session ids both count from the start.
+                PlayerRoles player_roles = _player_roles(session_id - 1);
+                bool bot_wins = (game_state == GameState::CROSS_WINS) == (player_roles.bot_move == Move::CROSS);
+                (bot_wins ? num_bot_wins : num_client_wins).fetch_add(1, std::memory_order_relaxed);
+            }
+            uint64_t game_index = num_started.fetch_add(1, std::memory_order_relaxed);
+            if (game_index < num_games) {
+                runtime.open_session(_player_roles(game_index));
+            }
+        };
+        runtime.set_callbacks(callbacks);
+
+        printf("%lu games, %lu concurrent sessions, %lu event loops, %lu threads\n", num_games, num_sessions, num_loops, num_threads);
+        auto start_time = std::chrono::steady_clock::now();
+        num_started.store(num_sessions);
+        for (uint64_t game_index = 0; game_index < num_sessions; ++game_index) {
+            runtime.open_session(_player_roles(game_index));
+        }
+        runtime.wait_for_sessions();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+        results[0] = num_bot_wins.load();
+        results[1] = num_client_wins.load();
+        results[2] = num_draws.load();
+        printf("Bot wins %lu, client wins %lu, draws %lu\n", results[0], results[1], results[2]);
+        printf("Committed %lu games in %.3f s, %.0f games/sec\n", runtime.num_committed_games(), seconds, runtime.num_committed_games() / seconds);
+        printf("Coroutine frame %lu bytes, %lu bytes per open session\n", SessionFramePool::instance().max_frame_size(), SessionRuntime::session_size());
+    }
+    printf("Frames still allocated after shutdown: %lu\n", SessionFramePool::instance().num_allocated());
+    return 0;
+}
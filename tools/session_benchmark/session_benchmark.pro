@@ -0,0 +1,39 @@
+#-------------------------------------------------
+#
+# Games/sec and per-session memory of the coroutine SessionRuntime
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+# The session runtime is built on C++20 coroutines.
+CONFIG += console thread c++2a
+CONFIG -= app_bundle
+
+# shm_open() for the shared policy segment.
+unix: LIBS += -lrt
+
+TARGET = session_benchmark
+TEMPLATE = app
+
+OBJECTS_DIR = .obj
+
+SOURCES += \
+        main.cpp \
+        ../../src/anytime_search.cpp \
+        ../../src/game_bot.cpp \
+        ../../src/grid.cpp \
+        ../../src/grid_symmetry.cpp \
+        ../../src/match_box.cpp \
+        ../../src/match_box_history.cpp \
+        ../../src/move_ordering.cpp \
+        ../../src/ntuple_network.cpp \
+        ../../src/policy_snapshot.cpp \
+        ../../src/seed_delta_buffer.cpp \
+        ../../src/shared_policy_segment.cpp \
+        ../../src/session_runtime.cpp \
+        ../../src/tablebase.cpp \
+        ../../src/task_scheduler.cpp \
+        ../../src/ultimate_board.cpp
+
+INCLUDEPATH = ../../include
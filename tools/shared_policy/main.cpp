@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "game_bot.h"
+#include "shared_policy_segment.h"
+#include "task_scheduler.h"
+
+#define DEFAULT_CHECKPOINT_FILENAME "shared_policy.txt"
+#define DEFAULT_CHECKPOINT_INTERVAL_SECONDS (10)
+
+static volatile std::sig_atomic_t _stop_requested = 0;
+
+static void _request_stop(int signal_number) {
+    (void) signal_number;
+    _stop_requested = 1;
+}
+
+static void _print_usage(const char * program_name) {
+    printf("Usage: %s --coordinate [--policy <initial policy file>] [--checkpoint <policy file>] [--interval <seconds>] [--segment <name>]\n", program_name);
+    printf("       %s --train <num_games> [--threads <num_threads>] [--segment <name>]\n", program_name);
+    printf("       %s --remove [--segment <name>]\n", program_name);
+}
+
+// Writes the segment as a regular policy file. The file is replaced by a
+// rename so that a crash never leaves a half written checkpoint behind.
+static bool _checkpoint(SharedPolicySegment & segment, const std::string & filename) {
+    uint64_t version = segment.version();
+    GameBot game_bot;
+    game_bot.load_shared_policy(segment);
+    std::string temporary_filename = filename + ".tmp";
+    if (!game_bot.save_policy(temporary_filename)) {
+        return false;
+    }
+    if (rename(temporary_filename.c_str(), filename.c_str()) != 0) {
+        printf("Cannot replace %s\n", filename.c_str());
+        return false;
+    }
+    segment.set_checkpoint_version(version);
+    printf("Checkpoint %s at version %lu, %lu games\n", filename.c_str(), version, segment.num_games());
+    return true;
+}
+
+static int _coordinate(const std::string & segment_name, const std::string & policy_filename, const std::string & checkpoint_filename, int interval_seconds) {
+    SharedPolicySegment segment;
+    if (segment.create(segment_name)) {
+        GameBot game_bot;
+        if (!policy_filename.empty() && !game_bot.load_policy(policy_filename)) {
+            segment.close();
+            SharedPolicySegment::remove(segment_name);
+            return 1;
+        }
+        game_bot.store_shared_policy(segment);
+        segment.mark_ready();
+        printf("Created %s\n", segment_name.c_str());
+    } else if (segment.open(segment_name)) {
+        // A coordinator that went away left the segment and its trainers
+        // behind; carry on from there.
+        printf("Adopted %s at version %lu, %lu games\n", segment_name.c_str(), segment.version(), segment.num_games());
+    } else {
+        printf("Use --remove to discard a broken segment.\n");
+        return 1;
+    }
+
+    std::signal(SIGINT, _request_stop);
+    std::signal(SIGTERM, _request_stop);
+    auto last_checkpoint_time = std::chrono::steady_clock::now();
+    while (!_stop_requested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (std::chrono::steady_clock::now() - last_checkpoint_time < std::chrono::seconds(interval_seconds)) {
+            continue;
+        }
+        last_checkpoint_time = std::chrono::steady_clock::now();
+        if (segment.version() != segment.checkpoint_version()) {
+            _checkpoint(segment, checkpoint_filename);
+        }
+    }
+
+    bool saved = _checkpoint(segment, checkpoint_filename);
+    segment.close();
+    bool removed = SharedPolicySegment::remove(segment_name);
+    return saved && removed ? 0 : 1;
+}
+
+static int _train(const std::string & segment_name, size_t num_games, TaskScheduler & scheduler) {
+    SharedPolicySegment segment;
+    if (!segment.open(segment_name)) {
+        return 1;
+    }
+    GameBot game_bot;
+    game_bot.attach_shared_policy(&segment);
+    auto start_time = std::chrono::steady_clock::now();
+    game_bot.train_self_play(num_games, scheduler);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    game_bot.attach_shared_policy(nullptr);
+    printf("Trained %lu games in %.3f s, %.0f games/sec; segment at version %lu, %lu games\n",
+        num_games, seconds, num_games / seconds, segment.version(), segment.num_games());
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    enum class Mode { NONE, COORDINATE, TRAIN, REMOVE };
+    Mode mode = Mode::NONE;
+    std::string segment_name = SHARED_POLICY_DEFAULT_NAME;
+    std::string policy_filename;
+    std::string checkpoint_filename = DEFAULT_CHECKPOINT_FILENAME;
+    int interval_seconds = DEFAULT_CHECKPOINT_INTERVAL_SECONDS;
+    size_t num_games = 0;
+    size_t num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    for (int arg_index = 1; arg_index < argc; ++arg_index) {
+        bool has_value = arg_index + 1 < argc;
+        if (strcmp(argv[arg_index], "--coordinate") == 0) {
+            mode = Mode::COORDINATE;
+        } else if (strcmp(argv[arg_index], "--train") == 0 && has_value) {
+            mode = Mode::TRAIN;
+            num_games = strtoull(argv[++arg_index], nullptr, 10);
+        } else if (strcmp(argv[arg_index], "--remove") == 0) {
+            mode = Mode::REMOVE;
+        } else if (strcmp(argv[arg_index], "--segment") == 0 && has_value) {
+            segment_name = argv[++arg_index];
+        } else if (strcmp(argv[arg_index], "--policy") == 0 && has_value) {
+            policy_filename = argv[++arg_index];
+        } else if (strcmp(argv[arg_index], "--checkpoint") == 0 && has_value) {
+            checkpoint_filename = argv[++arg_index];
+        } else if (strcmp(argv[arg_index], "--interval") == 0 && has_value && atoi(argv[arg_index + 1]) > 0) {
+            interval_seconds = atoi(argv[++arg_index]);
+        } else if (strcmp(argv[arg_index], "--threads") == 0 && has_value && atoi(argv[arg_index + 1]) > 0) {
+            num_threads = static_cast<size_t>(atoi(argv[++arg_index]));
+        } else {
+            _print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    switch (mode) {
+    case Mode::COORDINATE:
+        return _coordinate(segment_name, policy_filename, checkpoint_filename, interval_seconds);
+    case Mode::TRAIN: {
+        TaskScheduler scheduler(num_threads);
+        return _train(segment_name, num_games, scheduler);
+    }
+    case Mode::REMOVE:
+        return SharedPolicySegment::remove(segment_name) ? 0 : 1;
+    default:
+        _print_usage(argv[0]);
+        return 1;
+    }
+}
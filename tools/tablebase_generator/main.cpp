@@ -0,0 +1,58 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "constants.h"
+#include "grid.h"
+#include "tablebase.h"
+#include "task_scheduler.h"
+
+static void _print_usage(const char * program_name) {
+    printf("Usage: %s <output file> [num_threads] [--no-distances]\n", program_name);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        _print_usage(argv[0]);
+        return 1;
+    }
+
+    std::string filename = argv[1];
+    size_t num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    bool save_distances = true;
+    for (int arg_index = 2; arg_index < argc; ++arg_index) {
+        if (strcmp(argv[arg_index], "--no-distances") == 0) {
+            save_distances = false;
+        } else if (atoi(argv[arg_index]) > 0) {
+            num_threads = static_cast<size_t>(atoi(argv[arg_index]));
+        } else {
+            _print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    printf("Generating %dx%d tablebase with %lu threads\n", NUM_ROWS, NUM_COLS, num_threads);
+    auto start = std::chrono::steady_clock::now();
+    TaskScheduler scheduler(num_threads);
+    Tablebase tablebase;
+    tablebase.generate(scheduler);
+    auto end = std::chrono::steady_clock::now();
+    printf("Generated %lu positions in %.3f s\n", tablebase.num_positions(), std::chrono::duration<double>(end - start).count());
+
+    Grid start_grid;
+    TablebaseResult result = TablebaseResult::UNKNOWN;
+    uint8_t distance = 0;
+    tablebase.probe(start_grid, result, distance);
+    printf("Empty board: %s for %s, %d moves to the end\n", STR_TABLEBASE_RESULT(result), STR_MOVE(start_grid.first_player()), distance);
+
+    if (!tablebase.save(filename, save_distances)) {
+        return 1;
+    }
+    printf("Saved %s\n", filename.c_str());
+    scheduler.print_worker_statistics();
+    return 0;
+}
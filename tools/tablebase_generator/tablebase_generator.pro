@@ -0,0 +1,24 @@
+#-------------------------------------------------
+#
+# Retrograde win/draw/loss tablebase generator
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+CONFIG += console thread c++17
+CONFIG -= app_bundle
+
+TARGET = tablebase_generator
+TEMPLATE = app
+
+OBJECTS_DIR = .obj
+
+SOURCES += \
+        main.cpp \
+        ../../src/grid.cpp \
+        ../../src/grid_symmetry.cpp \
+        ../../src/tablebase.cpp \
+        ../../src/task_scheduler.cpp
+
+INCLUDEPATH = ../../include
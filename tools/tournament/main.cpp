@@ -0,0 +1,82 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game_bot.h"
+#include "task_scheduler.h"
+#include "tournament.h"
+
+// Stands for a bot with untrained match boxes instead of a policy file.
+#define UNTRAINED_POLICY "untrained"
+
+static void _print_usage(const char * program_name) {
+    printf("Usage: %s [--games <games per pair>] [--seed <seed>] [--threads <num_threads>] <policy file | %s>...\n", program_name, UNTRAINED_POLICY);
+    printf("       %s --train <num_games> <output policy file> [--threads <num_threads>]\n", program_name);
+}
+
+static int _train(size_t num_games, const std::string & filename, TaskScheduler & scheduler) {
+    GameBot game_bot;
+    game_bot.train_self_play(num_games, scheduler);
+    if (!game_bot.save_policy(filename)) {
+        return 1;
+    }
+    printf("Saved %s\n", filename.c_str());
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t games_per_pair = 1000;
+    uint64_t seed = 1;
+    size_t num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    size_t num_training_games = 0;
+    std::string training_filename;
+    std::vector<std::string> policy_filenames;
+
+    for (int arg_index = 1; arg_index < argc; ++arg_index) {
+        bool has_value = arg_index + 1 < argc;
+        if (strcmp(argv[arg_index], "--games") == 0 && has_value) {
+            games_per_pair = static_cast<size_t>(strtoull(argv[++arg_index], nullptr, 10));
+        } else if (strcmp(argv[arg_index], "--seed") == 0 && has_value) {
+            seed = strtoull(argv[++arg_index], nullptr, 10);
+        } else if (strcmp(argv[arg_index], "--threads") == 0 && has_value && atoi(argv[arg_index + 1]) > 0) {
+            num_threads = static_cast<size_t>(atoi(argv[++arg_index]));
+        } else if (strcmp(argv[arg_index], "--train") == 0 && arg_index + 2 < argc) {
+            num_training_games = static_cast<size_t>(strtoull(argv[++arg_index], nullptr, 10));
+            training_filename = argv[++arg_index];
+        } else if (argv[arg_index][0] != '-') {
+            policy_filenames.push_back(argv[arg_index]);
+        } else {
+            _print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    TaskScheduler scheduler(num_threads);
+    if (!training_filename.empty()) {
+        return _train(num_training_games, training_filename, scheduler);
+    }
+    if (policy_filenames.size() < 2) {
+        _print_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<GameBot>> game_bots;
+    Tournament tournament(seed);
+    for (const std::string & filename : policy_filenames) {
+        game_bots.emplace_back(new GameBot());
+        if (filename != UNTRAINED_POLICY && !game_bots.back()->load_policy(filename)) {
+            return 1;
+        }
+        tournament.add_player(filename, game_bots.back().get());
+    }
+
+    printf("Round robin of %lu players, %lu games per pair, seed %lu, %lu threads\n", tournament.num_players(), games_per_pair, seed, num_threads);
+    TournamentResult result = tournament.run(games_per_pair, scheduler);
+    Tournament::print_result(result);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "anytime_search.h"
+#include "constants.h"
+#include "ultimate_board.h"
+
+#define DEFAULT_PERFT_DEPTH (7)
+#define DEFAULT_SEARCH_MILLISECONDS (1000)
+
+static void _print_usage(const char * program_name) {
+    printf("Usage: %s [--depth <max depth>] [--search <milliseconds>]\n", program_name);
+}
+
+// Counts the leaves of the ultimate tic-tac-toe move tree from the empty
+// board at every depth up to --depth, then runs AnytimeSearch on the empty
+// board for --search milliseconds. Both report positions/sec.
+int main(int argc, char *argv[])
+{
+    size_t max_depth = DEFAULT_PERFT_DEPTH;
+    long search_milliseconds = DEFAULT_SEARCH_MILLISECONDS;
+    for (int arg_index = 1; arg_index < argc; ++arg_index) {
+        bool has_value = arg_index + 1 < argc;
+        if (strcmp(argv[arg_index], "--depth") == 0 && has_value) {
+            max_depth = static_cast<size_t>(atoi(argv[++arg_index]));
+        } else if (strcmp(argv[arg_index], "--search") == 0 && has_value) {
+            search_milliseconds = atol(argv[++arg_index]);
+        } else {
+            _print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    UltimateBoard board;
+    printf("%6s %16s %12s %16s\n", "depth", "positions", "seconds", "positions/sec");
+    for (size_t depth = 1; depth <= max_depth; ++depth) {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t num_positions = board.perft(depth);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("%6lu %16lu %12.3f %16.0f\n", depth, num_positions, seconds, seconds > 0.0 ? num_positions / seconds : 0.0);
+        fflush(stdout);
+    }
+
+    if (search_milliseconds > 0) {
+        AnytimeSearch search;
+        UltimateMove best_move = ULTIMATE_NO_MOVE;
+        auto start = std::chrono::steady_clock::now();
+        search.search(board, std::chrono::milliseconds(search_milliseconds), best_move);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        SearchStatistics statistics = search.get_statistics();
+        printf("search: %lu nodes, depth %lu, %.0f nodes/sec, best move sub-board %d cell %d\n",
+               statistics.nodes_searched, statistics.depth_reached, statistics.nodes_searched / seconds,
+               best_move.sub_board, best_move.cell);
+    }
+    return 0;
+}
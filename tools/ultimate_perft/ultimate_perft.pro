@@ -0,0 +1,24 @@
+#-------------------------------------------------
+#
+# Perft and AnytimeSearch positions/sec on the ultimate tic-tac-toe board
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+TARGET = ultimate_perft
+TEMPLATE = app
+
+OBJECTS_DIR = .obj
+
+SOURCES += \
+        main.cpp \
+        ../../src/anytime_search.cpp \
+        ../../src/grid.cpp \
+        ../../src/move_ordering.cpp \
+        ../../src/ultimate_board.cpp
+
+INCLUDEPATH = ../../include